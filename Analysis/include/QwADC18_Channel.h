@@ -64,14 +64,38 @@ class QwADC18_Channel: public VQwHardwareChannel, public MQwMockable {
   QwADC18_Channel(const QwADC18_Channel& value):
     VQwHardwareChannel(value), MQwMockable(value),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
-    fSaturationABSLimit(value.fSaturationABSLimit)
+    fErrorCount_HWSat(0),
+    fErrorCount_sample(0),
+    fErrorCount_SW_HW(0),
+    fErrorCount_Sequence(0),
+    fErrorCount_SameHW(0),
+    fErrorCount_ZeroHW(0),
+    fNumEvtsWithEventCutsRejected(0),
+    fSaturationABSLimit(value.fSaturationABSLimit),
+    bHw_sum(value.bHw_sum), bHw_sum_raw(value.bHw_sum_raw),
+    bBlock(value.bBlock), bBlock_raw(value.bBlock_raw),
+    bNum_samples(value.bNum_samples),
+    bDevice_Error_Code(value.bDevice_Error_Code),
+    bSequence_number(value.bSequence_number)
   {
     *this = value;
   };
   QwADC18_Channel(const QwADC18_Channel& value, VQwDataElement::EDataToSave datatosave):
     VQwHardwareChannel(value,datatosave), MQwMockable(value),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
-    fSaturationABSLimit(value.fSaturationABSLimit)
+    fErrorCount_HWSat(0),
+    fErrorCount_sample(0),
+    fErrorCount_SW_HW(0),
+    fErrorCount_Sequence(0),
+    fErrorCount_SameHW(0),
+    fErrorCount_ZeroHW(0),
+    fNumEvtsWithEventCutsRejected(0),
+    fSaturationABSLimit(value.fSaturationABSLimit),
+    bHw_sum(value.bHw_sum), bHw_sum_raw(value.bHw_sum_raw),
+    bBlock(value.bBlock), bBlock_raw(value.bBlock_raw),
+    bNum_samples(value.bNum_samples),
+    bDevice_Error_Code(value.bDevice_Error_Code),
+    bSequence_number(value.bSequence_number)
   {
     *this = value;
   };
@@ -121,6 +145,8 @@ class QwADC18_Channel: public VQwHardwareChannel, public MQwMockable {
   QwADC18_Channel& operator=  (const QwADC18_Channel &value);
   void AssignScaledValue(const QwADC18_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
   void AddValueFrom(const VQwHardwareChannel* valueptr);
   void SubtractValueFrom(const VQwHardwareChannel* valueptr);
   void MultiplyBy(const VQwHardwareChannel* valueptr);
@@ -195,6 +221,8 @@ class QwADC18_Channel: public VQwHardwareChannel, public MQwMockable {
 
   // Update the error counters based on the internal fErrorFlag
   void IncrementErrorCounters();
+  // Add the error counters of another copy of this channel
+  void MergeErrorCounters(const QwADC18_Channel& source);
 
   /*End*/
 
@@ -21,6 +21,9 @@
 #include "QwParameterFile.h"
 
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class QwOptions;
 class QwEPICSEvent;
@@ -54,6 +57,8 @@ class QwEventBuffer: public MQwCodaControlEvent{
  public:
   QwEventBuffer();
   virtual ~QwEventBuffer() {
+    // Stop the read-ahead thread before the stream goes away
+    StopPrefetch();
     // Delete event stream
     if (fEvStream != NULL) {
       delete fEvStream;
@@ -88,6 +93,14 @@ class QwEventBuffer: public MQwCodaControlEvent{
   std::pair<UInt_t, UInt_t> GetEventRange() const {
     return fEventRange;
   };
+  /// \brief Return the requested range of run segments
+  std::pair<Int_t, Int_t> GetSegmentRange() const {
+    return fSegmentRange;
+  };
+  /// \brief Restrict the event range, e.g. to a part of the run
+  void SetEventRange(UInt_t first, UInt_t last) {
+    fEventRange = std::make_pair(first, last);
+  };
 
   /// \brief Opens the event stream (file or ET) based on the internal flags
   Int_t OpenNextStream();
@@ -102,6 +115,13 @@ class QwEventBuffer: public MQwCodaControlEvent{
 
   Int_t ReOpenStream();
 
+  /// \brief Keep a copy of the events read from now on, so that they can
+  ///        be replayed instead of reopening the stream
+  void StartRecording();
+  /// \brief Read the recorded events again before continuing with the
+  ///        stream; returns false if not all of them could be kept
+  Bool_t ReplayRecording();
+
   Int_t OpenDataFile(UInt_t current_run, Short_t seg);
   Int_t OpenDataFile(UInt_t current_run, const TString rw = "R");
   Int_t OpenDataFile(const TString filename, const TString rw = "R");
@@ -203,6 +223,9 @@ class QwEventBuffer: public MQwCodaControlEvent{
 
   Int_t WriteFileEvent(int* buffer);
 
+  /// \brief Returns the raw buffer of the current event
+  UInt_t* GetEvBuffer();
+
   Bool_t DataFileIsSegmented();
 
   Int_t CloseThisSegment();
@@ -222,6 +245,56 @@ class QwEventBuffer: public MQwCodaControlEvent{
  protected:
   enum CodaStreamMode{fEvStreamNull, fEvStreamFile, fEvStreamET} fEvStreamMode;
   THaCodaData *fEvStream; //  Pointer to a THaCodaFile or THaEtClient
+  Bool_t fMemoryMapFiles; ///< Read data files through a memory mapping
+
+ protected:
+  ///  Read-ahead of raw events from data files on a background thread.
+  ///  The reader thread only calls codaRead() and copies the events into
+  ///  a bounded ring of slots; segment chaining, event ranges and exit
+  ///  requests are all handled on the main thread as before.  Events
+  ///  which codaRead() left in the memory mapping of the file are not
+  ///  copied; the slot points to them instead.
+  struct PrefetchSlot_t {
+    std::vector<UInt_t> fBuffer;  ///< Copy of the raw event, if not mapped
+    UInt_t* fEvent;               ///< Raw event, in the mapping or in fBuffer
+    Int_t fStatus;                ///< Status returned by codaRead()
+  };
+  Int_t fPrefetchDepth;           ///< Number of events to read ahead (0 disables)
+  std::vector<PrefetchSlot_t> fPrefetchSlots;
+  size_t fPrefetchHead;           ///< Next slot to be filled by the reader
+  size_t fPrefetchTail;           ///< Next slot to be handed to the analysis
+  size_t fPrefetchFilled;         ///< Slots filled but not yet handed out
+  Bool_t fPrefetchHolding;        ///< A slot is in use as the current event
+  Bool_t fPrefetchStop;           ///< Request for the reader thread to finish
+  Bool_t fPrefetchDone;           ///< Reader thread has queued EOF or an error
+  Bool_t fPrefetchActive;         ///< Reader thread owns the stream
+  UInt_t* fPrefetchEvent;         ///< Current event when prefetching
+  std::thread fPrefetchThread;
+  std::mutex fPrefetchMutex;
+  std::condition_variable fPrefetchNotFull;
+  std::condition_variable fPrefetchNotEmpty;
+
+  void  StartPrefetch();
+  void  StopPrefetch();
+  void  PrefetchLoop();
+  Int_t GetPrefetchedEvent();
+
+ protected:
+  ///  Recording of the raw events read at the start of a stream (e.g. to
+  ///  find the first EPICS event), which are then replayed from memory
+  ///  so that the data file is read only once.
+  ULong64_t fRecordLimit;         ///< Maximum words recorded (0 disables)
+  ULong64_t fRecordedWords;       ///< Words recorded so far
+  Bool_t fRecording;              ///< Are events being recorded?
+  Bool_t fRecordComplete;         ///< Have all events read been recorded?
+  Bool_t fReplaying;              ///< Are the recorded events handed out?
+  Int_t fRecordEndStatus;         ///< Status which ended the recording (CODA_OK if the stream can be read on)
+  std::vector<std::vector<UInt_t> > fRecordedEvents;
+  size_t fReplayNext;             ///< Next recorded event to be replayed
+  UInt_t* fReplayEvent;           ///< Current event when replaying
+
+  /// \brief Discard the recorded events
+  void  ClearRecording();
 
   Int_t fCurrentRun;
 
@@ -289,7 +362,7 @@ template < class T > Bool_t QwEventBuffer::FillObjectWithEventData(T &object){
   ///       const UInt_t banktype, UInt_t* buffer, UInt_t num_words);
   ///
   Bool_t okay = kFALSE;
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
+  UInt_t *localbuff = GetEvBuffer();
 
   if (fFragLength==1 && localbuff[fWordsSoFar]==kNullDataWord){
     fWordsSoFar += fFragLength;
@@ -0,0 +1,70 @@
+/**
+ *  \file   QwExternalValue.h
+ *  \brief  Handle to a value published by another subsystem
+ */
+
+#ifndef QWEXTERNALVALUE_H_
+#define QWEXTERNALVALUE_H_
+
+// ROOT headers
+#include "TString.h"
+
+// Qweak headers
+#include "QwLog.h"
+
+/**
+ *  \class QwExternalValue
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Handle to a value published by another subsystem
+ *
+ *  RequestExternalValue looks up the published name and copies the value
+ *  on every call.  A handle looks up the name once, in Resolve(), which the
+ *  owner calls after the values have been published (for subsystems in
+ *  ResolveExternalValues, which the subsystem array calls after loading or
+ *  copying its subsystems).  The handle then keeps a pointer to the
+ *  published channel, which stays valid as long as the subsystem array that
+ *  owns it, and the event loop only tests the pointer with IsValid().
+ *
+ *  A failed lookup is reported by Resolve() and leaves the handle unbound,
+ *  so that a later Resolve() can still find the value.  Copies of a handle
+ *  are unbound, since a copy of the owner usually belongs to a different
+ *  array.
+ */
+template <class T>
+class QwExternalValue {
+
+  public:
+
+    /// Default constructor
+    QwExternalValue(): fValue(0) { };
+    /// Copy constructor, which does not copy the binding
+    QwExternalValue(const QwExternalValue&): fValue(0) { };
+    /// Assignment operator, which keeps the binding of this handle
+    QwExternalValue& operator=(const QwExternalValue&) { return *this; };
+
+    /// \brief Look up the published value and report when it is not found
+    template <class Source>
+    Bool_t Resolve(const Source& source, const TString& name) {
+      fValue = dynamic_cast<const T*>(source.RequestExternalPointer(name));
+      if (fValue == 0)
+        QwError << "Could not resolve external value " << name << QwLog::endl;
+      return (fValue != 0);
+    };
+    /// \brief Forget the binding
+    void Reset() { fValue = 0; };
+
+    /// Was the value found?
+    Bool_t IsValid() const { return (fValue != 0); };
+    /// Pointer to the published value
+    const T* Get() const { return fValue; };
+    const T* operator->() const { return fValue; };
+    const T& operator*() const { return *fValue; };
+
+  private:
+
+    const T* fValue;  ///< Published value, or null
+
+}; // class QwExternalValue
+
+#endif // QWEXTERNALVALUE_H_
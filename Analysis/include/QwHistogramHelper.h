@@ -57,6 +57,12 @@ class QwHistogramHelper{
   Bool_t MatchVQWKElementFromList(const std::string& subsystemname,
       const std::string& moduletype,
       const std::string& devicename);
+  /// Leaf type (I, i, F or D) of an element of a channel in the trees, from
+  /// the tree trim file or the default of the element; independent of
+  /// whether the trees are trimmed
+  Char_t GetElementLeafType(const std::string& subsystemname,
+      const std::string& moduletype,
+      const std::string& elementname);
   
  protected:
 
@@ -153,6 +159,7 @@ class QwHistogramHelper{
   std::vector<TString> fSubsystemList;//stores the list of subsystems
   std::vector<std::vector<TString> > fModuleList;//will store list modules in  each subsystem (ex. for BCM, BPM etc in Beam line sub system)
   std::vector<std::vector<std::vector<TString> > > fVQWKTrimmedList; //will store list of VQWK elements for each subsystem for each module  
+  std::vector<std::vector<std::vector<Char_t> > > fVQWKLeafTypes; //will store the leaf type of each VQWK element in fVQWKTrimmedList (0 if not typed)
 };
 
 //  Declare a global copy of the histogram helper.
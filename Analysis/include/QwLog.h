@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <string>
 #include <vector>
+#include <mutex>
 using std::string;
 
 // Qweak headers
@@ -74,6 +75,10 @@ class QwOptions;
 \verbatim
  QwMessage << "Hello World !!!" << QwLog::endl;
 \endverbatim
+ *
+ * Each thread collects its messages in its own line buffers, which are
+ * written to the screen and the log file at QwLog::endl (or QwLog::flush),
+ * so that the lines of messages from different threads do not interleave.
  */
 class QwLog : public std::ostream {
 
@@ -139,11 +144,12 @@ class QwLog : public std::ostream {
     /*! \brief Stream an object to the output stream
      */
     template <class T> QwLog&   operator<<(const T &t) {
+      if (fLogLevel > fScreenThreshold && fLogLevel > fFileThreshold) return *this;
       if (fScreen && fLogLevel <= fScreenThreshold) {
-        *(fScreen) << t;
+        ScreenBuffer() << t;
       }
       if (fFile && fLogLevel <= fFileThreshold) {
-        *(fFile) << t;
+        FileBuffer() << t;
       }
       return *this;
     }
@@ -170,6 +176,13 @@ class QwLog : public std::ostream {
     const char*                 GetTime();
     char                        fTimeString[128];
 
+    //! Line buffer of this thread, written to a stream when it is flushed
+    class LineBuffer;
+    /*! \brief Line buffers of this thread for the screen and the file
+     */
+    static std::ostream&        ScreenBuffer();
+    static std::ostream&        FileBuffer();
+
     //! Screen thresholds and stream
     QwLogLevel    fScreenThreshold;
     std::ostream *fScreen;
@@ -177,7 +190,10 @@ class QwLog : public std::ostream {
     QwLogLevel    fFileThreshold;
     std::ostream *fFile;
     //! Log level of this stream
-    QwLogLevel fLogLevel;
+    /// Log level of the current message, separately for each thread
+    static thread_local QwLogLevel fLogLevel;
+    /// Serializes the lines written by the threads of the event loop
+    static std::recursive_mutex fMutex;
 
     //! Flag to print function signature on warning or error
     bool fPrintFunctionSignature;
@@ -190,9 +206,9 @@ class QwLog : public std::ostream {
     bool fUseColor;
 
     //! Flags only relevant for current line, but static for use in static function
-    static bool fFileAtNewLine;
-    static bool fScreenInColor;
-    static bool fScreenAtNewLine;
+    static thread_local bool fFileAtNewLine;
+    static thread_local bool fScreenInColor;
+    static thread_local bool fScreenAtNewLine;
 
 };
 
@@ -69,6 +69,9 @@ class QwOmnivore: public VQwSubsystem_t {
       return 0; // my plate is empty
     };
 
+    /// Eat every bank, not just registered ones
+    Bool_t ReceivesAllBanks() const { return kTRUE; };
+
     /// Process the event buffer
     Int_t ProcessEvBuffer(const UInt_t event_type, const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words) {
       /// TODO:  Subsystems should be changing their ProcessEvBuffer routines to take the event_type as the first
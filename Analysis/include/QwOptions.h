@@ -266,6 +266,9 @@ class QwOptions {
     int GetArgc()    { return (int) fArgc; };
     /// \brief Get the vector of command line arguments
     char** GetArgv() { return (char**) fArgv; };
+    /// \brief Split the command line arguments into options, each with the
+    ///        tokens it was given with
+    std::vector<po::option> GetCommandLineOptions();
 
     /// \brief Clear the parsed variables
     void Clear() {
@@ -0,0 +1,137 @@
+/**
+ *  \file   QwProfiler.h
+ *  \brief  Cumulative timing of the stages of the event loop
+ */
+
+#ifndef QWPROFILER_H_
+#define QWPROFILER_H_
+
+// System headers
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+// ROOT headers
+#include "Rtypes.h"
+
+// Forward declarations
+class QwOptions;
+class QwSubsystemArray;
+class TDirectory;
+
+/**
+ *  \class QwProfiler
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Cumulative timing of the stages of the event loop
+ *
+ *  Each stage of the event loop (reading, decoding, processing, event
+ *  cuts, event ring, helicity patterns, data handlers, histograms and
+ *  trees) adds its wall time to the global profiler gQwProfiler with a
+ *  Scope object at the place where the stage is implemented.  The times
+ *  are kept in atomic counters, since stages run on the threads of the
+ *  event pipeline and the subsystem task pool; stages on different
+ *  threads overlap, so their sum can exceed the real time of the run.
+ *
+ *  At the end of a run, the decode and process times of each subsystem,
+ *  the copies into the event ring and the bytes written to each tree are
+ *  collected as well.  Print() reports everything next to the run times
+ *  of the event buffer, and Write() stores it as histograms in the
+ *  current ROOT directory when --write-profile is set.
+ */
+class QwProfiler {
+
+  public:
+
+    /// Stages of the event loop
+    enum EQwStage {
+      kRead = 0, kDecode, kProcess, kEventCuts, kRing, kPattern,
+      kDataHandlers, kHistograms, kTrees,
+      kNumberOfStages
+    };
+    /// Names of the stages
+    static const char* const fStageName[kNumberOfStages];
+
+    /// Adds its lifetime to a stage
+    class Scope {
+      public:
+        Scope(EQwStage stage): fStage(stage), fStart(Now()) { };
+        ~Scope();
+      private:
+        EQwStage fStage;
+        ULong64_t fStart;
+    };
+
+  public:
+
+    /// \brief Default constructor
+    QwProfiler();
+    /// \brief Virtual destructor
+    virtual ~QwProfiler() { };
+
+    /// \brief Define options
+    static void DefineOptions(QwOptions &options);
+    /// \brief Process options
+    void ProcessOptions(QwOptions &options);
+
+    /// \brief Monotonic clock in nanoseconds
+    static ULong64_t Now();
+
+    /// \brief Add the time since start to a stage
+    void AddTime(EQwStage stage, ULong64_t start) {
+      fTime[stage] += Now() - start;
+      fCalls[stage]++;
+    };
+    /// \brief Count a copy of an event into the event ring
+    void AddRingCopy(ULong64_t bytes) {
+      fRingCopies++;
+      fRingBytes += bytes;
+    };
+    /// \brief Add the bytes filled into a tree and written after compression
+    void AddTreeBytes(const std::string& name, Long64_t bytes, Long64_t zipbytes);
+    /// \brief Collect the decode and process times of the subsystems
+    void CollectSubsystemTimes(const QwSubsystemArray& subsystems);
+
+    /// \brief Clear all counters at the start of a run
+    void Reset();
+    /// \brief Print the report
+    void Print() const;
+    /// \brief Write the report to the current directory, if requested
+    void Write() const;
+    /// Should the report be written to the ROOT file?
+    Bool_t IsWriteEnabled() const { return fWriteProfile; };
+
+  private:
+
+    /// Cumulative time and number of calls of each stage
+    std::atomic<ULong64_t> fTime[kNumberOfStages];
+    std::atomic<ULong64_t> fCalls[kNumberOfStages];
+    /// Copies into the event ring and their size (for compact copies)
+    std::atomic<ULong64_t> fRingCopies;
+    std::atomic<ULong64_t> fRingBytes;
+
+    /// Decode and process time of each subsystem
+    struct SubsystemTime_t {
+      ULong64_t fDecode;
+      ULong64_t fProcess;
+    };
+    std::map<std::string, SubsystemTime_t> fSubsystemTimes;
+    /// Bytes filled into each tree, and written after compression
+    std::map<std::string, std::pair<Long64_t, Long64_t> > fTreeBytes;
+    /// Protects the maps
+    mutable std::mutex fMutex;
+
+    /// Start of the run
+    ULong64_t fStart;
+    /// Write the report to the ROOT file
+    Bool_t fWriteProfile;
+
+}; // class QwProfiler
+
+/// Global profiler of the event loop
+extern QwProfiler gQwProfiler;
+
+inline QwProfiler::Scope::~Scope() { gQwProfiler.AddTime(fStage, fStart); }
+
+#endif // QWPROFILER_H_
@@ -3,20 +3,29 @@
 
 // System headers
 #include <typeindex>
+#include <deque>
+#include <cstring>
+#include <limits>
 #include <unistd.h>
 using std::type_info;
 
 // ROOT headers
 #include "TFile.h"
 #include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
 #include "TPRegexp.h"
 #include "TSystem.h"
 
 // Qweak headers
 #include "QwOptions.h"
+#include "QwProfiler.h"
+#include "QwRootTreeWriter.h"
 #include "TMapFile.h"
 
 
+class QwRootNTuple;
+
 // If one defines more than this number of words in the full ntuple,
 // the results are going to get very very crazy.
 #define BRANCH_VECTOR_MAX_SIZE 13000
@@ -32,6 +41,12 @@ using std::type_info;
  * tree that contains the branches.  One ROOT tree can have multiple QwRootTree
  * objects, for example in tracking mode both parity and tracking detectors
  * can be stored in the same tree.
+ *
+ * Branches into the vector may declare other leaf types than Double_t in
+ * their leaf list (e.g. "hw_sum/F:Device_Error_Code/i:block0_raw/I"), as
+ * set by the tree trim file.  These branches are moved to a buffer with the
+ * declared layout, and the values of the vector are converted into it each
+ * time the tree is filled.
  */
 class QwRootTree {
 
@@ -40,7 +55,8 @@ class QwRootTree {
     /// Constructor with name, and description
     QwRootTree(const std::string& name, const std::string& desc, const std::string& prefix = "")
     : fName(name),fDesc(desc),fPrefix(prefix),fType("type undefined"),
-      fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
+      fTypeInfo(&typeid(void)),fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0),
+      fFilledBytes(0),fAsync(kFALSE),fWriterTarget(-1),fNTuple(0),fBasketSize(0),fCompressionSettings(-1) {
       // Construct tree
       ConstructNewTree();
     }
@@ -48,7 +64,8 @@ class QwRootTree {
     /// Constructor with existing tree
     QwRootTree(const QwRootTree* tree, const std::string& prefix = "")
     : fName(tree->GetName()),fDesc(tree->GetDesc()),fPrefix(prefix),fType("type undefined"),
-      fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
+      fTypeInfo(&typeid(void)),fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0),
+      fFilledBytes(0),fAsync(kFALSE),fWriterTarget(-1),fNTuple(0),fBasketSize(0),fCompressionSettings(-1) {
       QwMessage << "Existing tree: " << tree->GetName() << ", " << tree->GetDesc() << QwLog::endl;
       fTree = tree->fTree;
     }
@@ -57,7 +74,8 @@ class QwRootTree {
     template < class T >
     QwRootTree(const std::string& name, const std::string& desc, T& object, const std::string& prefix = "")
     : fName(name),fDesc(desc),fPrefix(prefix),fType("type undefined"),
-      fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
+      fTypeInfo(&typeid(void)),fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0),
+      fFilledBytes(0),fAsync(kFALSE),fWriterTarget(-1),fNTuple(0),fBasketSize(0),fCompressionSettings(-1) {
       // Construct tree
       ConstructNewTree();
 
@@ -69,7 +87,8 @@ class QwRootTree {
     template < class T >
     QwRootTree(const QwRootTree* tree, T& object, const std::string& prefix = "")
     : fName(tree->GetName()),fDesc(tree->GetDesc()),fPrefix(prefix),fType("type undefined"),
-      fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
+      fTypeInfo(&typeid(void)),fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0),
+      fFilledBytes(0),fAsync(kFALSE),fWriterTarget(-1),fNTuple(0),fBasketSize(0),fCompressionSettings(-1) {
       QwMessage << "Existing tree: " << tree->GetName() << ", " << tree->GetDesc() << QwLog::endl;
       fTree = tree->fTree;
 
@@ -92,7 +111,96 @@ class QwRootTree {
     /// Construct index from this tree to another tree
     void ConstructIndexTo(QwRootTree* to) {
       std::string name = "previous_entry_in_" + to->fName;
-      fTree->Branch(name.c_str(), &(to->fCurrentEvent));
+      // The entry of the other tree is copied when this tree is filled
+      fIndexTo.push_back(to);
+      fIndexValue.push_back(to->fCurrentEvent);
+      fTree->Branch(name.c_str(), &(fIndexValue.back()));
+    }
+
+    /// Move the branches into the vector which have leaves that are not
+    /// Double_t to a buffer with the layout of their leaf list
+    void ConstructTypedLeaves(Int_t first) {
+      TObjArray* branches = fTree->GetListOfBranches();
+      std::vector< std::pair<TBranch*,size_t> > typed;
+      size_t size = 0;
+      for (Int_t b = first; b < branches->GetEntriesFast(); b++) {
+        TBranch* branch = static_cast<TBranch*>(branches->At(b));
+        const Double_t* address = reinterpret_cast<const Double_t*>(branch->GetAddress());
+        if (address < fVector.data() || address >= fVector.data() + fVector.size()) continue;
+        TObjArray* leaves = branch->GetListOfLeaves();
+        Bool_t is_typed = kFALSE;
+        Int_t length = 0;
+        for (Int_t l = 0; l < leaves->GetEntriesFast(); l++) {
+          TLeaf* leaf = static_cast<TLeaf*>(leaves->At(l));
+          if (strcmp(leaf->GetTypeName(), "Double_t") != 0) is_typed = kTRUE;
+          length = leaf->GetOffset() + leaf->GetLenType() * leaf->GetLenStatic();
+        }
+        if (! is_typed) continue;
+        // Keep each branch aligned to a double
+        typed.push_back(std::make_pair(branch, size));
+        size += (length + sizeof(Double_t) - 1) / sizeof(Double_t) * sizeof(Double_t);
+      }
+      if (typed.empty()) return;
+
+      // The buffer does not move once the branches point into it
+      fTypedBuffer.assign(size, 0);
+      for (size_t t = 0; t < typed.size(); t++) {
+        TBranch* branch = typed[t].first;
+        size_t index = reinterpret_cast<const Double_t*>(branch->GetAddress()) - fVector.data();
+        TObjArray* leaves = branch->GetListOfLeaves();
+        for (Int_t l = 0; l < leaves->GetEntriesFast(); l++) {
+          TLeaf* leaf = static_cast<TLeaf*>(leaves->At(l));
+          std::string type = leaf->GetTypeName();
+          std::vector< std::pair<size_t,size_t> >* leaves_of_type = &fTypedDouble;
+          if      (type == "Int_t")    leaves_of_type = &fTypedInt;
+          else if (type == "UInt_t")   leaves_of_type = &fTypedUInt;
+          else if (type == "Float_t")  leaves_of_type = &fTypedFloat;
+          else if (type != "Double_t") {
+            QwError << "Leaf type " << type << " of " << branch->GetName() << "."
+                    << leaf->GetName() << " cannot be filled from the branch vector"
+                    << QwLog::endl;
+            exit(-1);
+          }
+          for (Int_t i = 0; i < leaf->GetLenStatic(); i++)
+            leaves_of_type->push_back(std::make_pair(index++,
+                typed[t].second + leaf->GetOffset() + i * leaf->GetLenType()));
+        }
+        branch->SetAddress(&fTypedBuffer[typed[t].second]);
+      }
+    }
+
+  public:
+
+    /// Convert the values of the vector into the buffer of the typed leaves
+    void FillTypedLeaves() {
+      if (fTypedBuffer.empty()) return;
+      for (size_t i = 0; i < fTypedInt.size(); i++) {
+        Int_t value = ClampToInteger<Int_t>(fVector[fTypedInt[i].first]);
+        std::memcpy(&fTypedBuffer[fTypedInt[i].second], &value, sizeof(value));
+      }
+      for (size_t i = 0; i < fTypedUInt.size(); i++) {
+        UInt_t value = ClampToInteger<UInt_t>(fVector[fTypedUInt[i].first]);
+        std::memcpy(&fTypedBuffer[fTypedUInt[i].second], &value, sizeof(value));
+      }
+      for (size_t i = 0; i < fTypedFloat.size(); i++) {
+        Float_t value = Float_t(fVector[fTypedFloat[i].first]);
+        std::memcpy(&fTypedBuffer[fTypedFloat[i].second], &value, sizeof(value));
+      }
+      for (size_t i = 0; i < fTypedDouble.size(); i++) {
+        std::memcpy(&fTypedBuffer[fTypedDouble[i].second], &fVector[fTypedDouble[i].first], sizeof(Double_t));
+      }
+    }
+
+  private:
+
+    /// Convert a value to an integer type, clamped to its range (NaN to 0),
+    /// since the conversion of a value out of range is undefined
+    template < typename T >
+    static T ClampToInteger(Double_t value) {
+      if (value != value) return 0;
+      if (value <= Double_t(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+      if (value >= Double_t(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+      return T(value);
     }
 
     /// Construct the branches and vector for generic objects
@@ -102,10 +210,14 @@ class QwRootTree {
       fVector.reserve(BRANCH_VECTOR_MAX_SIZE);
       // Associate branches with vector
       TString prefix = Form("%s",fPrefix.c_str());
+      Int_t first = fTree->GetListOfBranches()->GetEntriesFast();
       object.ConstructBranchAndVector(fTree, prefix, fVector);
+      // Move branches with typed leaves to their own buffer
+      ConstructTypedLeaves(first);
 
       // Store the type of object
       fType = typeid(object).name();
+      fTypeInfo = &typeid(object);
 
       // Check memory reservation
       if (fVector.size() > BRANCH_VECTOR_MAX_SIZE) {
@@ -122,9 +234,8 @@ class QwRootTree {
     /// Fill the branches for generic objects
     template < class T >
     void FillTreeBranches(const T& object) {
-      if (typeid(object).name() == fType) {
-        // Fill the branch vector
-        object.FillTreeVector(fVector);
+      if (typeid(object) == *fTypeInfo) {
+        FillTreeVector(object);
       } else {
         QwError << "Attempting to fill tree vector for type " << fType << " with "
                 << "object of type " << typeid(object).name() << QwLog::endl;
@@ -132,28 +243,53 @@ class QwRootTree {
       }
     }
 
+    /// Fill the branches for generic objects, with the type already checked
+    template < class T >
+    void FillTreeVector(const T& object) {
+      // Fill the branch vector, or the buffer for the writer thread
+      object.FillTreeVector(fAsync? fStaging: fVector);
+    }
+
     Long64_t AutoSave(Option_t *option){
       return fTree->AutoSave(option);
     }
 
     /// Fill the tree
     Int_t Fill() {
+      if (! NextEvent()) return 0;
+      UpdateIndices();
+      FillTypedLeaves();
+      return FillEntry();
+    }
+
+    /// Count the event, and return whether it is written after prescaling
+    Bool_t NextEvent() {
       fCurrentEvent++;
 
       // Tree prescaling
       if (fNumEventsCycle > 0) {
         fCurrentEvent %= fNumEventsCycle;
         if (fCurrentEvent > fNumEventsToSave)
-          return 0;
+          return kFALSE;
       }
+      return kTRUE;
+    }
+
+    /// Copy the current entries of the trees indexed from this tree
+    void UpdateIndices() {
+      for (size_t i = 0; i < fIndexTo.size(); i++)
+        fIndexValue[i] = fIndexTo[i]->fCurrentEvent;
+    }
 
-      // Fill the tree
+    /// Fill the tree with the current branch values
+    Int_t FillEntry() {
       Int_t retval = fTree->Fill();
       // Check for errors
       if (retval < 0) {
         QwError << "Writing tree failed!  Check disk space or quota." << QwLog::endl;
         exit(retval);
       }
+      fFilledBytes += retval;
       return retval;
     }
 
@@ -170,6 +306,33 @@ class QwRootTree {
     TTree* GetTree() const { return fTree; };
 
 
+    /// Fill the branch vector in a separate buffer, to be packed for the writer thread
+    void EnableAsync() {
+      fAsync = kTRUE;
+      fStaging = fVector;
+    }
+    /// Append the values of an entry to the buffer for the writer thread
+    void PackEntry(std::vector<Double_t>& buffer) const {
+      buffer.insert(buffer.end(), fStaging.begin(), fStaging.end());
+    }
+    /// Append the entries of the trees indexed from this tree
+    void PackIndices(std::vector<Double_t>& buffer) const {
+      for (size_t i = 0; i < fIndexTo.size(); i++)
+        buffer.push_back(fIndexTo[i]->fCurrentEvent);
+    }
+    /// Copy the values of an entry into the branch vector
+    const Double_t* UnpackEntry(const Double_t* data) {
+      std::copy(data, data + fVector.size(), fVector.begin());
+      return data + fVector.size();
+    }
+    /// Copy the entries of the trees indexed from this tree
+    const Double_t* UnpackIndices(const Double_t* data) {
+      for (size_t i = 0; i < fIndexValue.size(); i++)
+        fIndexValue[i] = UInt_t(*data++);
+      return data;
+    }
+
+
   friend class QwRootFile;
 
   private:
@@ -178,6 +341,16 @@ class QwRootTree {
     TTree* fTree;
     /// Vector of leaves
     std::vector<Double_t> fVector;
+    /// Buffer of the branches with typed leaves, and the vector index and
+    /// buffer offset of each of their leaves, by type
+    std::vector<char> fTypedBuffer;
+    std::vector< std::pair<size_t,size_t> > fTypedInt;
+    std::vector< std::pair<size_t,size_t> > fTypedUInt;
+    std::vector< std::pair<size_t,size_t> > fTypedFloat;
+    std::vector< std::pair<size_t,size_t> > fTypedDouble;
+    /// Trees indexed from this tree, and their entries as written
+    std::vector<const QwRootTree*> fIndexTo;
+    std::deque<UInt_t> fIndexValue;
 
 
     /// Name, description
@@ -195,6 +368,7 @@ class QwRootTree {
 
     /// Object type
     std::string fType;
+    const std::type_info* fTypeInfo;
 
     /// Get the object type
     std::string GetType() const { return fType; };
@@ -206,6 +380,17 @@ class QwRootTree {
     UInt_t fNumEventsToSave;
     UInt_t fNumEventsToSkip;
 
+    /// Bytes filled into the tree, before compression
+    Long64_t fFilledBytes;
+
+    /// Vector filled by the event loop when the writer thread fills the tree
+    Bool_t fAsync;
+    std::vector<Double_t> fStaging;
+    /// Target number of this tree in the writer thread
+    Int_t fWriterTarget;
+    /// RNTuple written instead of the tree, with the layout of its branches
+    QwRootNTuple* fNTuple;
+
     /// Set tree prescaling parameters
     void SetPrescaling(UInt_t num_to_save, UInt_t num_to_skip) {
       fNumEventsToSave = num_to_save;
@@ -219,6 +404,8 @@ class QwRootTree {
     Long64_t fAutoFlush;
     Long64_t fAutoSave;
     Int_t fBasketSize;
+    /// Compression settings (100 * algorithm + level), or -1 for those of the file
+    Int_t fCompressionSettings;
 
     /// Set maximum tree size
     void SetMaxTreeSize(Long64_t maxsize = 1900000000) {
@@ -246,6 +433,16 @@ class QwRootTree {
       if (fTree) fTree->SetBasketSize("*",basketsize);
     }
 
+    /// Set compression settings of all branches
+    void SetCompressionSettings(Int_t settings) {
+      fCompressionSettings = settings;
+      if (fTree && settings >= 0) {
+        TObjArray* branches = fTree->GetListOfBranches();
+        for (Int_t b = 0; b < branches->GetEntriesFast(); b++)
+          static_cast<TBranch*>(branches->At(b))->SetCompressionSettings(settings);
+      }
+    }
+
     //Set circular buffer size for the memory resident tree
     void SetCircular(Long64_t buff = 100000) {
       if (fTree) fTree->SetCircular(buff);
@@ -254,6 +451,53 @@ class QwRootTree {
 
 
 
+class QwRootFile;
+
+/**
+ *  \class QwRootTreeBranches
+ *  \ingroup QwAnalysis
+ *  \brief Handle to the branches of an object in a tree
+ *
+ * Returned by QwRootFile::ConstructTreeBranches, so that the event loop can
+ * fill the branches and the tree directly, without looking up the tree by
+ * name, the branches by address, or checking the type of the object for
+ * every event.  The branches can be filled from any object with the same
+ * layout as the one for which they were constructed, e.g. a copy of it.
+ * A handle for a disabled tree does nothing.
+ */
+template < class T >
+class QwRootTreeBranches {
+
+  public:
+
+    /// Default constructor, for a disabled tree
+    QwRootTreeBranches(): fFile(0), fTree(0), fTrees(0) { }
+
+    /// Are the branches constructed?
+    Bool_t IsValid() const { return (fTree); };
+
+    /// Fill the branches from an object
+    void FillTreeBranches(const T& object) const {
+      QwProfiler::Scope profile(QwProfiler::kTrees);
+      if (fTree) fTree->FillTreeVector(object);
+    }
+    /// \brief Fill the tree of the branches
+    Int_t FillTree() const;
+
+  private:
+
+    friend class QwRootFile;
+
+    /// Constructor with the file, the branches, and all branches of the tree
+    QwRootTreeBranches(QwRootFile* file, QwRootTree* tree, std::vector<QwRootTree*>* trees)
+    : fFile(file), fTree(tree), fTrees(trees) { }
+
+    QwRootFile* fFile;
+    QwRootTree* fTree;
+    std::vector<QwRootTree*>* fTrees;
+};
+
+
 /**
  *  \class QwRootFile
  *  \ingroup QwAnalysis
@@ -280,7 +524,23 @@ class QwRootTree {
  *
  * The proper way to register a tree is by either calling ConstructTreeBranches
  * of NewTree first.  Then FillTreeBranches will fill the vector, and FillTree
- * will actually fill the tree.  FillTree should be called only once.
+ * will actually fill the tree.  FillTree should be called only once.  In the
+ * event loop, the QwRootTreeBranches handle returned by ConstructTreeBranches
+ * does the same without the lookups by name, address and type.
+ *
+ * With the option write-async, FillTree only packs the branch vectors of the
+ * tree into a buffer, and a writer thread (QwRootTreeWriter) fills the tree,
+ * so that basket compression and output are done off the event loop.  All
+ * branches of the tree must then point into the branch vectors, as required
+ * by ConstructBranchAndVector.  Everything else which reads or writes the
+ * trees or the file waits for the writer thread first.
+ *
+ * With the option tree-format=rntuple, each tree is written as an RNTuple
+ * (QwRootNTuple) with the same names.  The branches are still constructed
+ * in a TTree, which describes the fields of the RNTuple when the tree is
+ * first filled, but the TTree itself is then detached from the file.  Trees
+ * which are never filled are written as empty RNTuples, and branches added
+ * after the RNTuple was created are not written.
  */
 class QwRootFile {
 
@@ -312,13 +572,16 @@ class QwRootFile {
 
     /// \brief Construct the tree branches of a generic object
     template < class T >
-    void ConstructTreeBranches(const std::string& name, const std::string& desc, T& object, const std::string& prefix = "");
+    QwRootTreeBranches<T> ConstructTreeBranches(const std::string& name, const std::string& desc, T& object, const std::string& prefix = "");
     /// \brief Fill the tree branches of a generic object by tree name
     template < class T >
     void FillTreeBranches(const std::string& name, const T& object);
     /// \brief Fill the tree branches of a generic object by type only
     template < class T >
     void FillTreeBranches(const T& object);
+    /// \brief Fill the trees of a generic object also from another object
+    template < class T >
+    void ShareTreeBranches(const T& object, const T& alias);
 
 
     template < class T >
@@ -331,6 +594,7 @@ class QwRootFile {
     /// Fill histograms of the subsystem array
     template < class T >
     void FillHistograms(T& object) {
+      QwProfiler::Scope profile(QwProfiler::kHistograms);
       // Update regularly
       static Int_t update_count = 0;
       update_count++;
@@ -343,6 +607,7 @@ class QwRootFile {
 
     /// Create a new tree with name and description
     void NewTree(const std::string& name, const std::string& desc) {
+      WaitForWriter();
       this->cd();
       QwRootTree *tree = 0;
       if (! HasTreeByName(name)) {
@@ -350,32 +615,48 @@ class QwRootFile {
       } else {
         tree = new QwRootTree(fTreeByName[name].front());
       }
-      fTreeByName[name].push_back(tree);
+      AddTree(name, tree);
     }
 
     /// Get the tree with name
     TTree* GetTree(const std::string& name) {
+      WaitForWriter();
       if (! HasTreeByName(name)) return 0;
       else return fTreeByName[name].front()->GetTree();
     }
 
     /// Fill the tree with name
     Int_t FillTree(const std::string& name) {
+      QwProfiler::Scope profile(QwProfiler::kTrees);
       if (! HasTreeByName(name)) return 0;
-      else return fTreeByName[name].front()->Fill();
+      else return FillTree(fTreeByName[name]);
     }
 
     /// Fill all registered trees
     Int_t FillTrees() {
+      QwProfiler::Scope profile(QwProfiler::kTrees);
       // Loop over all registered tree names
       Int_t retval = 0;
       std::map< const std::string, std::vector<QwRootTree*> >::iterator iter;
       for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
-        retval += iter->second.front()->Fill();
+        retval += FillTree(iter->second);
       }
       return retval;
     }
 
+    /// Report the bytes filled into and written for each tree to the profiler
+    void ProfileTrees() const {
+      WaitForWriter();
+      std::map< const std::string, std::vector<QwRootTree*> >::const_iterator iter;
+      for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+        const QwRootTree* tree = iter->second.front();
+        // The stored size of an RNTuple is not known before it is closed
+        if (tree->fNTuple) continue;
+        if (tree->fTree)
+          gQwProfiler.AddTreeBytes(iter->first, tree->fFilledBytes, tree->fTree->GetZipBytes());
+      }
+    }
+
     /// Print registered trees
     void PrintTrees() const {
       QwMessage << "Trees: " << QwLog::endl;
@@ -406,6 +687,7 @@ class QwRootFile {
     template < class T >
     Int_t WriteObject(const T* obj, const char* name, Option_t* option = "", Int_t bufsize = 0) {
       Int_t retval = 0;
+      WaitForWriter();
       // TMapFile has no suport for WriteObject
       if (fRootFile) retval = fRootFile->WriteObject(obj,name,option,bufsize);
       return retval;
@@ -414,6 +696,7 @@ class QwRootFile {
 
     // Wrapped functionality
     void Update() {
+      WaitForWriter();
       if (fMapFile) {
         QwMessage << "TMapFile memory resident size: "
                   << ((int*)fMapFile->GetBreakval() - (int*)fMapFile->GetBaseAddr()) *
@@ -431,11 +714,13 @@ class QwRootFile {
                   << QwLog::endl;
       }
     }
-    void Print()  { if (fMapFile) fMapFile->Print();  if (fRootFile) fRootFile->Print(); }
-    void ls()     { if (fMapFile) fMapFile->ls();     if (fRootFile) fRootFile->ls(); }
-    void Map()    { if (fRootFile) fRootFile->Map(); }
+    void Print()  { WaitForWriter(); if (fMapFile) fMapFile->Print();  if (fRootFile) fRootFile->Print(); }
+    void ls()     { WaitForWriter(); if (fMapFile) fMapFile->ls();     if (fRootFile) fRootFile->ls(); }
+    void Map()    { WaitForWriter(); if (fRootFile) fRootFile->Map(); }
     void Close()  {
+      WaitForWriter();
       if (!fMakePermanent) fMakePermanent = HasAnyFilled();
+      CloseNTuples();
       if (fMapFile) fMapFile->Close();
       if (fRootFile) fRootFile->Close();
     }
@@ -451,6 +736,7 @@ class QwRootFile {
     // Wrapped functionality
     TDirectory* mkdir(const char* name, const char* title = "") {
       // TMapFile has no suport for mkdir
+      WaitForWriter();
       if (fRootFile) return fRootFile->mkdir(name, title);
       else return 0;
     }
@@ -458,6 +744,9 @@ class QwRootFile {
     // Wrapped functionality
     Int_t Write(const char* name = 0, Int_t option = 0, Int_t bufsize = 0) {
       Int_t retval = 0;
+      WaitForWriter();
+      // Trees which were not filled yet are not written as TTree either
+      if (fWriteNTuple) ConstructNTuples();
       // TMapFile has no suport for Write
       if (fRootFile) retval = fRootFile->Write(name, option, bufsize);
       return retval;
@@ -496,10 +785,59 @@ class QwRootFile {
     Int_t fAutoFlush;
     Int_t fAutoSave;
 
+    /// Writer thread filling the trees, and its settings
+    QwRootTreeWriter* fWriter;
+    Bool_t fWriteAsync;
+    Int_t fWriteQueueSize;
+    Int_t fWriteThreads;
+    /// Buffer in which the entries for the writer thread are packed
+    std::vector<Double_t> fWriterBuffer;
+
+    /// Write RNTuples instead of trees
+    Bool_t fWriteNTuple;
+    /// Trees which only describe the branches of an RNTuple
+    std::vector<TTree*> fDetachedTrees;
+    /// \brief Create the RNTuple of a tree, from all its branches
+    void ConstructNTuple(QwRootTree* tree);
+    /// \brief Create the RNTuples of the trees which were not filled yet
+    void ConstructNTuples();
+    /// \brief Write the RNTuples to the file
+    void CloseNTuples();
+
+    /// Wait until the writer thread has filled all queued entries
+    void WaitForWriter() const {
+      if (fWriter) fWriter->Wait();
+    }
+    /// \brief Register a tree, and its target in the writer thread
+    void AddTree(const std::string& name, QwRootTree* tree);
+    /// \brief Fill a tree now, or queue its entry for the writer thread
+    Int_t FillTree(std::vector<QwRootTree*>& trees);
+    template < class T > friend class QwRootTreeBranches;
+    /// \brief Fill a tree from the branch vectors of all its tree objects
+    static Int_t FillTreeEntry(std::vector<QwRootTree*>& trees);
+    /// \brief Fill a tree from an entry packed by FillTree
+    static Int_t FillTreeEntry(std::vector<QwRootTree*>& trees, const Double_t* data);
+
   
 
   private:
 
+    /// Compression and basket settings of the trees matching a name
+    struct TreeProfile_t {
+      TPRegexp fName;
+      Int_t fAlgorithm;   ///< ROOT compression algorithm, or -1 for that of the file
+      Int_t fLevel;       ///< Compression level, or -1 for compression-level
+      Int_t fBasketSize;
+      Long64_t fAutoFlush;
+      Long64_t fAutoSave;
+    };
+    std::vector< TreeProfile_t > fTreeProfiles;
+
+    /// \brief Add the profile of trees from a tree-profile option
+    void AddTreeProfile(const std::string& profile);
+    /// \brief Apply the profile of the tree name, or the global options
+    void ApplyTreeProfile(const std::string& name, QwRootTree* tree);
+
     /// List of excluded trees
     std::vector< TPRegexp > fDisabledTrees;
     std::vector< TPRegexp > fDisabledHistos;
@@ -598,6 +936,7 @@ inline void QwRootFile::ConstructIndices(const std::string& from, const std::str
   // Return if we do not want this tree information
   if (IsTreeDisabled(from)) return;
   if (IsTreeDisabled(to)) return;
+  WaitForWriter();
 
   // If the trees are defined
   if (fTreeByName.count(from) > 0 && fTreeByName.count(to) > 0) {
@@ -619,14 +958,15 @@ inline void QwRootFile::ConstructIndices(const std::string& from, const std::str
  * @param prefix Prefix for the tree
  */
 template < class T >
-void QwRootFile::ConstructTreeBranches(
+QwRootTreeBranches<T> QwRootFile::ConstructTreeBranches(
         const std::string& name,
         const std::string& desc,
         T& object,
         const std::string& prefix)
 {
   // Return if we do not want this tree information
-  if (IsTreeDisabled(name)) return;
+  if (IsTreeDisabled(name)) return QwRootTreeBranches<T>();
+  WaitForWriter();
 
   // Pointer to new tree
   QwRootTree* tree = 0;
@@ -646,11 +986,8 @@ void QwRootFile::ConstructTreeBranches(
     else if (name == "mul")
       tree->SetPrescaling(fNumHelEventsToSave, fNumHelEventsToSkip);
 
-    #if ROOT_VERSION_CODE >= ROOT_VERSION(5,26,00)
-    tree->SetAutoFlush(fAutoFlush);
-    #endif
-    tree->SetAutoSave(fAutoSave);
-    tree->SetBasketSize(fBasketSize);
+    // Compression, basket size, autoflush and autosave of the tree
+    ApplyTreeProfile(name, tree);
     tree->SetMaxTreeSize(kMaxTreeSize);
 
     if (fCircularBufferSize > 0)
@@ -659,15 +996,41 @@ void QwRootFile::ConstructTreeBranches(
   } else {
 
     // New tree based on existing tree
-    tree = new QwRootTree(fTreeByName[name].front(), object, prefix);
+    QwRootTree* first = fTreeByName[name].front();
+    tree = new QwRootTree(first, object, prefix);
+
+    // The fields of an RNTuple are fixed when it is created
+    if (first->fNTuple)
+      QwWarning << "Branches with prefix '" << prefix << "' are added to tree "
+                << name << " after it was filled, and are not written to its RNTuple"
+                << QwLog::endl;
+
+    // Settings of the tree also for the new branches
+    if (first->fBasketSize > 0) first->SetBasketSize(first->fBasketSize);
+    first->SetCompressionSettings(first->fCompressionSettings);
   }
 
    // Add the branches to the list of trees by name, object, type
   const void* addr = static_cast<const void*>(&object);
   const std::type_index type = typeid(object);
-  fTreeByName[name].push_back(tree);
+  AddTree(name, tree);
   fTreeByAddr[addr].push_back(tree);
   fTreeByType[type].push_back(tree);
+
+  // Map elements do not move, so the handle can keep the list of the tree
+  return QwRootTreeBranches<T>(this, tree, &fTreeByName[name]);
+}
+
+
+/**
+ * Fill the tree of the branches, with all branches constructed in it
+ */
+template < class T >
+Int_t QwRootTreeBranches<T>::FillTree() const
+{
+  QwProfiler::Scope profile(QwProfiler::kTrees);
+  if (! fTrees) return 0;
+  return fFile->FillTree(*fTrees);
 }
 
 
@@ -681,6 +1044,7 @@ void QwRootFile::FillTreeBranches(
         const std::string& name,
         const T& object)
 {
+  QwProfiler::Scope profile(QwProfiler::kTrees);
   // If this name has no registered trees
   if (! HasTreeByName(name)) return;
   // If this type has no registered trees
@@ -706,6 +1070,7 @@ template < class T >
 void QwRootFile::FillTreeBranches(
         const T& object)
 {
+  QwProfiler::Scope profile(QwProfiler::kTrees);
   // If this address has no registered trees
   if (! HasTreeByAddr(object)) return;
 
@@ -719,6 +1084,31 @@ void QwRootFile::FillTreeBranches(
 }
 
 
+/**
+ * Register another object of the same type with the trees of an object,
+ * so that FillTreeBranches(alias) fills the trees constructed for object.
+ * The alias must have the same layout as the object, e.g. a copy of it.
+ * @param object Object for which the trees were constructed
+ * @param alias Object that fills the same trees
+ */
+template < class T >
+void QwRootFile::ShareTreeBranches(
+        const T& object,
+        const T& alias)
+{
+  // If this address has no registered trees
+  if (! HasTreeByAddr(object)) return;
+
+  // Get the addresses of the objects
+  const void* addr = static_cast<const void*>(&object);
+  const void* alias_addr = static_cast<const void*>(&alias);
+  if (addr == alias_addr) return;
+
+  // Trees are owned through fTreeByName, so they are only listed here
+  fTreeByAddr[alias_addr] = fTreeByAddr[addr];
+}
+
+
 /**
  * Construct the histogram of a generic object
  * @param name Name for histogram directory
@@ -731,6 +1121,7 @@ void QwRootFile::ConstructHistograms(const std::string& name, T& object)
   if (IsHistoDisabled(name)) return;
 
   // Create the histograms in a directory
+  WaitForWriter();
   if (fRootFile) {
     std::string type = typeid(object).name();
     fDirsByName[name] = fRootFile->GetDirectory("/")->mkdir(name.c_str());
@@ -758,6 +1149,7 @@ template < class T >
 Int_t QwRootFile::WriteParamFileList(const TString &name, T& object)
 {
   Int_t retval = 0;
+  WaitForWriter();
   if (fRootFile) {
     TList *param_list = (TList*) fRootFile->FindObjectAny(name);
     if (not param_list) {
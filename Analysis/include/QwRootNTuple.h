@@ -0,0 +1,93 @@
+/**
+ *  \file   QwRootNTuple.h
+ *  \brief  RNTuple output with the layout of the branches of a ROOT tree
+ */
+
+#ifndef QWROOTNTUPLE_H_
+#define QWROOTNTUPLE_H_
+
+// The RNTuple API is stable from ROOT 6.36; the build only defines
+// __ROOT_HAS_RNTUPLE when that version and the ROOTNTuple library are found
+#ifdef __ROOT_HAS_RNTUPLE
+
+// System headers
+#include <vector>
+#include <memory>
+#include <string>
+
+// ROOT headers
+#include "Rtypes.h"
+#include <ROOT/RNTupleWriter.hxx>
+#include <ROOT/REntry.hxx>
+
+class TTree;
+class TBranch;
+class TDirectory;
+
+/**
+ *  \class QwRootNTuple
+ *  \ingroup QwAnalysis
+ *
+ *  \brief RNTuple output with the layout of the branches of a ROOT tree
+ *
+ *  The subsystems describe their output by constructing branches with leaf
+ *  lists (ConstructBranchAndVector), and fill the values at the addresses
+ *  of these branches (FillTreeVector).  This class writes the same values
+ *  as an RNTuple instead of a TTree, without changes to the subsystems:
+ *  the fields are made from the leaf lists of the branches of the tree,
+ *  after all branches are constructed, and Fill reads the values from the
+ *  branch addresses.
+ *
+ *  A branch with a single leaf of the same name becomes a field of the
+ *  leaf type, bound to the address of the leaf.  A branch with a leaf list
+ *  becomes a record field with a subfield for each leaf, so that the values
+ *  keep their names (e.g. qwk_bcm1.hw_sum); its leaves are copied into the
+ *  record when the entry is filled.  Branches which are not leaf lists are
+ *  not written.
+ */
+class QwRootNTuple {
+
+  public:
+
+    /// \brief Constructor with the tree of which the branches are written
+    QwRootNTuple(TTree* tree, TDirectory* dir, Int_t compression);
+    /// \brief Destructor, which writes the remaining clusters to the file
+    virtual ~QwRootNTuple();
+
+    /// Could the RNTuple be created?
+    Bool_t IsValid() const { return (fWriter != 0); };
+
+    /// \brief Fill an entry from the current values of the branches
+    Int_t Fill();
+
+    /// Number of filled entries
+    ULong64_t GetEntries() const { return fEntries; };
+
+  private:
+
+    QwRootNTuple();
+    QwRootNTuple(const QwRootNTuple&);
+    QwRootNTuple& operator=(const QwRootNTuple&);
+
+    /// \brief RNTuple type name of a leaf type, or empty if not supported
+    static std::string GetFieldType(const std::string& leaftype, Int_t length);
+
+    /// Leaf copied into a record, with its source and offset in the records
+    struct Copy_t {
+      const char* fFrom;
+      size_t fTo;
+      size_t fSize;
+    };
+    std::vector<Copy_t> fCopies;
+    /// Records of the leaf list branches, aligned as doubles
+    std::vector<Double_t> fRecords;
+
+    std::unique_ptr<ROOT::RNTupleWriter> fWriter;
+    std::unique_ptr<ROOT::REntry> fEntry;
+    ULong64_t fEntries;
+
+}; // class QwRootNTuple
+
+#endif // __ROOT_HAS_RNTUPLE
+
+#endif // QWROOTNTUPLE_H_
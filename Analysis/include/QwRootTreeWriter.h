@@ -0,0 +1,100 @@
+/**
+ *  \file   QwRootTreeWriter.h
+ *  \brief  Background thread filling ROOT trees from a bounded queue
+ */
+
+#ifndef QWROOTTREEWRITER_H_
+#define QWROOTTREEWRITER_H_
+
+// System headers
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ *  \class QwRootTreeWriter
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Background thread filling ROOT trees from a bounded queue
+ *
+ *  The event loop packs the values of a tree entry into a buffer and
+ *  pushes it; the writer thread unpacks the buffer into the branch vectors
+ *  and calls TTree::Fill, so that the serialization and compression of the
+ *  baskets and the output to disk are done off the event loop.  Entries
+ *  are filled in the order in which they were pushed.  Push only blocks
+ *  when the queue is full.
+ *
+ *  Each tree is registered once as a target, with the function that fills
+ *  it from a buffer.  Buffers are recycled, so that after the first few
+ *  entries no memory is allocated.  Anything else touching the trees or
+ *  their file has to call Wait() first.
+ */
+class QwRootTreeWriter {
+
+  public:
+
+    /// Function filling a tree from the values of an entry
+    typedef std::function<Int_t(const Double_t*)> Fill_t;
+
+  public:
+
+    /// \brief Constructor with the maximum number of queued entries
+    QwRootTreeWriter(size_t capacity);
+    /// \brief Destructor, which writes the queued entries and stops the thread
+    virtual ~QwRootTreeWriter();
+
+    /// \brief Register a tree, and return its target number
+    Int_t AddTarget(const Fill_t& fill);
+
+    /// \brief Queue an entry; the buffer is swapped with an empty one
+    void Push(Int_t target, std::vector<Double_t>& buffer);
+
+    /// \brief Wait until all queued entries have been filled
+    void Wait();
+
+    /// \brief Print the number of entries and the time the event loop waited
+    void PrintSummary() const;
+
+  private:
+
+    QwRootTreeWriter();
+    QwRootTreeWriter(const QwRootTreeWriter&);
+    QwRootTreeWriter& operator=(const QwRootTreeWriter&);
+
+    /// Body of the writer thread
+    void Loop();
+
+    /// Queued entry
+    struct Entry_t {
+      Int_t fTarget;
+      std::vector<Double_t> fValues;
+    };
+
+    std::vector<Fill_t> fTargets;
+
+    const size_t fCapacity;
+    std::deque<Entry_t> fQueue;                   ///< Entries waiting to be filled
+    std::vector< std::vector<Double_t> > fSpare;  ///< Recycled buffers
+    Bool_t fBusy;                                 ///< Writer is filling an entry
+    Bool_t fStop;
+
+    ULong64_t fEntries;   ///< Entries pushed
+    ULong64_t fBlocked;   ///< Pushes which found the queue full
+    ULong64_t fWaitTime;  ///< Time the event loop waited, in ns
+
+    mutable std::mutex fMutex;
+    std::condition_variable fNotEmpty;
+    std::condition_variable fNotFull;
+    std::condition_variable fIdle;
+
+    std::thread fThread;
+
+}; // class QwRootTreeWriter
+
+#endif // QWROOTTREEWRITER_H_
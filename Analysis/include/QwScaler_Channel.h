@@ -63,7 +63,9 @@ public:
     fClockNormalization(source.fClockNormalization),
     fNormChannelName(source.fNormChannelName),
     fNeedsExternalClock(source.fNeedsExternalClock),
-    fIsDifferentialScaler(source.fIsDifferentialScaler)
+    fIsDifferentialScaler(source.fIsDifferentialScaler),
+    fNumEvtsWithHWErrors(0),
+    fNumEvtsWithEventCutsRejected(0)
   { }
   virtual ~VQwScaler_Channel() { };
 
@@ -113,6 +115,8 @@ public:
   VQwScaler_Channel& operator=  (const VQwScaler_Channel &value);
   void AssignScaledValue(const VQwScaler_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
   void AddValueFrom(const VQwHardwareChannel* valueptr);
   void SubtractValueFrom(const VQwHardwareChannel* valueptr);
   void MultiplyBy(const VQwHardwareChannel* valueptr);
@@ -142,6 +146,8 @@ public:
   Bool_t ApplySingleEventCuts();//check values read from modules are at desired level
 
   void IncrementErrorCounters();
+  /// add the error counters of another copy of this channel
+  void MergeErrorCounters(const VQwScaler_Channel& source);
 
   /// report number of events failed due to HW and event cut failure
   void PrintErrorCounters() const;
@@ -0,0 +1,96 @@
+/**********************************************************\
+* File: QwSubbankDecodeMap.h                               *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#ifndef __QWSUBBANKDECODEMAP__
+#define __QWSUBBANKDECODEMAP__
+
+// System headers
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+
+// Qweak headers
+#include "VQwDataElement.h"
+
+/**
+ *  \class QwSubbankDecodeMap
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Data elements to decode, grouped by subbank index
+ *
+ *  A subsystem fills this once from its channel map, after all data
+ *  elements have been created, with the element, the word offset and
+ *  the subelement of each channel.  Decoding a subbank is then a walk
+ *  over only the elements read out in that subbank, in the order in
+ *  which they were added.
+ *
+ *  The map holds pointers into the element containers of the subsystem,
+ *  so it must be rebuilt whenever those containers are copied or grow.
+ *  The pointers are therefore never copied: a copy of a map is empty,
+ *  and assigning a map leaves the targets of the destination as they
+ *  were, still pointing to the elements of its own subsystem.
+ */
+class QwSubbankDecodeMap {
+
+ public:
+  /// Decode target for a single channel
+  struct Target_t {
+    VQwDataElement* fElement;       ///< Element to receive the data
+    UInt_t          fWordInSubbank; ///< First word of the element in the subbank
+    UInt_t          fSubelement;    ///< Subelement passed to the element
+  };
+
+  QwSubbankDecodeMap() { };
+  /// Copy constructor; the copy is empty and has to be rebuilt
+  QwSubbankDecodeMap(const QwSubbankDecodeMap&) { };
+  virtual ~QwSubbankDecodeMap() { };
+
+  /// Assignment; the targets of the destination are kept
+  QwSubbankDecodeMap& operator=(const QwSubbankDecodeMap&) { return *this; };
+
+  /// Remove all targets
+  void Clear() { fTargets.clear(); };
+
+  /// Add a target to the subbank with the given index
+  void AddTarget(Int_t subbank_index, VQwDataElement* element,
+                 UInt_t word_in_subbank, UInt_t subelement = 0) {
+    if (subbank_index < 0 || element == 0) return;
+    if (fTargets.size() <= (size_t) subbank_index)
+      fTargets.resize(subbank_index + 1);
+    Target_t target;
+    target.fElement = element;
+    target.fWordInSubbank = word_in_subbank;
+    target.fSubelement = subelement;
+    fTargets[subbank_index].push_back(target);
+  };
+
+  /// Number of targets in the subbank with the given index
+  size_t GetNumberOfTargets(Int_t subbank_index) const {
+    if (subbank_index < 0 || (size_t) subbank_index >= fTargets.size()) return 0;
+    return fTargets[subbank_index].size();
+  };
+
+  /// Pass the subbank buffer to all targets in the subbank
+  void ProcessEvBuffer(Int_t subbank_index, UInt_t* buffer, UInt_t num_words) const {
+    if (subbank_index < 0 || (size_t) subbank_index >= fTargets.size()) return;
+    const std::vector<Target_t>& targets = fTargets[subbank_index];
+    for (size_t i = 0; i < targets.size(); i++) {
+      const Target_t& target = targets[i];
+      target.fElement->ProcessEvBuffer(&(buffer[target.fWordInSubbank]),
+                                       num_words - target.fWordInSubbank,
+                                       target.fSubelement);
+    }
+  };
+
+ private:
+  /// Targets per subbank index
+  std::vector< std::vector<Target_t> > fTargets;
+
+}; // class QwSubbankDecodeMap
+
+#endif // __QWSUBBANKDECODEMAP__
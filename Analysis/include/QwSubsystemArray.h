@@ -26,6 +26,7 @@
 // Forward declarations
 class VQwHardwareChannel;
 class QwParameterFile;
+class QwTaskPool;
 
 ///
 /// \ingroup QwAnalysis
@@ -132,6 +133,11 @@ class QwSubsystemArray:  public std::vector<boost::shared_ptr<VQwSubsystem> > {
 			const BankID_t bank_id, UInt_t *buffer,
 			UInt_t num_words);
 
+  /// \brief Build the table routing each ROC/bank to its subsystems
+  void BuildBankRoutes();
+  /// \brief Discard the bank routing table (e.g. after reloading channel maps)
+  void ResetBankRoutes() { fBankRoutes.clear(); fBankRoutesValid = kFALSE; };
+
   /// \brief Randomize the data in this event
   void  RandomizeEventData(int helicity = 0, double time = 0.0);
 
@@ -140,6 +146,20 @@ class QwSubsystemArray:  public std::vector<boost::shared_ptr<VQwSubsystem> > {
 
   /// \brief Process the decoded data in this event
   void  ProcessEvent();
+  /// \brief Order the subsystems so that publishers are processed before
+  ///        the subsystems that use their values
+  void BuildProcessLevels();
+  /// \brief Discard the processing order (e.g. after publishing values)
+  void ResetProcessLevels() { fProcessLevels.clear(); fProcessLevelsValid = kFALSE; };
+
+  /// Time spent decoding the banks of a subsystem, in nanoseconds
+  ULong64_t GetDecodeTime(size_t i) const {
+    return (i < fDecodeTime.size())? fDecodeTime[i]: 0;
+  };
+  /// Time spent processing the events of a subsystem, in nanoseconds
+  ULong64_t GetProcessTime(size_t i) const {
+    return (i < fProcessTime.size())? fProcessTime[i]: 0;
+  };
 
   /// \brief Perform actions at the end of the event loop
   void  AtEndOfEventLoop();
@@ -148,6 +168,10 @@ class QwSubsystemArray:  public std::vector<boost::shared_ptr<VQwSubsystem> > {
 
   /// \brief Retrieve the variable name from other subsystem arrays
   Bool_t RequestExternalValue(const TString& name, VQwHardwareChannel* value) const;
+  /// \brief Retrieve a pointer to the variable name from other subsystem arrays
+  const VQwHardwareChannel* RequestExternalPointer(const TString& name) const;
+  /// \brief Let the subsystems look up the external values they use
+  void ResolveExternalValues();
 
   /// \brief Retrieve the variable name from subsystems in this subsystem array
   const VQwHardwareChannel* ReturnInternalValue(const TString& name) const;
@@ -282,6 +306,45 @@ class QwSubsystemArray:  public std::vector<boost::shared_ptr<VQwSubsystem> > {
   /// Function to determine which subsystems we can accept
   CanContainFn fnCanContain;
 
+ private:
+  /// Subsystem receiving a routed bank, with its subbank index for that bank
+  struct BankRoute_t {
+    VQwSubsystem* fSubsystem;
+    size_t fIndex;        ///< Index of the subsystem in the array
+    Int_t fSubbankIndex;  ///< -1 for subsystems that receive all banks
+  };
+  typedef std::vector<BankRoute_t> BankRouteList_t;
+  typedef std::pair<ROCID_t,BankID_t> BankKey_t;
+
+  /// Subsystems interested in each registered ROC/bank (and marker) pair
+  std::map<BankKey_t, BankRouteList_t> fBankRoutes;
+  /// Subsystems that receive banks nobody has registered
+  BankRouteList_t fUnroutedBankRoute;
+  Bool_t fBankRoutesValid;  ///< Is the routing table up to date?
+
+  /// Threads processing the subsystems of an event
+  Int_t fProcessThreads;
+  /// Thread pool, started at the first event processed in parallel
+  boost::shared_ptr<QwTaskPool> fTaskPool;
+  /// Subsystem indices by level; a level only depends on earlier levels
+  std::vector<std::vector<size_t> > fProcessLevels;
+  Bool_t fProcessLevelsValid;  ///< Is the processing order up to date?
+  /// Run a processing phase over the subsystems, level by level
+  void ProcessLevels(void (VQwSubsystem::*phase)());
+  /// Run a processing phase of one subsystem and add up its time
+  void ProcessPhase(size_t i, void (VQwSubsystem::*phase)());
+
+  /// Time spent in each subsystem (see QwProfiler)
+  std::vector<ULong64_t> fDecodeTime;
+  std::vector<ULong64_t> fProcessTime;
+
+  /// Add a subsystem to a route list, unless it is already in it
+  static void AddBankRoute(BankRouteList_t& routes, const BankRoute_t& route);
+  /// Deliver a bank to the subsystems in a route list
+  void DispatchEvBuffer(const BankRouteList_t& routes,
+                        const UInt_t event_type, const ROCID_t roc_id,
+                        const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
+
   /// Test whether this subsystem array can contain a particular subsystem
   static Bool_t CanContain(VQwSubsystem* subsys) {
     if (subsys == 0) {
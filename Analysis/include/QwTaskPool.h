@@ -0,0 +1,78 @@
+/**
+ *  \file   QwTaskPool.h
+ *  \brief  Fixed set of threads running the tasks of a parallel loop
+ */
+
+#ifndef QWTASKPOOL_H_
+#define QWTASKPOOL_H_
+
+// System headers
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ *  \class QwTaskPool
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Fixed set of threads running the tasks of a parallel loop
+ *
+ *  Run(n, task) calls task(0) to task(n-1) on the threads of the pool and
+ *  on the calling thread, and returns when all of them are done.  The
+ *  threads are started once and wait between calls, so that a loop can
+ *  be run for every event without the cost of creating threads.  Only
+ *  one thread may call Run() at a time.
+ */
+class QwTaskPool {
+
+  public:
+
+    /// Task of a parallel loop, called with the index of the iteration
+    typedef std::function<void(size_t)> Task_t;
+
+  public:
+
+    /// \brief Constructor with the total number of threads, including the caller
+    QwTaskPool(Int_t threads);
+    /// \brief Destructor, which stops the threads
+    virtual ~QwTaskPool();
+
+    /// Number of threads running tasks, including the caller
+    Int_t GetNumberOfThreads() const { return fThreads.size() + 1; };
+
+    /// \brief Run the tasks of a loop and wait until all are done
+    void Run(size_t n, const Task_t& task);
+
+  private:
+
+    QwTaskPool();
+    QwTaskPool(const QwTaskPool&);
+    QwTaskPool& operator=(const QwTaskPool&);
+
+    /// Body of the threads of the pool
+    void Loop();
+    /// Run tasks until none are left
+    void Work();
+
+    std::vector<std::thread> fThreads;
+
+    const Task_t* fTask;          ///< Task of the current loop
+    size_t fCount;                ///< Iterations of the current loop
+    std::atomic<size_t> fNext;    ///< Next iteration to be started
+    size_t fActive;               ///< Threads still working on the current loop
+    ULong64_t fGeneration;        ///< Number of the current loop
+    Bool_t fStop;
+
+    std::mutex fMutex;
+    std::condition_variable fStart;
+    std::condition_variable fDone;
+
+}; // class QwTaskPool
+
+#endif // QWTASKPOOL_H_
@@ -69,7 +69,19 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
     VQwHardwareChannel(value), MQwMockable(value),
     fBlocksPerEvent(value.fBlocksPerEvent),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
-    fSaturationABSLimit(value.fSaturationABSLimit)
+    fErrorCount_HWSat(0),
+    fErrorCount_sample(0),
+    fErrorCount_SW_HW(0),
+    fErrorCount_Sequence(0),
+    fErrorCount_SameHW(0),
+    fErrorCount_ZeroHW(0),
+    fNumEvtsWithEventCutsRejected(0),
+    fSaturationABSLimit(value.fSaturationABSLimit),
+    bHw_sum(value.bHw_sum), bHw_sum_raw(value.bHw_sum_raw),
+    bBlock(value.bBlock), bBlock_raw(value.bBlock_raw),
+    bNum_samples(value.bNum_samples),
+    bDevice_Error_Code(value.bDevice_Error_Code),
+    bSequence_number(value.bSequence_number)
   {
     *this = value;
   };
@@ -77,7 +89,19 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
     VQwHardwareChannel(value,datatosave), MQwMockable(value),
     fBlocksPerEvent(value.fBlocksPerEvent),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
-    fSaturationABSLimit(value.fSaturationABSLimit)
+    fErrorCount_HWSat(0),
+    fErrorCount_sample(0),
+    fErrorCount_SW_HW(0),
+    fErrorCount_Sequence(0),
+    fErrorCount_SameHW(0),
+    fErrorCount_ZeroHW(0),
+    fNumEvtsWithEventCutsRejected(0),
+    fSaturationABSLimit(value.fSaturationABSLimit),
+    bHw_sum(value.bHw_sum), bHw_sum_raw(value.bHw_sum_raw),
+    bBlock(value.bBlock), bBlock_raw(value.bBlock_raw),
+    bNum_samples(value.bNum_samples),
+    bDevice_Error_Code(value.bDevice_Error_Code),
+    bSequence_number(value.bSequence_number)
   {
     *this = value;
   };
@@ -128,6 +152,8 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
   //  VQwHardwareChannel& operator=  (const VQwHardwareChannel &value);
   void AssignScaledValue(const QwVQWK_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
   void AddValueFrom(const VQwHardwareChannel* valueptr);
   void SubtractValueFrom(const VQwHardwareChannel* valueptr);
   void MultiplyBy(const VQwHardwareChannel* valueptr);
@@ -195,6 +221,7 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
   Int_t ApplyHWChecks(); //Check for harware errors in the devices. This will return the device error code.
 
   void IncrementErrorCounters();//update the error counters based on the internal fErrorFlag
+  void MergeErrorCounters(const QwVQWK_Channel& source);//add the error counters of another copy of this channel
   
   /*End*/
 
@@ -117,6 +117,10 @@ public:
      Scale(scale);
   };
   void AssignValueFrom(const VQwDataElement* valueptr) = 0;
+  /// \brief Append the event-based data copied by operator= to a buffer
+  virtual void PackEventData(std::vector<Double_t>& buffer) const = 0;
+  /// \brief Restore the event-based data written by PackEventData
+  virtual void UnpackEventData(const Double_t*& data) = 0;
   virtual VQwHardwareChannel& operator+=(const VQwHardwareChannel* input) = 0;
   virtual VQwHardwareChannel& operator-=(const VQwHardwareChannel* input) = 0;
   virtual VQwHardwareChannel& operator*=(const VQwHardwareChannel* input) = 0;
@@ -141,6 +145,16 @@ public:
     AccumulateRunningSum(value, -1);
   };
 
+  /*! \brief While an object of this class exists, AccumulateRunningSum
+   *         merges the running sums of other parts of the run (with the
+   *         number of good events of the value as count) instead of
+   *         adding single events */
+  class MergeScope {
+   public:
+    MergeScope()  { fMergingRunningSums = kTRUE; };
+    ~MergeScope() { fMergingRunningSums = kFALSE; };
+  };
+
   virtual void AddValueFrom(const VQwHardwareChannel* valueptr) = 0;
   virtual void SubtractValueFrom(const VQwHardwareChannel* valueptr) = 0;
   virtual void MultiplyBy(const VQwHardwareChannel* valueptr) = 0;
@@ -215,6 +229,9 @@ protected:
   Double_t fStability;/*!<how much deviaton from the stable reading is allowed*/
   //@}
 
+  /// Are running sums being merged in this thread? (see MergeScope)
+  static thread_local Bool_t fMergingRunningSums;
+
 };   // class VQwHardwareChannel
 
 #endif // __MQWHARDWARECHANNEL__
@@ -12,6 +12,8 @@
 // System headers
 #include <iostream>
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 // ROOT headers
 #include "Rtypes.h"
@@ -64,13 +66,16 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
   VQwSubsystem(const TString& name)
   : MQwHistograms(),
     fSystemName(name), fEventTypeMask(0x0), fIsDataLoaded(kFALSE),
-    fCurrentROC_ID(-1), fCurrentBank_ID(-1) {
+    fCurrentROC_ID(-1), fCurrentBank_ID(-1),
+    fDispatchedROC_ID(kNullROCID), fDispatchedBank_ID(kNullBankID),
+    fDispatchedSubbankIndex(-1) {
     ClearAllBankRegistrations();
   }
   /// Copy constructor by object
   VQwSubsystem(const VQwSubsystem& orig)
   : MQwHistograms(orig),
     fPublishList(orig.fPublishList),
+    fExternalValueNames(orig.fExternalValueNames),
     fROC_IDs(orig.fROC_IDs),
     fBank_IDs(orig.fBank_IDs),
     fMarkerWords(orig.fMarkerWords)
@@ -79,6 +84,9 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
     fIsDataLoaded = orig.fIsDataLoaded;
     fCurrentROC_ID = orig.fCurrentROC_ID;
     fCurrentBank_ID = orig.fCurrentBank_ID;
+    fDispatchedROC_ID = kNullROCID;
+    fDispatchedBank_ID = kNullBankID;
+    fDispatchedSubbankIndex = -1;
   }
 
   /// Default destructor
@@ -118,6 +126,17 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
   /// \brief Request a named value which is owned by an external subsystem;
   ///        the request will be handled by the parent subsystem array
   Bool_t RequestExternalValue(const TString& name, VQwHardwareChannel* value) const;
+  /// \brief Request a pointer to a named value which is owned by an external
+  ///        subsystem; the pointer stays valid for the lifetime of the parent
+  const VQwHardwareChannel* RequestExternalPointer(const TString& name) const;
+  /// \brief Names of the external values used while processing an event;
+  ///        their publishers are processed before this subsystem
+  const std::vector<TString>& GetExternalValueNames() const {
+    return fExternalValueNames;
+  };
+  /// \brief Look up the external values used while processing an event;
+  ///        called by the parent array once all subsystems have published
+  virtual void ResolveExternalValues() { };
 
   /// \brief Return a pointer to a varialbe to the parent subsystem array to be
   ///        delivered to a different subsystem.
@@ -148,6 +167,19 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
     fPublishedInternalValues[name] = data_channel;
   };
 
+  /// List of external values used while processing an event
+  std::vector<TString> fExternalValueNames;
+
+  /// \brief Declare that ProcessEvent or ProcessEvent_2 uses an external value
+  ///
+  /// Values which are only read in ExchangeProcessedData need no declaration,
+  /// since that phase runs serially after ProcessEvent of all subsystems.
+  void DeclareExternalValue(const TString& name) {
+    if (std::find(fExternalValueNames.begin(), fExternalValueNames.end(), name)
+        == fExternalValueNames.end())
+      fExternalValueNames.push_back(name);
+  };
+
  public:
 
   /// \brief Parse parameter file to find the map files
@@ -173,6 +205,21 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
 
   virtual Int_t ProcessConfigurationBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words) = 0;
 
+  /// \brief Does this subsystem need every bank, including ones it has not
+  ///        registered?  Subsystems that return kTRUE are not routed by the
+  ///        ROC/bank table of the subsystem array.
+  virtual Bool_t ReceivesAllBanks() const { return kFALSE; };
+  /// \brief List the (ROC, bank) pairs registered by this subsystem, in
+  ///        subbank index order
+  void GetRegisteredBanks(std::vector<std::pair<ROCID_t,BankID_t> >& banks) const;
+  /// \brief Record the subbank index of the bank about to be delivered, so
+  ///        that GetSubbankIndex does not have to search for it
+  void SetDispatchedSubbank(const ROCID_t roc_id, const BankID_t bank_id, const Int_t index) {
+    fDispatchedROC_ID = roc_id;
+    fDispatchedBank_ID = bank_id;
+    fDispatchedSubbankIndex = index;
+  };
+
   virtual Int_t ProcessEvBuffer(const UInt_t event_type, const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words){
     /// TODO:  Subsystems should be changing their ProcessEvBuffer routines to take the event_type as the first
     ///  argument.  But in the meantime, default to just calling the non-event-type-aware ProcessEvBuffer routine.
@@ -301,6 +348,11 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
    */
   Int_t RegisterSubbank(const BankID_t bank_id);
 
+  /*! \brief Tell the parent arrays that the registered banks changed, so
+   *         that their bank routing tables are rebuilt
+   */
+  void  ResetParentBankRoutes();
+
   Int_t RegisterMarkerWord(const UInt_t markerword);
 
   void RegisterRocBankMarker(QwParameterFile &mapstr);
@@ -350,6 +402,10 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms {
   ROCID_t  fCurrentROC_ID; ///< ROC ID that is currently being processed
   BankID_t fCurrentBank_ID; ///< Bank ID (and Marker word) that is currently being processed; 
 
+  ROCID_t  fDispatchedROC_ID;       ///< ROC ID of the bank last routed to this subsystem
+  BankID_t fDispatchedBank_ID;      ///< Bank ID of the bank last routed to this subsystem
+  Int_t    fDispatchedSubbankIndex; ///< Precomputed subbank index of that bank
+
   /// Vector of ROC IDs associated with this subsystem
   std::vector<ROCID_t> fROC_IDs;
   /// Vector of Bank IDs per ROC ID associated with this subsystem
@@ -138,6 +138,16 @@ void QwADC18_Channel::IncrementErrorCounters(){
   }
 }
 
+void QwADC18_Channel::MergeErrorCounters(const QwADC18_Channel& source){
+  fErrorCount_sample   += source.fErrorCount_sample;
+  fErrorCount_SW_HW    += source.fErrorCount_SW_HW;
+  fErrorCount_Sequence += source.fErrorCount_Sequence;
+  fErrorCount_SameHW   += source.fErrorCount_SameHW;
+  fErrorCount_ZeroHW   += source.fErrorCount_ZeroHW;
+  fErrorCount_HWSat    += source.fErrorCount_HWSat;
+  fNumEvtsWithEventCutsRejected += source.fNumEvtsWithEventCutsRejected;
+}
+
 /********************************************************/
 
 void QwADC18_Channel::InitializeChannel(TString name, TString datatosave)
@@ -574,21 +584,27 @@ void  QwADC18_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, st
 
     TString list;
 
+    //  Leaf types from the tree trim file or their defaults; QwRootTree
+    //  converts the values of the vector to these types when filled
+    auto LeafType = [this](const char* element) {
+      return TString("/") + gQwHists.GetElementLeafType(GetSubsystemName().Data(), GetModuleType().Data(), element);
+    };
+
     values.push_back(0.0);
-    list = "value/D";
+    list = "value"+LeafType("value");
 
     values.push_back(0.0);
-    list += ":Device_Error_Code/D";
+    list += ":Device_Error_Code"+LeafType("Device_Error_Code");
 
     if (fDataToSave == kRaw){
       values.push_back(0.0);
-      list += ":raw/D";
+      list += ":raw"+LeafType("raw");
       values.push_back(0.0);
-      list += ":diff/D";
+      list += ":diff"+LeafType("diff");
       values.push_back(0.0);
-      list += ":peak/D";
+      list += ":peak"+LeafType("peak");
       values.push_back(0.0);
-      list += ":base/D";
+      list += ":base"+LeafType("base");
     }
 
     fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
@@ -661,6 +677,36 @@ QwADC18_Channel& QwADC18_Channel::operator= (const QwADC18_Channel &value)
   return *this;
 }
 
+void QwADC18_Channel::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (!IsNameEmpty()) {
+    buffer.push_back(fGoodEventCount);
+    buffer.push_back(fErrorFlag);
+    buffer.push_back(fDiff_Raw);
+    buffer.push_back(fPeak_Raw);
+    buffer.push_back(fBase_Raw);
+    buffer.push_back(fValue_Raw);
+    buffer.push_back(fValue);
+    buffer.push_back(fValueError);
+    buffer.push_back(fValueM2);
+  }
+}
+
+void QwADC18_Channel::UnpackEventData(const Double_t*& data)
+{
+  if (!IsNameEmpty()) {
+    fGoodEventCount = Int_t(*data++);
+    fErrorFlag      = UInt_t(*data++);
+    fDiff_Raw   = UInt_t(*data++);
+    fPeak_Raw   = UInt_t(*data++);
+    fBase_Raw   = UInt_t(*data++);
+    fValue_Raw  = UInt_t(*data++);
+    fValue      = *data++;
+    fValueError = *data++;
+    fValueM2    = *data++;
+  }
+}
+
 void QwADC18_Channel::AssignScaledValue(const QwADC18_Channel &value,
 				 Double_t scale)
 {
@@ -1027,8 +1073,9 @@ void QwADC18_Channel::AccumulateRunningSum(const QwADC18_Channel& value, Int_t c
   Int_t n1 = fGoodEventCount;
   Int_t n2 = count;
 
-  // If there are no good events, check whether device HW is good
-  if (n2 == 0 && value.fErrorFlag == 0) {
+  // If there are no good events, check whether device HW is good;
+  // a merged running sum without good events adds nothing
+  if (n2 == 0 && value.fErrorFlag == 0 && ! fMergingRunningSums) {
     n2 = 1;
   }
   Int_t n = n1 + n2;
@@ -1049,7 +1096,7 @@ void QwADC18_Channel::AccumulateRunningSum(const QwADC18_Channel& value, Int_t c
     // general version for addition of multi-event sets
     fGoodEventCount += n2;
     fValue += n2 * (M12 - M11) / n;
-    fValueM2 += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+    fValueM2 += M22 + Double_t(n1) * n2 * (M12 - M11) * (M12 - M11) / n;
   }
 
   // Nanny
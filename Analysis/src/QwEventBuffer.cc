@@ -4,6 +4,7 @@
 #include "QwEPICSEvent.h"
 #include "VQwSubsystem.h"
 #include "QwSubsystemArray.h"
+#include "QwProfiler.h"
 
 #include <TMath.h>
 
@@ -45,6 +46,24 @@ QwEventBuffer::QwEventBuffer()
        fDataFileExtension(fDefaultDataFileExtension),
        fEvStreamMode(fEvStreamNull),
        fEvStream(NULL),
+       fMemoryMapFiles(kFALSE),
+       fPrefetchDepth(0),
+       fPrefetchHead(0),
+       fPrefetchTail(0),
+       fPrefetchFilled(0),
+       fPrefetchHolding(kFALSE),
+       fPrefetchStop(kFALSE),
+       fPrefetchDone(kFALSE),
+       fPrefetchActive(kFALSE),
+       fPrefetchEvent(NULL),
+       fRecordLimit(0),
+       fRecordedWords(0),
+       fRecording(kFALSE),
+       fRecordComplete(kFALSE),
+       fReplaying(kFALSE),
+       fRecordEndStatus(CODA_OK),
+       fReplayNext(0),
+       fReplayEvent(NULL),
        fCurrentRun(-1),
        fRunIsSegmented(kFALSE),
        fPhysicsEventFlag(kFALSE),
@@ -106,6 +125,15 @@ void QwEventBuffer::DefineOptions(QwOptions &options)
   options.AddDefaultOptions()
     ("codafile-ext", po::value<string>()->default_value(fDefaultDataFileExtension),
      "extension of the input CODA filename");
+  options.AddDefaultOptions()
+    ("codafile-mmap", po::value<bool>()->default_bool_value(false),
+     "read uncompressed CODA files through a memory mapping, avoiding event copies");
+  options.AddDefaultOptions()
+    ("prefetch-events", po::value<int>()->default_value(0),
+     "number of raw events to read ahead from data files on a background thread (0 disables)");
+  options.AddDefaultOptions()
+    ("replay-buffer", po::value<int>()->default_value(512),
+     "memory in MB for the events read while looking for the first EPICS event, which are replayed instead of reopening the data file (0 disables)");
   //  Special flag to allow sub-bank IDs less than 31
   options.AddDefaultOptions()
     ("allow-low-subbank-ids", po::value<bool>()->default_bool_value(false),
@@ -173,6 +201,11 @@ void QwEventBuffer::ProcessOptions(QwOptions &options)
   fChainDataFiles = options.GetValue<bool>("chainfiles");
   fDataFileStem = options.GetValue<string>("codafile-stem");
   fDataFileExtension = options.GetValue<string>("codafile-ext");
+  fMemoryMapFiles = options.GetValue<bool>("codafile-mmap");
+  fPrefetchDepth = options.GetValue<int>("prefetch-events");
+  if (fPrefetchDepth < 0) fPrefetchDepth = 0;
+  Int_t replay_mb = options.GetValue<int>("replay-buffer");
+  fRecordLimit = (replay_mb > 0)? ULong64_t(replay_mb) * 1024 * 1024 / sizeof(UInt_t): 0;
 
   fAllowLowSubbankIDs = options.GetValue<bool>("allow-low-subbank-ids");
 
@@ -298,6 +331,7 @@ Int_t QwEventBuffer::ReOpenStream()
   Int_t status = CODA_ERROR;
   //  Reset the physics event counter
   fNumPhysicsEvents = fStartingPhysicsEvent;
+  ClearRecording();
 
   if (fOnline) {
     // Online stream
@@ -351,6 +385,7 @@ Int_t QwEventBuffer::OpenNextStream()
     }
 
   }
+  ClearRecording();
   //  Grab the starting event counter
   fStartingPhysicsEvent = fNumPhysicsEvents;
   //  Start the timers.
@@ -367,6 +402,7 @@ Int_t QwEventBuffer::CloseStream()
   fStopwatch.Stop();
   QwWarning << "Starting CloseStream."
 	    << QwLog::endl;
+  ClearRecording();
   Int_t status = kFileHandleNotConfigured;
   if (fEvStreamMode==fEvStreamFile
       && (fRunIsSegmented && !fChainDataFiles) ){
@@ -386,6 +422,7 @@ Int_t QwEventBuffer::CloseStream()
 
 Int_t QwEventBuffer::GetNextEvent()
 {
+  QwProfiler::Scope profile(QwProfiler::kRead);
   //  This will return for read errors,
   //  non-physics events, and for physics
   //  events that are within the event range.
@@ -444,17 +481,91 @@ Int_t QwEventBuffer::GetEvent()
 {
   Int_t status = kFileHandleNotConfigured;
   ResetFlags();
+  if (fReplaying) {
+    //  Hand out the recorded events before reading on
+    if (fReplayNext < fRecordedEvents.size()) {
+      fReplayEvent = &(fRecordedEvents[fReplayNext++][0]);
+      DecodeEventIDBank(fReplayEvent);
+      return CODA_OK;
+    }
+    //  If the recording ended at the end of the stream (e.g. the last
+    //  chained segment has been closed), there is nothing to read on
+    Int_t end_status = fRecordEndStatus;
+    ClearRecording();
+    if (end_status != CODA_OK) return end_status;
+  }
   if (fEvStreamMode==fEvStreamFile){
     status = GetFileEvent();
   } else if (fEvStreamMode==fEvStreamET){
     status = GetEtEvent();
   }
   if (status == CODA_OK){
-    DecodeEventIDBank((UInt_t*)(fEvStream->getEvBuffer()));
+    DecodeEventIDBank(GetEvBuffer());
+  }
+  if (status != CODA_OK && fRecording){
+    //  The recording is complete up to the end of the stream
+    fRecording = kFALSE;
+    fRecordEndStatus = status;
+  }
+  if (status == CODA_OK && fRecording){
+    UInt_t* buffer = GetEvBuffer();
+    if (fRecordedWords + buffer[0] + 1 <= fRecordLimit) {
+      fRecordedEvents.push_back(std::vector<UInt_t>(buffer, buffer + buffer[0] + 1));
+      fRecordedWords += buffer[0] + 1;
+    } else {
+      //  Too many events to keep, the stream has to be reopened
+      QwVerbose << "Recorded " << fRecordedEvents.size() << " events, "
+                << "stopping the recording" << QwLog::endl;
+      ClearRecording();
+    }
   }
   return status;
 }
 
+void QwEventBuffer::StartRecording()
+{
+  ClearRecording();
+  fRecording = (fRecordLimit > 0);
+  fRecordComplete = fRecording;
+}
+
+Bool_t QwEventBuffer::ReplayRecording()
+{
+  if (! fRecordComplete) {
+    ClearRecording();
+    return kFALSE;
+  }
+  QwMessage << "Replaying the " << fRecordedEvents.size()
+            << " events read so far" << QwLog::endl;
+  //  Count the physics events again, as after reopening the stream
+  fNumPhysicsEvents = fStartingPhysicsEvent;
+  fRecording = kFALSE;
+  fReplaying = kTRUE;
+  fReplayNext = 0;
+  return kTRUE;
+}
+
+void QwEventBuffer::ClearRecording()
+{
+  fRecording = kFALSE;
+  fRecordComplete = kFALSE;
+  fReplaying = kFALSE;
+  fRecordEndStatus = CODA_OK;
+  std::vector<std::vector<UInt_t> >().swap(fRecordedEvents);
+  fRecordedWords = 0;
+  fReplayNext = 0;
+  fReplayEvent = NULL;
+}
+
+UInt_t* QwEventBuffer::GetEvBuffer()
+{
+  if (fReplayEvent != NULL)
+    return fReplayEvent;
+  if (fPrefetchActive && fPrefetchEvent != NULL)
+    return fPrefetchEvent;
+  return (UInt_t*)(fEvStream->getEvBuffer());
+}
+
 Int_t QwEventBuffer::GetFileEvent(){
   Int_t status = CODA_OK;
   //  Try to get a new event.  If the EOF occurs,
@@ -462,7 +573,10 @@ Int_t QwEventBuffer::GetFileEvent(){
   //  next segment and read a new event; repeat
   //  if needed.
   do {
-    status = fEvStream->codaRead();
+    if (fPrefetchActive)
+      status = GetPrefetchedEvent();
+    else
+      status = fEvStream->codaRead();
     if (fChainDataFiles && status == EOF){
       CloseThisSegment();
       //  Crash out of the loop if we can't open the
@@ -718,7 +832,7 @@ Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystem
 		    fEvtType, fEvtNumber, fEvtClass)
 	    << QwLog::endl;
   //  Loop through the data buffer in this event.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
+  UInt_t *localbuff = GetEvBuffer();
   DecodeEventIDBank(localbuff);
   while ((okay = DecodeSubbankHeader(&localbuff[fWordsSoFar]))){
     //  If this bank has further subbanks, restart the loop.
@@ -756,12 +870,13 @@ Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystem
 
 Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems)
 {
+  QwProfiler::Scope profile(QwProfiler::kDecode);
   //  Initialize local flag
   Bool_t okay = kTRUE;
 
   //  Reload the data buffer and decode the header again, this allows
   //  multiple calls to this function for different subsystem arrays.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
+  UInt_t *localbuff = GetEvBuffer();
   DecodeEventIDBank(localbuff);
 
   //  Clear the old event information from the subsystems.
@@ -879,7 +994,7 @@ Bool_t QwEventBuffer::FillEPICSData(QwEPICSEvent &epics)
   QwVerbose << "QwEventBuffer::FillEPICSData:  "
 	    << QwLog::endl;
   //  Loop through the data buffer in this event.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
+  UInt_t *localbuff = GetEvBuffer();
   if (fBankDataType==0x10){
     while ((okay = DecodeSubbankHeader(&localbuff[fWordsSoFar]))){
       //  If this bank has further subbanks, restart the loop.
@@ -1206,6 +1321,8 @@ Int_t QwEventBuffer::OpenDataFile(const TString filename, const TString rw)
     exit(1);
   }
   fDataFile = filename;
+  //  Gzipped files and pipes are silently read the usual way by evio
+  static_cast<THaCodaFile*>(fEvStream)->setMemoryMapped(fMemoryMapFiles);
 
   if (rw.Contains("w",TString::kIgnoreCase)) {
     // If we open a file for write access, let's suppose
@@ -1220,15 +1337,16 @@ Int_t QwEventBuffer::OpenDataFile(const TString filename, const TString rw)
       fDataFile = fDataDirectory + filename;
       glob(fDataFile.Data(), GLOB_ERR, NULL, &globbuf);
     }
-    if (globbuf.gl_pathc == 0){
-      //  Can't find the file; try gzipped.
-      fDataFile = filename + ".gz";
-      glob(fDataFile.Data(), GLOB_ERR, NULL, &globbuf);
-    }
-    if (globbuf.gl_pathc == 0){
-      //  Can't find the file; try gzipped in the "fDataDirectory".
-      fDataFile = fDataDirectory + filename + ".gz";
+    //  Can't find the file; try compressed, here and in the "fDataDirectory".
+    //  These are decompressed on the fly by evio.
+    const char* compressed[] = {".gz", ".zst", ".lz4"};
+    for (size_t i = 0; i < 3 && globbuf.gl_pathc == 0; i++) {
+      fDataFile = filename + compressed[i];
       glob(fDataFile.Data(), GLOB_ERR, NULL, &globbuf);
+      if (globbuf.gl_pathc == 0){
+	fDataFile = fDataDirectory + filename + compressed[i];
+	glob(fDataFile.Data(), GLOB_ERR, NULL, &globbuf);
+      }
     }
     if (globbuf.gl_pathc == 1){
       QwMessage << "Opening data file:  " << fDataFile << QwLog::endl;
@@ -1240,7 +1358,14 @@ Int_t QwEventBuffer::OpenDataFile(const TString filename, const TString rw)
     }
     globfree(&globbuf);
   }
-  return fEvStream->codaOpen(fDataFile, rw);
+  //  The reader thread must not touch the stream while it is reopened
+  StopPrefetch();
+  Int_t status = fEvStream->codaOpen(fDataFile, rw);
+  if (status == CODA_OK && fPrefetchDepth > 0
+      && ! rw.Contains("w",TString::kIgnoreCase)) {
+    StartPrefetch();
+  }
+  return status;
 }
 
 
@@ -1249,11 +1374,114 @@ Int_t QwEventBuffer::CloseDataFile()
 {
   Int_t status = kFileHandleNotConfigured;
   if (fEvStreamMode==fEvStreamFile){
+    StopPrefetch();
     status = fEvStream->codaClose();
   }
   return status;
 }
 
+//------------------------------------------------------------
+void QwEventBuffer::StartPrefetch()
+{
+  StopPrefetch();
+  //  One slot more than the depth, since the analysis holds the
+  //  current event while the reader fills the others.
+  fPrefetchSlots.resize(fPrefetchDepth + 1);
+  fPrefetchHead    = 0;
+  fPrefetchTail    = 0;
+  fPrefetchFilled  = 0;
+  fPrefetchHolding = kFALSE;
+  fPrefetchStop    = kFALSE;
+  fPrefetchDone    = kFALSE;
+  fPrefetchEvent   = NULL;
+  fPrefetchActive  = kTRUE;
+  fPrefetchThread  = std::thread(&QwEventBuffer::PrefetchLoop, this);
+  QwVerbose << "Reading ahead up to " << fPrefetchDepth
+	    << " events from " << fDataFile << QwLog::endl;
+}
+
+void QwEventBuffer::StopPrefetch()
+{
+  if (fPrefetchThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fPrefetchMutex);
+      fPrefetchStop = kTRUE;
+    }
+    fPrefetchNotFull.notify_all();
+    fPrefetchThread.join();
+  }
+  fPrefetchActive = kFALSE;
+  fPrefetchEvent  = NULL;
+}
+
+void QwEventBuffer::PrefetchLoop()
+{
+  Int_t status = CODA_OK;
+  while (status == CODA_OK) {
+    //  Wait for a free slot
+    size_t slot;
+    {
+      std::unique_lock<std::mutex> lock(fPrefetchMutex);
+      fPrefetchNotFull.wait(lock, [this]{
+	  return fPrefetchStop
+	    || fPrefetchFilled + (fPrefetchHolding? 1: 0) < fPrefetchSlots.size();
+	});
+      if (fPrefetchStop) return;
+      slot = fPrefetchHead;
+    }
+    //  Read and copy the event outside of the lock; an event in the
+    //  memory mapping stays valid until the file is closed, which
+    //  only happens after this thread is stopped
+    PrefetchSlot_t& next = fPrefetchSlots[slot];
+    status = fEvStream->codaRead();
+    next.fStatus = status;
+    if (status == CODA_OK) {
+      UInt_t* buffer = (UInt_t*)(fEvStream->getEvBuffer());
+      if (static_cast<THaCodaFile*>(fEvStream)->isEvBufferMapped()) {
+	next.fEvent = buffer;
+      } else {
+	next.fBuffer.assign(buffer, buffer + buffer[0] + 1);
+	next.fEvent = &(next.fBuffer[0]);
+      }
+    } else {
+      next.fBuffer.assign(1, 0);
+      next.fEvent = &(next.fBuffer[0]);
+    }
+    //  Hand it over; after a read error or EOF the thread is done
+    {
+      std::lock_guard<std::mutex> lock(fPrefetchMutex);
+      fPrefetchHead = (fPrefetchHead + 1) % fPrefetchSlots.size();
+      fPrefetchFilled++;
+      if (status != CODA_OK) fPrefetchDone = kTRUE;
+    }
+    fPrefetchNotEmpty.notify_one();
+  }
+}
+
+Int_t QwEventBuffer::GetPrefetchedEvent()
+{
+  std::unique_lock<std::mutex> lock(fPrefetchMutex);
+  //  Release the slot of the previous event
+  if (fPrefetchHolding) {
+    fPrefetchTail = (fPrefetchTail + 1) % fPrefetchSlots.size();
+    fPrefetchHolding = kFALSE;
+    fPrefetchNotFull.notify_one();
+  }
+  fPrefetchNotEmpty.wait(lock, [this]{
+      return fPrefetchFilled > 0 || fPrefetchDone;
+    });
+  if (fPrefetchFilled == 0) {
+    //  Everything up to the end of the file has been handed out
+    fPrefetchEvent = NULL;
+    return EOF;
+  }
+  PrefetchSlot_t& current = fPrefetchSlots[fPrefetchTail];
+  fPrefetchFilled--;
+  fPrefetchHolding = kTRUE;
+  fPrefetchEvent = current.fEvent;
+  return current.fStatus;
+}
+
 //------------------------------------------------------------
 Int_t QwEventBuffer::OpenETStream(TString computer, TString session, int mode,
 				  const TString stationname)
@@ -183,11 +183,12 @@ void  QwHistogramHelper::LoadTreeParamsFromFile(const std::string& filename)
   QwParameterFile *module;
   std::vector<TString> TrimmedList;//stores the list of elements for each module
   std::vector<std::vector<TString> > ModulebyTrimmedList;//stores the list of elements for each module
+  std::vector<Char_t> LeafTypeList;//stores the leaf types of the elements for each module
+  std::vector<std::vector<Char_t> > ModulebyLeafTypeList;//stores the leaf types of the elements for each module
   std::vector<TString> ModuleList;//stores the list of modules for each subsystem
   fDEBUG = 0;
   //fDEBUG = 1;  
-  if (fTrimDisable)
-    return;
+  //  The file is read even if the trees are not trimmed, for the leaf types
   QwMessage << "Tree trim definition file for Offline Engine"<< QwLog::endl;
   QwParameterFile mapstr(filename.c_str());  //Open the file
  
@@ -195,6 +196,7 @@ void  QwHistogramHelper::LoadTreeParamsFromFile(const std::string& filename)
   fSubsystemList.clear();
   fModuleList.clear();
   fVQWKTrimmedList.clear();
+  fVQWKLeafTypes.clear();
   
   while ( (section=mapstr.ReadNextSection(subsystemname)) ){
     if (subsystemname=="DEVICELIST")//done with VQWK element trimming
@@ -204,27 +206,47 @@ void  QwHistogramHelper::LoadTreeParamsFromFile(const std::string& filename)
 
     ModuleList.clear();
     ModulebyTrimmedList.clear();
+    ModulebyLeafTypeList.clear();
     while ( (module=section->ReadNextModule(moduletype)) ){
  
       ModuleList.push_back(moduletype);
       QwMessage <<"Module found "<<moduletype<<QwLog::endl;
       TrimmedList.clear();
+      LeafTypeList.clear();
       while (module->ReadNextLine()){
 	module->TrimComment('#');   // Remove everything after a '#' character.
 	module->TrimWhitespace();   // Get rid of leading and trailing spaces.
 	if (module->LineIsEmpty())  continue;
 	devicename=(module->GetLine()).c_str();
+	//  An element can be followed by the type of its leaves in the trees,
+	//  as in a leaf list: I (Int_t), i (UInt_t), F (Float_t) or D (Double_t);
+	//  elements without a type get the default of GetElementLeafType
+	Char_t leaftype = 0;
+	Ssiz_t slash = devicename.Last('/');
+	if (slash != kNPOS) {
+	  TString suffix = devicename(slash+1, devicename.Length()-slash-1);
+	  devicename.Remove(slash);
+	  devicename = devicename.Strip(TString::kTrailing);
+	  if (suffix == "I" || suffix == "i" || suffix == "F" || suffix == "D")
+	    leaftype = suffix[0];
+	  else
+	    QwWarning << "Unknown leaf type /" << suffix << " for element " << devicename
+		      << "; it will be written with its default type" << QwLog::endl;
+	}
 	TrimmedList.push_back(devicename);
+	LeafTypeList.push_back(leaftype);
 	if (fDEBUG) {
 	QwMessage <<"data element "<<devicename<<QwLog::endl;	
 	}
       }
       ModulebyTrimmedList.push_back(TrimmedList);
+      ModulebyLeafTypeList.push_back(LeafTypeList);
 	  
 
     }
     fModuleList.push_back(ModuleList);
     fVQWKTrimmedList.push_back(ModulebyTrimmedList);
+    fVQWKLeafTypes.push_back(ModulebyLeafTypeList);
 
     
   }
@@ -367,6 +389,37 @@ Bool_t QwHistogramHelper::MatchVQWKElementFromList(
     return kFALSE;
 }
 
+Char_t QwHistogramHelper::GetElementLeafType(
+    const std::string& subsystemname,
+    const std::string& moduletype,
+    const std::string& elementname)
+{
+  //  Elements which are not typed in the tree trim file keep their default:
+  //  Int_t for the raw counts of the VQWK channels, Double_t for all others
+  Char_t leaftype = 'D';
+  if (elementname == "block_raw" || elementname == "hw_sum_raw"
+   || elementname == "num_samples" || elementname == "sequence_number")
+    leaftype = 'I';
+  if (!fTreeTrimFileLoaded)
+    return leaftype;
+
+  for (size_t j = 0; j < fSubsystemList.size(); j++) {
+    if (DoesMatch(subsystemname,fSubsystemList.at(j))){
+      for (size_t i = 0; i < fModuleList.at(j).size(); i++) {
+	if (DoesMatch(moduletype,fModuleList.at(j).at(i))) {
+	  for (size_t k = 0; k < fVQWKTrimmedList.at(j).at(i).size(); k++) {
+	    if (DoesMatch(elementname,fVQWKTrimmedList.at(j).at(i).at(k))
+	     && fVQWKLeafTypes.at(j).at(i).at(k) != 0)
+	      return fVQWKLeafTypes.at(j).at(i).at(k);
+	  }
+	  break;
+	}
+      }
+    }
+  }
+  return leaftype;
+}
+
 
 const QwHistogramHelper::HistParams QwHistogramHelper::GetHistParamsFromFile(
     const std::string& filename,
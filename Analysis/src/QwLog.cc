@@ -10,6 +10,7 @@
 
 // System headers
 #include <fstream>
+#include <sstream>
 
 // Boost headers
 #include <boost/regex.hpp>
@@ -18,13 +19,55 @@
 #include "QwColor.h"
 #include "QwOptions.h"
 
+// Set the log level and lock shared by the threads
+thread_local QwLog::QwLogLevel QwLog::fLogLevel = QwLog::kMessage;
+std::recursive_mutex QwLog::fMutex;
+
 // Create the static logger object (with streams to screen and file)
 QwLog gQwLog;
 
-// Set the static flags
-bool QwLog::fScreenAtNewLine = true;
-bool QwLog::fScreenInColor = false;
-bool QwLog::fFileAtNewLine = true;
+// Set the static flags, separately for the lines of each thread
+thread_local bool QwLog::fScreenAtNewLine = true;
+thread_local bool QwLog::fScreenInColor = false;
+thread_local bool QwLog::fFileAtNewLine = true;
+
+/*! Line buffer of a thread, which writes its content to the screen or the
+ *  log file in one piece when it is flushed (by std::endl in QwLog::endl).
+ *  What is left at the end of the thread is written by the destructor.
+ */
+class QwLog::LineBuffer : public std::stringbuf {
+  public:
+    LineBuffer(bool file): fIsFile(file) { }
+    virtual ~LineBuffer() { sync(); }
+  protected:
+    virtual int sync() {
+      std::string line = str();
+      str("");
+      std::lock_guard<std::recursive_mutex> lock(fMutex);
+      std::ostream* stream = fIsFile? gQwLog.fFile: gQwLog.fScreen;
+      if (stream) {
+        stream->write(line.data(), line.size());
+        stream->flush();
+      }
+      return 0;
+    }
+  private:
+    bool fIsFile;
+};
+
+std::ostream& QwLog::ScreenBuffer()
+{
+  static thread_local LineBuffer buffer(false);
+  static thread_local std::ostream stream(&buffer);
+  return stream;
+}
+
+std::ostream& QwLog::FileBuffer()
+{
+  static thread_local LineBuffer buffer(true);
+  static thread_local std::ostream stream(&buffer);
+  return stream;
+}
 
 // Log file open modes
 const std::ios_base::openmode QwLog::kTruncate = std::ios::trunc;
@@ -156,6 +199,7 @@ bool QwLog::IsDebugFunction(const string func_sig)
  */
 void QwLog::InitLogFile(const string name, const std::ios_base::openmode mode)
 {
+  std::lock_guard<std::recursive_mutex> lock(fMutex);
   if (fFile) {
     delete fFile;
     fFile = 0;
@@ -196,6 +240,9 @@ QwLog& QwLog::operator()(
   // Set the log level of this sink
   fLogLevel = level;
 
+  // The list of debugged functions and the time string are shared
+  std::lock_guard<std::recursive_mutex> lock(fMutex);
+
   // Override log level of this sink when in a debugged function
   if (IsDebugFunction(func_sig)) fLogLevel = QwLog::kAlways;
 
@@ -205,25 +252,25 @@ QwLog& QwLog::operator()(
       switch (level) {
       case kError:
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kRed);
+          ScreenBuffer() << QwColor(Qw::kRed);
           fScreenInColor = true;
         }
         if (fPrintFunctionSignature)
-          *(fScreen) << "Error (in " << func_sig << "): ";
+          ScreenBuffer() << "Error (in " << func_sig << "): ";
         else
-          *(fScreen) << "Error: ";
+          ScreenBuffer() << "Error: ";
         break;
       case kWarning:
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kRed);
+          ScreenBuffer() << QwColor(Qw::kRed);
           fScreenInColor = true;
         }
         if (fPrintFunctionSignature)
-          *(fScreen) << "Warning (in " << func_sig << "): ";
+          ScreenBuffer() << "Warning (in " << func_sig << "): ";
         else
-          *(fScreen) << "Warning: ";
+          ScreenBuffer() << "Warning: ";
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kNormal);
+          ScreenBuffer() << QwColor(Qw::kNormal);
           fScreenInColor = false;
         }
         break;
@@ -237,16 +284,16 @@ QwLog& QwLog::operator()(
 
   if (fFile && fLogLevel <= fFileThreshold) {
     if (fFileAtNewLine) {
-      *(fFile) << GetTime();
+      FileBuffer() << GetTime();
       switch (level) {
-      case kError:   *(fFile) << " EE"; break;
-      case kWarning: *(fFile) << " WW"; break;
-      case kMessage: *(fFile) << " MM"; break;
-      case kVerbose: *(fFile) << " VV"; break;
-      case kDebug:   *(fFile) << " DD"; break;
-      default: *(fFile) << "   "; break;
+      case kError:   FileBuffer() << " EE"; break;
+      case kWarning: FileBuffer() << " WW"; break;
+      case kMessage: FileBuffer() << " MM"; break;
+      case kVerbose: FileBuffer() << " VV"; break;
+      case kDebug:   FileBuffer() << " DD"; break;
+      default: FileBuffer() << "   "; break;
       }
-      *(fFile) << " - ";
+      FileBuffer() << " - ";
       fFileAtNewLine = false;
     }
   }
@@ -260,7 +307,7 @@ QwLog& QwLog::operator()(
 QwLog& QwLog::operator<<(std::ios_base& (*manip) (std::ios_base&))
 {
   if (fScreen && (fLogLevel <= fScreenThreshold || fLogLevel <= fFileThreshold) ) {
-    *(fScreen) << manip;
+    ScreenBuffer() << manip;
   }
 
 // The following solution leads to double calls to QwLog::endl
@@ -280,7 +327,7 @@ QwLog& QwLog::operator<<(std::ios_base& (*manip) (std::ios_base&))
 QwLog& QwLog::operator<<(std::ostream& (*manip) (std::ostream&))
 {
   if (fScreen && (fLogLevel <= fScreenThreshold || fLogLevel <= fFileThreshold) ) {
-    *(fScreen) << manip;
+    ScreenBuffer() << manip;
   }
 
 // The following solution leads to double calls to QwLog::endl
@@ -298,16 +345,17 @@ QwLog& QwLog::operator<<(std::ostream& (*manip) (std::ostream&))
  */
 std::ostream& QwLog::endl(std::ostream& strm)
 {
+  // Flushing the line buffers writes the whole line at once
   if (gQwLog.fScreen && gQwLog.fLogLevel <= gQwLog.fScreenThreshold) {
     if (fScreenInColor)
-      *(gQwLog.fScreen) << QwColor(Qw::kNormal) << std::endl;
+      ScreenBuffer() << QwColor(Qw::kNormal) << std::endl;
     else
-      *(gQwLog.fScreen) << std::endl;
+      ScreenBuffer() << std::endl;
     fScreenAtNewLine = true;
     fScreenInColor = false;
   }
   if (gQwLog.fFile && gQwLog.fLogLevel <= gQwLog.fFileThreshold) {
-    *(gQwLog.fFile) << std::endl;
+    FileBuffer() << std::endl;
     fFileAtNewLine = true;
   }
 
@@ -319,10 +367,10 @@ std::ostream& QwLog::endl(std::ostream& strm)
 std::ostream& QwLog::flush(std::ostream& strm)
 {
   if (gQwLog.fScreen) {
-    *(gQwLog.fScreen) << std::flush;
+    ScreenBuffer() << std::flush;
   }
   if (gQwLog.fFile) {
-    *(gQwLog.fFile) << std::flush;
+    FileBuffer() << std::flush;
   }
   return strm;
 }
@@ -37,6 +37,7 @@ QwOptions gQwOptions;
 #endif
 #include "QwRootFile.h"
 #include "QwHistogramHelper.h"
+#include "QwProfiler.h"
 
 // External objects
 extern const char* const gGitInfo;
@@ -87,6 +88,8 @@ void QwOptions::DefineOptions(QwOptions& options)
   QwSubsystemArray::DefineOptions(options);
   // Define histogram helper options
   QwHistogramHelper::DefineOptions(options);
+  // Define profiler options
+  QwProfiler::DefineOptions(options);
 }
 
 /**
@@ -197,6 +200,26 @@ po::options_description* QwOptions::CombineOptions()
   return options;
 }
 
+/**
+ * Split the command line arguments into options as the command line parser
+ * sees them: the original tokens of each option include its value, if the
+ * option takes one.  Positional and unknown arguments are options of their
+ * own, so no argument is lost.
+ * @return Options on the command line, in order
+ */
+std::vector<po::option> QwOptions::GetCommandLineOptions()
+{
+  std::vector<po::option> parsed;
+  po::options_description* command_line_options = CombineOptions();
+  try {
+    parsed = po::command_line_parser(fArgc, fArgv).options(*command_line_options).allow_unregistered().run().options;
+  } catch (std::exception const& e) {
+    QwWarning << e.what() << " while splitting command line arguments" << QwLog::endl;
+  }
+  delete command_line_options;
+  return parsed;
+}
+
 /**
  * Parse the command line arguments for options and warn when encountering
  * an unknown option, then notify the variables map.  Print usage instructions
@@ -0,0 +1,167 @@
+/**
+ *  \file   QwProfiler.cc
+ *  \brief  Cumulative timing of the stages of the event loop
+ */
+
+#include "QwProfiler.h"
+
+// System headers
+#include <chrono>
+
+// ROOT headers
+#include "TH1D.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptions.h"
+#include "QwSubsystemArray.h"
+
+// Globally defined instance of the profiler
+QwProfiler gQwProfiler;
+
+const char* const QwProfiler::fStageName[QwProfiler::kNumberOfStages] = {
+  "read", "decode", "process", "eventcuts", "ring", "pattern",
+  "datahandlers", "histograms", "trees"
+};
+
+QwProfiler::QwProfiler()
+: fWriteProfile(kFALSE)
+{
+  Reset();
+}
+
+void QwProfiler::DefineOptions(QwOptions &options)
+{
+  options.AddOptions()("write-profile",
+      po::value<bool>()->default_bool_value(false),
+      "write the timing of the stages of the event loop to the ROOT file");
+}
+
+void QwProfiler::ProcessOptions(QwOptions &options)
+{
+  fWriteProfile = options.GetValue<bool>("write-profile");
+}
+
+ULong64_t QwProfiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void QwProfiler::Reset()
+{
+  for (Int_t i = 0; i < kNumberOfStages; i++) {
+    fTime[i] = 0;
+    fCalls[i] = 0;
+  }
+  fRingCopies = 0;
+  fRingBytes = 0;
+  std::lock_guard<std::mutex> lock(fMutex);
+  fSubsystemTimes.clear();
+  fTreeBytes.clear();
+  fStart = Now();
+}
+
+void QwProfiler::AddTreeBytes(const std::string& name, Long64_t bytes, Long64_t zipbytes)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fTreeBytes[name].first  += bytes;
+  fTreeBytes[name].second += zipbytes;
+}
+
+void QwProfiler::CollectSubsystemTimes(const QwSubsystemArray& subsystems)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (size_t i = 0; i < subsystems.size(); i++) {
+    SubsystemTime_t& times = fSubsystemTimes[subsystems.at(i)->GetSubsystemName().Data()];
+    times.fDecode  += subsystems.GetDecodeTime(i);
+    times.fProcess += subsystems.GetProcessTime(i);
+  }
+}
+
+void QwProfiler::Print() const
+{
+  Double_t real = (Now() - fStart) * 1e-9;
+  ULong64_t nevents = fCalls[kProcess];
+  QwMessage << "Time per stage of the event loop (" << nevents << " events in "
+            << real << " s, " << (real > 0? nevents / real: 0) << " events/s):"
+            << QwLog::endl;
+  for (Int_t i = 0; i < kNumberOfStages; i++) {
+    if (fCalls[i] == 0) continue;
+    Double_t time = fTime[i] * 1e-9;
+    QwMessage << Form("  %-14s %10.3f s %8.3f us/call %12llu calls",
+                      fStageName[i], time, 1e6 * time / fCalls[i],
+                      (unsigned long long) fCalls[i].load())
+              << QwLog::endl;
+  }
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (! fSubsystemTimes.empty()) {
+    QwMessage << "Time per subsystem (decode, process):" << QwLog::endl;
+    std::map<std::string, SubsystemTime_t>::const_iterator subsys;
+    for (subsys = fSubsystemTimes.begin(); subsys != fSubsystemTimes.end(); ++subsys)
+      QwMessage << Form("  %-24s %10.3f s %10.3f s", subsys->first.c_str(),
+                        subsys->second.fDecode * 1e-9, subsys->second.fProcess * 1e-9)
+                << QwLog::endl;
+  }
+  if (fRingCopies > 0) {
+    QwMessage << "Event ring: " << fRingCopies << " copies";
+    if (fRingBytes > 0)
+      QwMessage << ", " << fRingBytes / fRingCopies << " bytes per compact copy";
+    QwMessage << QwLog::endl;
+  }
+  if (! fTreeBytes.empty()) {
+    QwMessage << "Bytes per tree (filled, written):" << QwLog::endl;
+    std::map<std::string, std::pair<Long64_t, Long64_t> >::const_iterator tree;
+    for (tree = fTreeBytes.begin(); tree != fTreeBytes.end(); ++tree)
+      QwMessage << Form("  %-24s %14lld %14lld", tree->first.c_str(),
+                        tree->second.first, tree->second.second)
+                << QwLog::endl;
+  }
+}
+
+void QwProfiler::Write() const
+{
+  if (! fWriteProfile) return;
+
+  TH1D stages("profile_stages", "Time per stage of the event loop;;time [s]",
+              kNumberOfStages, 0, kNumberOfStages);
+  TH1D calls("profile_calls", "Calls per stage of the event loop;;calls",
+             kNumberOfStages, 0, kNumberOfStages);
+  for (Int_t i = 0; i < kNumberOfStages; i++) {
+    stages.GetXaxis()->SetBinLabel(i + 1, fStageName[i]);
+    stages.SetBinContent(i + 1, fTime[i] * 1e-9);
+    calls.GetXaxis()->SetBinLabel(i + 1, fStageName[i]);
+    calls.SetBinContent(i + 1, fCalls[i]);
+  }
+  stages.Write();
+  calls.Write();
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  Int_t n = fSubsystemTimes.size();
+  if (n > 0) {
+    TH1D decode("profile_decode", "Decode time per subsystem;;time [s]", n, 0, n);
+    TH1D process("profile_process", "Process time per subsystem;;time [s]", n, 0, n);
+    Int_t bin = 1;
+    std::map<std::string, SubsystemTime_t>::const_iterator subsys;
+    for (subsys = fSubsystemTimes.begin(); subsys != fSubsystemTimes.end(); ++subsys, ++bin) {
+      decode.GetXaxis()->SetBinLabel(bin, subsys->first.c_str());
+      decode.SetBinContent(bin, subsys->second.fDecode * 1e-9);
+      process.GetXaxis()->SetBinLabel(bin, subsys->first.c_str());
+      process.SetBinContent(bin, subsys->second.fProcess * 1e-9);
+    }
+    decode.Write();
+    process.Write();
+  }
+  n = fTreeBytes.size();
+  if (n > 0) {
+    TH1D bytes("profile_tree_bytes", "Bytes written per tree;;bytes", n, 0, n);
+    Int_t bin = 1;
+    std::map<std::string, std::pair<Long64_t, Long64_t> >::const_iterator tree;
+    for (tree = fTreeBytes.begin(); tree != fTreeBytes.end(); ++tree, ++bin) {
+      bytes.GetXaxis()->SetBinLabel(bin, tree->first.c_str());
+      bytes.SetBinContent(bin, tree->second.second);
+    }
+    bytes.Write();
+  }
+}
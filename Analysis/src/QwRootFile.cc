@@ -1,9 +1,14 @@
 #include "QwRootFile.h"
+#include "QwRootNTuple.h"
 #include "QwRunCondition.h"
 #include "TH1.h"
+#include "TKey.h"
+#include "TROOT.h"
 
 #include <unistd.h>
 #include <cstdio>
+#include <cstdlib>
+#include <sstream>
 
 std::string QwRootFile::fDefaultRootFileStem = "Qweak_";
 
@@ -16,7 +21,8 @@ const Int_t QwRootFile::kMaxMapFileSize = 0x3fffffff; // 1 GiB
 QwRootFile::QwRootFile(const TString& run_label)
   : fRootFile(0), fMakePermanent(0),
     fMapFile(0), fEnableMapFile(kFALSE),
-    fUpdateInterval(-1)
+    fUpdateInterval(-1),
+    fWriter(0), fWriteNTuple(kFALSE)
 {
   // Process the configuration options
   ProcessOptions(gQwOptions);
@@ -105,6 +111,20 @@ QwRootFile::QwRootFile(const TString& run_label)
     }
 
     fRootFile->SetCompressionLevel(fCompressionLevel);
+
+    // Writer thread filling the trees
+    if (fWriteAsync) {
+      #if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+      ROOT::EnableThreadSafety();
+      #ifdef R__USE_IMT
+      if (fWriteThreads > 0 && ! ROOT::IsImplicitMTEnabled())
+        ROOT::EnableImplicitMT(fWriteThreads);
+      #endif
+      #endif
+      fWriter = new QwRootTreeWriter(fWriteQueueSize);
+      QwMessage << "Trees are filled by a writer thread, with a queue of "
+                << fWriteQueueSize << " entries" << QwLog::endl;
+    }
   }
 }
 
@@ -114,10 +134,21 @@ QwRootFile::QwRootFile(const TString& run_label)
  */
 QwRootFile::~QwRootFile()
 {
+  // Fill the queued entries and stop the writer thread
+  if (fWriter) {
+    fWriter->Wait();
+    fWriter->PrintSummary();
+    delete fWriter;
+    fWriter = 0;
+  }
+
   // Keep the file on disk if any trees or histograms have been filled.
   // Also respect any other requests to keep the file around.
   if (!fMakePermanent) fMakePermanent = HasAnyFilled();
 
+  // Write the RNTuples before the file is closed
+  CloseNTuples();
+
   // Close the map file
   if (fMapFile) {
     fMapFile->Close();
@@ -161,6 +192,9 @@ QwRootFile::~QwRootFile()
       delete *vec_iter;
     }
   }
+  // Delete the trees which were only used to describe the RNTuples
+  for (size_t i = 0; i < fDetachedTrees.size(); i++)
+    delete fDetachedTrees[i];
 }
 
 /**
@@ -201,6 +235,11 @@ void QwRootFile::DefineOptions(QwOptions &options)
     ("disable-slow-tree", po::value<bool>()->default_bool_value(false),
      "disable slow control tree");
 
+  // Define the output format of the trees
+  options.AddOptions("ROOT output options")
+    ("tree-format", po::value<std::string>()->default_value("ttree"),
+     "format of the output trees: ttree or rntuple (columnar, ROOT 6.36)");
+
   // Define the tree output prescaling options
   options.AddOptions("ROOT output options")
     ("num-mps-accepted-events", po::value<int>()->default_value(0),
@@ -234,6 +273,22 @@ void QwRootFile::DefineOptions(QwOptions &options)
   options.AddOptions("ROOT performance options")
     ("compression-level", po::value<int>()->default_value(1),
      "TFile compression level");
+  options.AddOptions("ROOT performance options")
+    ("tree-profile", po::value< std::vector<std::string> >()->composing(),
+     "compression and basket settings of the trees matching a regex, e.g.\n"
+     "'evt algorithm=lz4 level=4 basket-size=64000 autoflush=-30000000'\n"
+     "(algorithm zlib, lzma, lz4 or zstd; unset values are the global ones)");
+
+  // Define the asynchronous tree output options
+  options.AddOptions("ROOT performance options")
+    ("write-async", po::value<bool>()->default_bool_value(false),
+     "fill the trees in a writer thread");
+  options.AddOptions("ROOT performance options")
+    ("write-queue-size", po::value<int>()->default_value(1000),
+     "entries queued for the writer thread before the event loop waits");
+  options.AddOptions("ROOT performance options")
+    ("write-threads", po::value<int>()->default_value(0),
+     "threads compressing the baskets (ROOT implicit multithreading)");
 }
 
 
@@ -284,14 +339,295 @@ void QwRootFile::ProcessOptions(QwOptions &options)
               << QwLog::endl;
   }
   fAutoSave  = options.GetValue<int>("autosave");
+
+  // Compression and basket settings by tree
+  fTreeProfiles.clear();
+  std::vector<std::string> profiles = options.GetValueVector<std::string>("tree-profile");
+  for (size_t i = 0; i < profiles.size(); i++)
+    AddTreeProfile(profiles[i]);
+
+  // Asynchronous tree output, not for the memory-mapped file
+  fWriteAsync = options.GetValue<bool>("write-async");
+  fWriteQueueSize = options.GetValue<int>("write-queue-size");
+  fWriteThreads = options.GetValue<int>("write-threads");
+  if (fWriteAsync && fEnableMapFile) {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "The 'write-async' flag is not supported for the memory-mapped file"
+              << QwLog::endl;
+    fWriteAsync = kFALSE;
+  }
+
+  // Output format of the trees, not for the memory-mapped file
+  std::string format = options.GetValue<std::string>("tree-format");
+  fWriteNTuple = (format == "rntuple");
+  if (format != "ttree" && format != "rntuple") {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "Unknown tree format " << format << ", trees are written as TTree"
+              << QwLog::endl;
+  }
+  #ifndef __ROOT_HAS_RNTUPLE
+  if (fWriteNTuple) {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "The 'rntuple' tree format is not supported by ROOT version "
+              << ROOT_RELEASE << " or this build"
+              << QwLog::endl;
+    fWriteNTuple = kFALSE;
+  }
+  #endif
+  if (fWriteNTuple && fEnableMapFile) {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "The 'rntuple' tree format is not supported for the memory-mapped file"
+              << QwLog::endl;
+    fWriteNTuple = kFALSE;
+  }
   return;
 }
 
+
+/**
+ * Add the profile of the trees matching a regex, from a tree-profile option
+ * of the form "<regex> algorithm=<name> level=<n> basket-size=<bytes>
+ * autoflush=<n> autosave=<n>", in which every setting is optional.
+ * @param profile Value of the option
+ */
+void QwRootFile::AddTreeProfile(const std::string& profile)
+{
+  std::istringstream stream(profile);
+  std::string name, setting;
+  if (! (stream >> name)) return;
+
+  TreeProfile_t tmp = { TPRegexp(name), -1, -1, fBasketSize, fAutoFlush, fAutoSave };
+  while (stream >> setting) {
+    size_t equal = setting.find('=');
+    std::string key = setting.substr(0, equal);
+    std::string value = (equal == std::string::npos)? "": setting.substr(equal + 1);
+    if (key == "algorithm") {
+      // Algorithms as numbered by ROOT (ROOT::RCompressionSetting::EAlgorithm)
+      if      (value == "zlib") tmp.fAlgorithm = 1;
+      else if (value == "lzma") tmp.fAlgorithm = 2;
+      else if (value == "lz4")  tmp.fAlgorithm = 4;
+      else if (value == "zstd") tmp.fAlgorithm = 5;
+      else {
+        QwWarning << "QwRootFile::AddTreeProfile:  Unknown compression algorithm "
+                  << value << " for trees " << name << QwLog::endl;
+      }
+      #if ROOT_VERSION_CODE < ROOT_VERSION(6,20,0)
+      if (tmp.fAlgorithm == 5) {
+        QwWarning << "QwRootFile::AddTreeProfile:  "
+                  << "ZSTD compression is not supported by ROOT version " << ROOT_RELEASE
+                  << ", trees " << name << " use the algorithm of the file" << QwLog::endl;
+        tmp.fAlgorithm = -1;
+      }
+      #endif
+    } else if (key == "level") {
+      tmp.fLevel = atoi(value.c_str());
+    } else if (key == "basket-size") {
+      tmp.fBasketSize = atoi(value.c_str());
+    } else if (key == "autoflush") {
+      tmp.fAutoFlush = atoll(value.c_str());
+    } else if (key == "autosave") {
+      tmp.fAutoSave = atoll(value.c_str());
+    } else {
+      QwWarning << "QwRootFile::AddTreeProfile:  Unknown setting " << setting
+                << " for trees " << name << QwLog::endl;
+    }
+  }
+  fTreeProfiles.push_back(tmp);
+}
+
+
+/**
+ * Apply the first profile matching the tree name, or else the global
+ * basket size, autoflush and autosave and the compression of the file.
+ * @param name Name of the tree
+ * @param tree New tree object
+ */
+void QwRootFile::ApplyTreeProfile(const std::string& name, QwRootTree* tree)
+{
+  for (size_t i = 0; i < fTreeProfiles.size(); i++) {
+    TreeProfile_t& profile = fTreeProfiles.at(i);
+    if (! profile.fName.Match(name)) continue;
+
+    #if ROOT_VERSION_CODE >= ROOT_VERSION(5,26,00)
+    tree->SetAutoFlush(profile.fAutoFlush);
+    #endif
+    tree->SetAutoSave(profile.fAutoSave);
+    tree->SetBasketSize(profile.fBasketSize);
+
+    // Only change the compression if the profile sets it
+    if (profile.fAlgorithm >= 0 || profile.fLevel >= 0) {
+      Int_t algorithm = profile.fAlgorithm;
+      if (algorithm < 0 && fRootFile) algorithm = fRootFile->GetCompressionAlgorithm();
+      if (algorithm < 0) algorithm = 0;
+      Int_t level = (profile.fLevel >= 0)? profile.fLevel: fCompressionLevel;
+      tree->SetCompressionSettings(100 * algorithm + level);
+    }
+    QwMessage << "Tree " << name << ": compression " << tree->fCompressionSettings
+              << ", basket size " << profile.fBasketSize
+              << ", autoflush " << profile.fAutoFlush
+              << ", autosave " << profile.fAutoSave << QwLog::endl;
+    return;
+  }
+
+  #if ROOT_VERSION_CODE >= ROOT_VERSION(5,26,00)
+  tree->SetAutoFlush(fAutoFlush);
+  #endif
+  tree->SetAutoSave(fAutoSave);
+  tree->SetBasketSize(fBasketSize);
+}
+
+
+/**
+ * Add a tree object to the list of trees by name.  The first tree object
+ * with a name is registered with the writer thread, which fills the tree
+ * from the branch vectors of all tree objects with this name.
+ * @param name Name of the tree
+ * @param tree Tree object
+ */
+void QwRootFile::AddTree(const std::string& name, QwRootTree* tree)
+{
+  std::vector<QwRootTree*>& trees = fTreeByName[name];
+  trees.push_back(tree);
+  if (! fWriter) return;
+
+  tree->EnableAsync();
+  if (trees.size() == 1) {
+    // Map elements do not move, so the writer thread can keep the list
+    std::vector<QwRootTree*>* list = &trees;
+    tree->fWriterTarget = fWriter->AddTarget(
+        [list](const Double_t* data) { return FillTreeEntry(*list, data); });
+  }
+}
+
+
+/**
+ * Fill a tree, or with the writer thread, pack the branch vectors of all
+ * tree objects sharing the tree, and the entries of the indexed trees, in
+ * one entry and queue it.  The number of bytes written is only returned
+ * when the tree is filled here.
+ * @param trees Tree objects sharing the tree
+ */
+Int_t QwRootFile::FillTree(std::vector<QwRootTree*>& trees)
+{
+  QwRootTree* tree = trees.front();
+  if (fWriteNTuple && ! tree->fNTuple) ConstructNTuple(tree);
+  if (! tree->NextEvent()) return 0;
+  if (! fWriter) {
+    tree->UpdateIndices();
+    return FillTreeEntry(trees);
+  }
+
+  for (size_t i = 0; i < trees.size(); i++)
+    trees[i]->PackEntry(fWriterBuffer);
+  tree->PackIndices(fWriterBuffer);
+  fWriter->Push(tree->fWriterTarget, fWriterBuffer);
+  return 0;
+}
+
+
+/**
+ * Fill a tree from an entry packed by FillTree, on the writer thread
+ * @param trees Tree objects sharing the tree
+ * @param data Packed entry
+ */
+Int_t QwRootFile::FillTreeEntry(std::vector<QwRootTree*>& trees, const Double_t* data)
+{
+  for (size_t i = 0; i < trees.size(); i++)
+    data = trees[i]->UnpackEntry(data);
+  trees.front()->UnpackIndices(data);
+  return FillTreeEntry(trees);
+}
+
+
+/**
+ * Fill a tree from the current branch vectors, after converting the values
+ * of the typed leaves of all tree objects sharing the tree
+ * @param trees Tree objects sharing the tree
+ */
+Int_t QwRootFile::FillTreeEntry(std::vector<QwRootTree*>& trees)
+{
+  for (size_t i = 0; i < trees.size(); i++)
+    trees[i]->FillTypedLeaves();
+  QwRootTree* tree = trees.front();
+  #ifdef __ROOT_HAS_RNTUPLE
+  if (tree->fNTuple && tree->fNTuple->IsValid()) {
+    Int_t retval = tree->fNTuple->Fill();
+    tree->fFilledBytes += retval;
+    return retval;
+  }
+  #endif
+  return tree->FillEntry();
+}
+
+
+/**
+ * Create the RNTuple of a tree when it is first filled, so that the branches
+ * of all tree objects sharing the tree are constructed.  If the RNTuple can
+ * not be created, the tree is written instead.
+ * @param tree First tree object of the tree
+ */
+void QwRootFile::ConstructNTuple(QwRootTree* tree)
+{
+  #ifdef __ROOT_HAS_RNTUPLE
+  WaitForWriter();
+  Int_t compression = tree->fCompressionSettings;
+  if (compression < 0) compression = fRootFile->GetCompressionSettings();
+  tree->fNTuple = new QwRootNTuple(tree->fTree, fRootFile, compression);
+  if (tree->fNTuple->IsValid()) {
+    // The tree only describes the branches now, and is not written
+    tree->fTree->SetDirectory(0);
+    fDetachedTrees.push_back(tree->fTree);
+  }
+  #endif
+}
+
+
+/**
+ * Create the RNTuples of the trees which were not filled yet, so that they
+ * are not written to the file as empty TTrees among the RNTuples
+ */
+void QwRootFile::ConstructNTuples()
+{
+  std::map< const std::string, std::vector<QwRootTree*> >::iterator iter;
+  for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+    QwRootTree* tree = iter->second.front();
+    if (! tree->fNTuple) ConstructNTuple(tree);
+  }
+}
+
+
+/**
+ * Write the RNTuples to the file; no RNTuples are created afterwards
+ */
+void QwRootFile::CloseNTuples()
+{
+  #ifdef __ROOT_HAS_RNTUPLE
+  if (fWriteNTuple) ConstructNTuples();
+  std::map< const std::string, std::vector<QwRootTree*> >::iterator iter;
+  for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+    QwRootTree* tree = iter->second.front();
+    delete tree->fNTuple;
+    tree->fNTuple = 0;
+  }
+  #endif
+  fWriteNTuple = kFALSE;
+}
+
 /**
  * Determine whether the rootfile object has any non-empty trees or
  * histograms.
  */
 Bool_t QwRootFile::HasAnyFilled(void) {
+  #ifdef __ROOT_HAS_RNTUPLE
+  // RNTuples are only in the file once they are closed
+  std::map< const std::string, std::vector<QwRootTree*> >::const_iterator iter;
+  for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+    const QwRootTree* tree = iter->second.front();
+    //  The EPICS tree doesn't count
+    if (TString(iter->first).Contains("slow")) continue;
+    if (tree->fNTuple && tree->fNTuple->GetEntries() > 0) return true;
+  }
+  #endif
   return this->HasAnyFilled(fRootFile);
 }
 Bool_t QwRootFile::HasAnyFilled(TDirectory* d) {
@@ -300,6 +636,8 @@ Bool_t QwRootFile::HasAnyFilled(TDirectory* d) {
 
   for( int i=0; i < l->GetEntries(); ++i) {
     const char* name = l->At(i)->GetName();
+    // RNTuples are not TObjects; they are counted before they are written
+    if (TString(static_cast<TKey*>(l->At(i))->GetClassName()).Contains("RNTuple")) continue;
     TObject* obj = d->FindObjectAny(name);
 
     // Objects which can't be found don't count.
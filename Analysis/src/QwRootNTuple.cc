@@ -0,0 +1,163 @@
+/**
+ *  \file   QwRootNTuple.cc
+ *  \brief  RNTuple output with the layout of the branches of a ROOT tree
+ */
+
+#include "QwRootNTuple.h"
+
+#ifdef __ROOT_HAS_RNTUPLE
+
+// System headers
+#include <cstring>
+
+// ROOT headers
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TDirectory.h"
+#include <ROOT/RError.hxx>
+#include <ROOT/RField.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleWriteOptions.hxx>
+
+// Qweak headers
+#include "QwLog.h"
+
+QwRootNTuple::QwRootNTuple(TTree* tree, TDirectory* dir, Int_t compression)
+: fEntries(0)
+{
+  auto model = ROOT::RNTupleModel::CreateBare();
+
+  // Fields bound to the leaves, and records with their offsets
+  std::vector< std::pair<std::string, const char*> > bound;
+  std::vector< std::pair<std::string, size_t> > records;
+  size_t size = 0;
+
+  TObjArray* branches = tree->GetListOfBranches();
+  for (Int_t b = 0; b < branches->GetEntriesFast(); b++) {
+    TBranch* branch = static_cast<TBranch*>(branches->At(b));
+    std::string name = branch->GetName();
+    TObjArray* leaves = branch->GetListOfLeaves();
+    if (branch->IsA() != TBranch::Class() || branch->GetAddress() == 0
+     || leaves->GetEntriesFast() == 0) {
+      QwWarning << "Branch " << name << " of " << tree->GetName()
+                << " is not a leaf list, and is not written to the RNTuple"
+                << QwLog::endl;
+      continue;
+    }
+
+    try {
+      // A single leaf with the name of the branch is a plain field
+      TLeaf* first = static_cast<TLeaf*>(leaves->At(0));
+      if (leaves->GetEntriesFast() == 1 && name == first->GetName()) {
+        std::string type = GetFieldType(first->GetTypeName(), first->GetLenStatic());
+        if (type.empty()) {
+          QwWarning << "Leaf type " << first->GetTypeName() << " of " << name
+                    << " is not supported in the RNTuple" << QwLog::endl;
+          continue;
+        }
+        model->AddField(ROOT::RFieldBase::Create(name, type).Unwrap());
+        bound.push_back(std::make_pair(name, branch->GetAddress() + first->GetOffset()));
+        continue;
+      }
+
+      // Otherwise a record, laid out as RRecordField does
+      std::vector< std::unique_ptr<ROOT::RFieldBase> > items;
+      std::vector<Copy_t> copies;
+      size_t offset = 0;
+      for (Int_t l = 0; l < leaves->GetEntriesFast(); l++) {
+        TLeaf* leaf = static_cast<TLeaf*>(leaves->At(l));
+        std::string type = GetFieldType(leaf->GetTypeName(), leaf->GetLenStatic());
+        if (type.empty()) {
+          QwWarning << "Leaf type " << leaf->GetTypeName() << " of " << name << "."
+                    << leaf->GetName() << " is not supported in the RNTuple" << QwLog::endl;
+          items.clear();
+          break;
+        }
+        std::unique_ptr<ROOT::RFieldBase> item = ROOT::RFieldBase::Create(leaf->GetName(), type).Unwrap();
+        size_t alignment = item->GetAlignment();
+        offset += (alignment - offset % alignment) % alignment;
+        Copy_t copy = { branch->GetAddress() + leaf->GetOffset(), offset, item->GetValueSize() };
+        copies.push_back(copy);
+        offset += item->GetValueSize();
+        items.push_back(std::move(item));
+      }
+      if (items.empty()) continue;
+
+      std::unique_ptr<ROOT::RRecordField> record(new ROOT::RRecordField(name, std::move(items)));
+      // Records start on a double, the largest alignment of their items
+      size_t start = (size + sizeof(Double_t) - 1) / sizeof(Double_t) * sizeof(Double_t);
+      for (size_t i = 0; i < copies.size(); i++) {
+        copies[i].fTo += start;
+        fCopies.push_back(copies[i]);
+      }
+      size = start + record->GetValueSize();
+      records.push_back(std::make_pair(name, start));
+      model->AddField(std::move(record));
+
+    } catch (const ROOT::RException& e) {
+      QwWarning << "Branch " << name << " of " << tree->GetName()
+                << " is not written to the RNTuple: " << e.what() << QwLog::endl;
+    }
+  }
+  fRecords.assign((size + sizeof(Double_t) - 1) / sizeof(Double_t), 0.0);
+
+  // Create the RNTuple in the directory, with the compression of the file
+  try {
+    ROOT::RNTupleWriteOptions options;
+    options.SetCompression(compression);
+    fWriter = ROOT::RNTupleWriter::Append(std::move(model), tree->GetName(), *dir, options);
+  } catch (const ROOT::RException& e) {
+    QwError << "RNTuple " << tree->GetName() << " could not be created: "
+            << e.what() << QwLog::endl;
+    return;
+  }
+
+  fEntry = fWriter->CreateEntry();
+  char* base = reinterpret_cast<char*>(fRecords.data());
+  for (size_t i = 0; i < bound.size(); i++)
+    fEntry->BindRawPtr(bound[i].first, const_cast<char*>(bound[i].second));
+  for (size_t i = 0; i < records.size(); i++)
+    fEntry->BindRawPtr(records[i].first, base + records[i].second);
+
+  QwMessage << "RNTuple " << tree->GetName() << " with " << bound.size() + records.size()
+            << " fields" << QwLog::endl;
+}
+
+QwRootNTuple::~QwRootNTuple()
+{
+  // The entry has to go first; the writer commits the RNTuple to the file
+  fEntry.reset();
+  fWriter.reset();
+}
+
+Int_t QwRootNTuple::Fill()
+{
+  // Copy the leaves of the leaf lists into their records
+  char* base = reinterpret_cast<char*>(fRecords.data());
+  for (size_t i = 0; i < fCopies.size(); i++)
+    std::memcpy(base + fCopies[i].fTo, fCopies[i].fFrom, fCopies[i].fSize);
+  fEntries++;
+  return fWriter->Fill(*fEntry);
+}
+
+std::string QwRootNTuple::GetFieldType(const std::string& leaftype, Int_t length)
+{
+  std::string type;
+  if      (leaftype == "Double_t")  type = "double";
+  else if (leaftype == "Float_t")   type = "float";
+  else if (leaftype == "Int_t")     type = "std::int32_t";
+  else if (leaftype == "UInt_t")    type = "std::uint32_t";
+  else if (leaftype == "Short_t")   type = "std::int16_t";
+  else if (leaftype == "UShort_t")  type = "std::uint16_t";
+  else if (leaftype == "Long64_t")  type = "std::int64_t";
+  else if (leaftype == "ULong64_t") type = "std::uint64_t";
+  else if (leaftype == "Bool_t")    type = "bool";
+  else return "";
+  // Fixed size arrays of leaves
+  if (length > 1)
+    type = "std::array<" + type + "," + std::to_string(length) + ">";
+  return type;
+}
+
+#endif // __ROOT_HAS_RNTUPLE
@@ -0,0 +1,102 @@
+/**
+ *  \file   QwRootTreeWriter.cc
+ *  \brief  Background thread filling ROOT trees from a bounded queue
+ */
+
+#include "QwRootTreeWriter.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwProfiler.h"
+
+QwRootTreeWriter::QwRootTreeWriter(size_t capacity)
+: fCapacity(capacity > 0? capacity: 1),
+  fBusy(kFALSE),
+  fStop(kFALSE),
+  fEntries(0),
+  fBlocked(0),
+  fWaitTime(0)
+{
+  fThread = std::thread(&QwRootTreeWriter::Loop, this);
+}
+
+QwRootTreeWriter::~QwRootTreeWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  //  The thread fills the remaining entries before it returns
+  fNotEmpty.notify_one();
+  fThread.join();
+}
+
+Int_t QwRootTreeWriter::AddTarget(const Fill_t& fill)
+{
+  Wait();
+  std::lock_guard<std::mutex> lock(fMutex);
+  fTargets.push_back(fill);
+  return fTargets.size() - 1;
+}
+
+void QwRootTreeWriter::Push(Int_t target, std::vector<Double_t>& buffer)
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  if (fQueue.size() >= fCapacity) {
+    ULong64_t start = QwProfiler::Now();
+    fNotFull.wait(lock, [this]{ return fQueue.size() < fCapacity; });
+    fBlocked++;
+    fWaitTime += QwProfiler::Now() - start;
+  }
+  fQueue.push_back(Entry_t());
+  fQueue.back().fTarget = target;
+  fQueue.back().fValues.swap(buffer);
+  //  Hand back a recycled buffer, so that the caller can fill it again
+  if (! fSpare.empty()) {
+    buffer.swap(fSpare.back());
+    fSpare.pop_back();
+  }
+  buffer.clear();
+  fEntries++;
+  lock.unlock();
+  fNotEmpty.notify_one();
+}
+
+void QwRootTreeWriter::Wait()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  fIdle.wait(lock, [this]{ return fQueue.empty() && ! fBusy; });
+}
+
+void QwRootTreeWriter::PrintSummary() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  QwMessage << "Asynchronous tree writer: " << fEntries << " entries, "
+            << fBlocked << " times the queue of " << fCapacity << " was full, "
+            << fWaitTime * 1e-9 << " s waited" << QwLog::endl;
+}
+
+void QwRootTreeWriter::Loop()
+{
+  Entry_t entry;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      //  Recycle the buffer of the previous entry
+      if (entry.fValues.capacity() > 0) {
+        fSpare.push_back(std::vector<Double_t>());
+        fSpare.back().swap(entry.fValues);
+      }
+      fBusy = kFALSE;
+      if (fQueue.empty()) fIdle.notify_all();
+      fNotEmpty.wait(lock, [this]{ return fStop || ! fQueue.empty(); });
+      if (fQueue.empty()) return;
+      entry.fTarget = fQueue.front().fTarget;
+      entry.fValues.swap(fQueue.front().fValues);
+      fQueue.pop_front();
+      fBusy = kTRUE;
+    }
+    fNotFull.notify_one();
+    fTargets[entry.fTarget](entry.fValues.data());
+  }
+}
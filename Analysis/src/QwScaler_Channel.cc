@@ -263,17 +263,23 @@ void QwScaler_Channel<data_mask,data_shift>::ConstructBranchAndVector(TTree *tre
     TString basename = prefix + GetElementName();
     fTreeArrayIndex  = values.size();
 
+    //  Leaf types from the tree trim file or their defaults; QwRootTree
+    //  converts the values of the vector to these types when filled
+    auto LeafType = [this](const char* element) {
+      return TString("/") + gQwHists.GetElementLeafType(GetSubsystemName().Data(), GetModuleType().Data(), element);
+    };
+
     TString list;
     values.push_back(0.0);
-    list = "value/D";
+    list = "value"+LeafType("value");
     values.push_back(0.0);
-    list += ":Device_Error_Code/D";
+    list += ":Device_Error_Code"+LeafType("Device_Error_Code");
     if(fDataToSave==kRaw){
       values.push_back(0.0);
-      list += ":raw/D";
+      list += ":raw"+LeafType("raw");
       if ((~data_mask) != 0){
 	values.push_back(0.0);
-	list += ":header/D"; 
+	list += ":header"+LeafType("header"); 
       }
     }
 
@@ -407,6 +413,32 @@ VQwScaler_Channel& VQwScaler_Channel::operator=(const VQwScaler_Channel &value)
   return *this;
 }
 
+void VQwScaler_Channel::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (!IsNameEmpty()) {
+    buffer.push_back(fGoodEventCount);
+    buffer.push_back(fErrorFlag);
+    buffer.push_back(fHeader);
+    buffer.push_back(fValue_Raw);
+    buffer.push_back(fValue);
+    buffer.push_back(fValueError);
+    buffer.push_back(fValueM2);
+  }
+}
+
+void VQwScaler_Channel::UnpackEventData(const Double_t*& data)
+{
+  if (!IsNameEmpty()) {
+    fGoodEventCount = Int_t(*data++);
+    fErrorFlag      = UInt_t(*data++);
+    fHeader     = UInt_t(*data++);
+    fValue_Raw  = UInt_t(*data++);
+    fValue      = *data++;
+    fValueError = *data++;
+    fValueM2    = *data++;
+  }
+}
+
 void VQwScaler_Channel::AssignScaledValue(const VQwScaler_Channel &value,
 				    Double_t scale)
 {
@@ -677,6 +709,12 @@ void VQwScaler_Channel::IncrementErrorCounters()
   }
 }
 
+void VQwScaler_Channel::MergeErrorCounters(const VQwScaler_Channel& source)
+{
+  fNumEvtsWithHWErrors += source.fNumEvtsWithHWErrors;
+  fNumEvtsWithEventCutsRejected += source.fNumEvtsWithEventCutsRejected;
+}
+
 
 void VQwScaler_Channel::AccumulateRunningSum(const VQwScaler_Channel& value, Int_t count)
 {
@@ -684,8 +722,9 @@ void VQwScaler_Channel::AccumulateRunningSum(const VQwScaler_Channel& value, Int
   Int_t n1 = fGoodEventCount;
   Int_t n2 = count;
 
-  // If there are no good events, check whether device HW is good
-  if (n2 == 0 && value.fErrorFlag == 0) {
+  // If there are no good events, check whether device HW is good;
+  // a merged running sum without good events adds nothing
+  if (n2 == 0 && value.fErrorFlag == 0 && ! fMergingRunningSums) {
     n2 = 1;
   }
   Int_t n = n1 + n2;
@@ -706,7 +745,7 @@ void VQwScaler_Channel::AccumulateRunningSum(const VQwScaler_Channel& value, Int
     // general version for addition of multi-event sets
     fGoodEventCount += n2;
     fValue += n2 * (M12 - M11) / n;
-    fValueM2 += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+    fValueM2 += M22 + Double_t(n1) * n2 * (M12 - M11) * (M12 - M11) / n;
   }
 
   // Nanny
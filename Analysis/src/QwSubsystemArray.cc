@@ -14,6 +14,8 @@
 #include "VQwHardwareChannel.h"
 #include "QwLog.h"
 #include "QwParameterFile.h"
+#include "QwTaskPool.h"
+#include "QwProfiler.h"
 
 /// \todo TODO (wdc) QwVQWK_Channel necessary due to explicit cast in ReturnInternalValue (yuck)
 #include "QwVQWK_Channel.h"
@@ -24,7 +26,8 @@
  * Create a subsystem array based on the configuration option 'detectors'
  */
 QwSubsystemArray::QwSubsystemArray(QwOptions& options, CanContainFn myCanContain)
-: fEventTypeMask(0x0),fnCanContain(myCanContain)
+: fEventTypeMask(0x0),fnCanContain(myCanContain),fBankRoutesValid(kFALSE),
+  fProcessThreads(1),fProcessLevelsValid(kFALSE)
 {
   ProcessOptionsToplevel(options);
   QwParameterFile detectors(fSubsystemsMapFile.c_str());
@@ -45,6 +48,9 @@ QwSubsystemArray::QwSubsystemArray(const QwSubsystemArray& source)
   fEventTypeMask(source.fEventTypeMask),
   fHasDataLoaded(source.fHasDataLoaded),
   fnCanContain(source.fnCanContain),
+  fBankRoutesValid(kFALSE),
+  fProcessThreads(source.fProcessThreads),
+  fProcessLevelsValid(kFALSE),
   fSubsystemsMapFile(source.fSubsystemsMapFile),
   fSubsystemsDisabledByName(source.fSubsystemsDisabledByName),
   fSubsystemsDisabledByType(source.fSubsystemsDisabledByType)
@@ -62,6 +68,8 @@ QwSubsystemArray::QwSubsystemArray(const QwSubsystemArray& source)
              << " could be published!" << QwLog::endl;
     }
   }
+  // The copied subsystems look up the values published in this array
+  ResolveExternalValues();
 }
 
 
@@ -159,6 +167,9 @@ void QwSubsystemArray::LoadSubsystemsFromParameterFile(QwParameterFile& detector
     // Delete parameter file section
     delete section; section = 0;
   }
+
+  // All subsystems have published their variables
+  ResolveExternalValues();
 }
 
 //*****************************************************************
@@ -196,6 +207,10 @@ void QwSubsystemArray::push_back(VQwSubsystem* subsys)
     // Update the event type mask
     // Note: Active bits in the mask indicate event types that are accepted
     fEventTypeMask |= subsys_tmp->GetEventTypeMask();
+
+    // The bank routing table must include the new subsystem
+    ResetBankRoutes();
+    ResetProcessLevels();
   }
 }
 
@@ -210,6 +225,9 @@ void QwSubsystemArray::DefineOptions(QwOptions &options)
   options.AddOptions()("detectors",
                        po::value<std::string>()->default_value("detectors.map"),
                        "map file with detectors to include");
+  options.AddOptions()("subsystem-threads",
+                       po::value<int>()->default_value(1),
+                       "number of threads processing the subsystems of an event (1 processes them serially)");
 
   // Versions of boost::program_options below 1.39.0 have a bug in multitoken processing
 #if BOOST_VERSION < 103900
@@ -242,6 +260,9 @@ void QwSubsystemArray::ProcessOptionsToplevel(QwOptions &options)
   // Subsystems to disable
   fSubsystemsDisabledByName = options.GetValueVector<std::string>("disable-by-name");
   fSubsystemsDisabledByType = options.GetValueVector<std::string>("disable-by-type");
+  // Threads processing the subsystems
+  fProcessThreads = options.GetValue<int>("subsystem-threads");
+  if (fProcessThreads < 1) fProcessThreads = 1;
 }
 
 
@@ -352,6 +373,91 @@ void  QwSubsystemArray::GetMarkerWordList(
 }
 
 
+/**
+ * Build the table that routes each ROC/bank pair to the subsystems that
+ * registered it, with the subbank index each of them will look up.
+ * Subsystems that receive all banks are included in every route, and
+ * also make up the route for banks that no subsystem has registered.
+ * Within a route the subsystems keep their order in the array, and each
+ * subsystem appears only once, with the first subbank index it has for
+ * the bank.  The table is discarded whenever a subsystem is added or
+ * changes its registered banks (e.g. when its channel map is reloaded).
+ */
+void QwSubsystemArray::BuildBankRoutes()
+{
+  fBankRoutes.clear();
+  fUnroutedBankRoute.clear();
+
+  std::vector<BankKey_t> banks;
+  for (const_iterator subsys = begin(); subsys != end(); ++subsys) {
+    (*subsys)->GetRegisteredBanks(banks);
+    for (size_t i = 0; i < banks.size(); i++)
+      fBankRoutes[banks.at(i)];
+  }
+
+  for (const_iterator subsys = begin(); subsys != end(); ++subsys) {
+    BankRoute_t route;
+    route.fSubsystem = subsys->get();
+    route.fIndex = subsys - begin();
+    if (route.fSubsystem->ReceivesAllBanks()) {
+      route.fSubbankIndex = -1;
+      AddBankRoute(fUnroutedBankRoute, route);
+      for (std::map<BankKey_t, BankRouteList_t>::iterator bank = fBankRoutes.begin();
+           bank != fBankRoutes.end(); ++bank)
+        AddBankRoute(bank->second, route);
+    } else {
+      // Registered banks are listed in subbank index order
+      route.fSubsystem->GetRegisteredBanks(banks);
+      for (size_t i = 0; i < banks.size(); i++) {
+        route.fSubbankIndex = i;
+        AddBankRoute(fBankRoutes[banks.at(i)], route);
+      }
+    }
+  }
+  fBankRoutesValid = kTRUE;
+  fDecodeTime.resize(size(), 0);
+
+  QwVerbose << "QwSubsystemArray::BuildBankRoutes: " << fBankRoutes.size()
+            << " routed banks, " << fUnroutedBankRoute.size()
+            << " subsystems receiving all banks" << QwLog::endl;
+}
+
+
+void QwSubsystemArray::AddBankRoute(BankRouteList_t& routes, const BankRoute_t& route)
+{
+  //  A subsystem in the array twice, or with a bank registered twice,
+  //  still decodes each bank once
+  for (size_t i = 0; i < routes.size(); i++)
+    if (routes[i].fSubsystem == route.fSubsystem) return;
+  routes.push_back(route);
+}
+
+
+void QwSubsystemArray::DispatchEvBuffer(
+  const BankRouteList_t& routes,
+  const UInt_t event_type,
+  const ROCID_t roc_id,
+  const BankID_t bank_id,
+  UInt_t* buffer,
+  UInt_t num_words)
+{
+  for (BankRouteList_t::const_iterator route = routes.begin();
+       route != routes.end(); ++route) {
+    VQwSubsystem* subsys = route->fSubsystem;
+    ULong64_t start = QwProfiler::Now();
+    if (route->fSubbankIndex >= 0)
+      subsys->SetDispatchedSubbank(roc_id, bank_id, route->fSubbankIndex);
+    subsys->ProcessEvBuffer(event_type, roc_id, bank_id, buffer, num_words);
+    fDecodeTime[route->fIndex] += QwProfiler::Now() - start;
+  }
+}
+
+
+/**
+ * Deliver a bank only to the subsystems that decode it, as found in the
+ * routing table (built on first use).  Event type masks are still applied
+ * by the subsystems themselves.
+ */
 Int_t QwSubsystemArray::ProcessEvBuffer(
   const UInt_t event_type,
   const ROCID_t roc_id,
@@ -361,21 +467,107 @@ Int_t QwSubsystemArray::ProcessEvBuffer(
 {
   if (!empty()) {
     SetDataLoaded(kTRUE);
-    for (iterator subsys = begin(); subsys != end(); ++subsys) {
-      (*subsys)->ProcessEvBuffer(event_type, roc_id, bank_id, buffer, num_words);
-    }
+    if (! fBankRoutesValid) BuildBankRoutes();
+    std::map<BankKey_t, BankRouteList_t>::const_iterator bank
+      = fBankRoutes.find(BankKey_t(roc_id, bank_id));
+    if (bank != fBankRoutes.end())
+      DispatchEvBuffer(bank->second, event_type, roc_id, bank_id, buffer, num_words);
+    else
+      DispatchEvBuffer(fUnroutedBankRoute, event_type, roc_id, bank_id, buffer, num_words);
   }
   return 0;
 }
 
 
+/**
+ * Process the event in three phases: ProcessEvent of all subsystems, the
+ * exchange of processed data, and ProcessEvent_2.  With more than one
+ * subsystem thread the first and last phases run in parallel, one level
+ * of the processing order at a time; the exchange stays serial.
+ */
 void  QwSubsystemArray::ProcessEvent()
 {
+  QwProfiler::Scope profile(QwProfiler::kProcess);
   if (!empty() && HasDataLoaded()) {
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent));
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ExchangeProcessedData));
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent_2));
+    if (fProcessTime.size() != size()) fProcessTime.resize(size(), 0);
+    if (fProcessThreads < 2) {
+      for (size_t i = 0; i < size(); i++) ProcessPhase(i, &VQwSubsystem::ProcessEvent);
+      for (size_t i = 0; i < size(); i++) ProcessPhase(i, &VQwSubsystem::ExchangeProcessedData);
+      for (size_t i = 0; i < size(); i++) ProcessPhase(i, &VQwSubsystem::ProcessEvent_2);
+      return;
+    }
+    if (! fProcessLevelsValid) BuildProcessLevels();
+    if (! fTaskPool) fTaskPool.reset(new QwTaskPool(fProcessThreads));
+    ProcessLevels(&VQwSubsystem::ProcessEvent);
+    for (size_t i = 0; i < size(); i++) ProcessPhase(i, &VQwSubsystem::ExchangeProcessedData);
+    ProcessLevels(&VQwSubsystem::ProcessEvent_2);
+  }
+}
+
+void QwSubsystemArray::ProcessLevels(void (VQwSubsystem::*phase)())
+{
+  for (size_t level = 0; level < fProcessLevels.size(); level++) {
+    const std::vector<size_t>& subsystems = fProcessLevels[level];
+    fTaskPool->Run(subsystems.size(),
+        [&](size_t i){ ProcessPhase(subsystems[i], phase); });
+  }
+}
+
+void QwSubsystemArray::ProcessPhase(size_t i, void (VQwSubsystem::*phase)())
+{
+  ULong64_t start = QwProfiler::Now();
+  (at(i).get()->*phase)();
+  fProcessTime[i] += QwProfiler::Now() - start;
+}
+
+/**
+ * Sort the subsystems in levels: a subsystem that declared external values
+ * is placed one level after the latest of their publishers, and all other
+ * subsystems are in the first level.  Within a level the subsystems do not
+ * depend on each other and keep their order in the array.  A dependency
+ * cycle puts every subsystem in its own level, which is the serial order.
+ */
+void QwSubsystemArray::BuildProcessLevels()
+{
+  std::vector<size_t> level(size(), 0);
+  Bool_t changed = kTRUE;
+  size_t passes = 0;
+  while (changed && passes++ <= size()) {
+    changed = kFALSE;
+    for (size_t i = 0; i < size(); i++) {
+      const std::vector<TString>& names = at(i)->GetExternalValueNames();
+      for (size_t k = 0; k < names.size(); k++) {
+        std::map<TString, const VQwSubsystem*>::const_iterator publisher
+          = fPublishedValuesSubsystem.find(names[k]);
+        if (publisher == fPublishedValuesSubsystem.end()) continue;
+        for (size_t j = 0; j < size(); j++) {
+          if (j != i && at(j).get() == publisher->second
+           && level[i] <= level[j]) {
+            level[i] = level[j] + 1;
+            changed = kTRUE;
+          }
+        }
+      }
+    }
+  }
+
+  fProcessLevels.clear();
+  if (changed) {
+    QwWarning << "QwSubsystemArray::BuildProcessLevels: dependency cycle "
+              << "between subsystems, processing them serially" << QwLog::endl;
+    for (size_t i = 0; i < size(); i++)
+      fProcessLevels.push_back(std::vector<size_t>(1, i));
+  } else {
+    for (size_t i = 0; i < size(); i++) {
+      if (fProcessLevels.size() <= level[i]) fProcessLevels.resize(level[i] + 1);
+      fProcessLevels[level[i]].push_back(i);
+    }
   }
+  fProcessLevelsValid = kTRUE;
+
+  QwVerbose << "QwSubsystemArray::BuildProcessLevels: " << size()
+            << " subsystems in " << fProcessLevels.size() << " levels"
+            << QwLog::endl;
 }
 
 void  QwSubsystemArray::AtEndOfEventLoop()
@@ -615,6 +807,29 @@ Bool_t QwSubsystemArray::RequestExternalValue(const TString& name, VQwHardwareCh
   return ReturnInternalValue(name, value);
 }
 
+/**
+ * Retrieve a pointer to the variable name from other subsystem arrays.
+ * The pointer stays valid for the lifetime of the subsystem array, so
+ * it can be looked up once (see QwExternalValue).
+ * @param name Variable name to be retrieved
+ * @return Data element with the variable name, null if not found
+ */
+const VQwHardwareChannel* QwSubsystemArray::RequestExternalPointer(const TString& name) const
+{
+  return ReturnInternalValue(name);
+}
+
+/**
+ * Let every subsystem look up the external values it uses while processing
+ * an event.  This is done once, after all subsystems in the array have
+ * published their variables; failed lookups are reported here.
+ */
+void QwSubsystemArray::ResolveExternalValues()
+{
+  for (iterator subsys = begin(); subsys != end(); ++subsys)
+    (*subsys)->ResolveExternalValues();
+}
+
 /**
  * Retrieve the variable name from subsystems in this subsystem array
  * @param name Variable name to be retrieved
@@ -703,6 +918,8 @@ Bool_t QwSubsystemArray::PublishInternalValue(
   fPublishedValuesSubsystem[name] = subsys;
   fPublishedValuesDescription[name] = desc;
   fPublishedValuesDataElement[name] = element;
+  // The new value may be used by a subsystem processed earlier
+  ResetProcessLevels();
   return kTRUE;
 }
 
@@ -868,6 +1085,10 @@ void QwSubsystemArray::push_back(boost::shared_ptr<VQwSubsystem> subsys)
    // Note: Active bits in the mask indicate event types that are accepted
    fEventTypeMask |= subsys_tmp->GetEventTypeMask();
 
+   // The bank routing table must include the new subsystem
+   ResetBankRoutes();
+   ResetProcessLevels();
+
    // Instruct the subsystem to publish variables
    if (subsys_tmp->PublishInternalValues() == kFALSE) {
      QwError << "Not all variables for " << subsys_tmp->GetSubsystemName()
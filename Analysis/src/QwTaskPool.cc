@@ -0,0 +1,80 @@
+/**
+ *  \file   QwTaskPool.cc
+ *  \brief  Fixed set of threads running the tasks of a parallel loop
+ */
+
+#include "QwTaskPool.h"
+
+QwTaskPool::QwTaskPool(Int_t threads)
+: fTask(0),
+  fCount(0),
+  fNext(0),
+  fActive(0),
+  fGeneration(0),
+  fStop(kFALSE)
+{
+  //  The calling thread is one of the threads running tasks
+  for (Int_t i = 1; i < threads; i++)
+    fThreads.push_back(std::thread(&QwTaskPool::Loop, this));
+}
+
+QwTaskPool::~QwTaskPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fStart.notify_all();
+  for (size_t i = 0; i < fThreads.size(); i++)
+    fThreads[i].join();
+}
+
+void QwTaskPool::Run(size_t n, const Task_t& task)
+{
+  //  Without threads, or with a single task, there is nothing to share
+  if (fThreads.empty() || n < 2) {
+    for (size_t i = 0; i < n; i++) task(i);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fTask   = &task;
+    fCount  = n;
+    fNext   = 0;
+    fActive = fThreads.size();
+    fGeneration++;
+  }
+  fStart.notify_all();
+  Work();
+  //  The task must not go out of scope while a thread may still use it
+  std::unique_lock<std::mutex> lock(fMutex);
+  fDone.wait(lock, [this]{ return fActive == 0; });
+  fTask = 0;
+}
+
+void QwTaskPool::Work()
+{
+  size_t i;
+  while ((i = fNext++) < fCount)
+    (*fTask)(i);
+}
+
+void QwTaskPool::Loop()
+{
+  ULong64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fStart.wait(lock, [&]{ return fStop || fGeneration != generation; });
+      if (fStop) return;
+      generation = fGeneration;
+    }
+    Work();
+    Bool_t done;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      done = (--fActive == 0);
+    }
+    if (done) fDone.notify_one();
+  }
+}
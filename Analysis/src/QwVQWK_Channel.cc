@@ -150,6 +150,16 @@ void QwVQWK_Channel::IncrementErrorCounters(){
   }
 }
 
+void QwVQWK_Channel::MergeErrorCounters(const QwVQWK_Channel& source){
+  fErrorCount_sample   += source.fErrorCount_sample;
+  fErrorCount_SW_HW    += source.fErrorCount_SW_HW;
+  fErrorCount_Sequence += source.fErrorCount_Sequence;
+  fErrorCount_SameHW   += source.fErrorCount_SameHW;
+  fErrorCount_ZeroHW   += source.fErrorCount_ZeroHW;
+  fErrorCount_HWSat    += source.fErrorCount_HWSat;
+  fNumEvtsWithEventCutsRejected += source.fNumEvtsWithEventCutsRejected;
+}
+
 /********************************************************/
 
 void QwVQWK_Channel::InitializeChannel(TString name, TString datatosave)
@@ -693,56 +703,69 @@ void  QwVQWK_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, std
     bDevice_Error_Code=gQwHists.MatchVQWKElementFromList(GetSubsystemName().Data(), GetModuleType().Data(), "Device_Error_Code");
     bSequence_number=gQwHists.MatchVQWKElementFromList(GetSubsystemName().Data(), GetModuleType().Data(), "sequence_number");
 
+    //  Leaf types from the tree trim file or their defaults; QwRootTree
+    //  converts the values of the vector to these types when filled
+    auto LeafType = [this](const char* element) {
+      return TString("/") + gQwHists.GetElementLeafType(GetSubsystemName().Data(), GetModuleType().Data(), element);
+    };
+    TString tHw_sum = LeafType("hw_sum");
+    TString tHw_sum_raw = LeafType("hw_sum_raw");
+    TString tBlock = LeafType("block");
+    TString tBlock_raw = LeafType("block_raw");
+    TString tNum_samples = LeafType("num_samples");
+    TString tDevice_Error_Code = LeafType("Device_Error_Code");
+    TString tSequence_number = LeafType("sequence_number");
+
     if (bHw_sum){
       values.push_back(0.0);
-      list += "hw_sum/D";
+      list += "hw_sum"+tHw_sum;
     }
     if (bBlock){
       values.push_back(0.0);
-      list += ":block0/D";
+      list += ":block0"+tBlock;
 
       values.push_back(0.0);
-      list += ":block1/D";
+      list += ":block1"+tBlock;
 
       values.push_back(0.0);
-      list += ":block2/D";
+      list += ":block2"+tBlock;
 
       values.push_back(0.0);
-      list += ":block3/D";
+      list += ":block3"+tBlock;
     }
 
     if (bNum_samples){
       values.push_back(0.0);
-      list += ":num_samples/D";
+      list += ":num_samples"+tNum_samples;
     }
 
     if (bDevice_Error_Code){
       values.push_back(0.0);
-      list += ":Device_Error_Code/D";
+      list += ":Device_Error_Code"+tDevice_Error_Code;
     }
 
     if(fDataToSave==kRaw)
       {
 	if (bHw_sum_raw){
 	  values.push_back(0.0);
-	  list += ":hw_sum_raw/D";
+	  list += ":hw_sum_raw"+tHw_sum_raw;
 	}
 	if (bBlock_raw){
 	  values.push_back(0.0);
-	  list += ":block0_raw/D";
+	  list += ":block0_raw"+tBlock_raw;
 
 	  values.push_back(0.0);
-	  list += ":block1_raw/D";
+	  list += ":block1_raw"+tBlock_raw;
 
 	  values.push_back(0.0);
-	  list += ":block2_raw/D";
+	  list += ":block2_raw"+tBlock_raw;
 
 	  values.push_back(0.0);
-	  list += ":block3_raw/D";
+	  list += ":block3_raw"+tBlock_raw;
 	}
 	if (bSequence_number){
 	  values.push_back(0.0);
-	  list += ":sequence_number/D";
+	  list += ":sequence_number"+tSequence_number;
 	}
       }
 
@@ -750,8 +773,8 @@ void  QwVQWK_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, std
  
     if (gQwHists.MatchDeviceParamsFromList(basename.Data()) && (bHw_sum || bBlock || bNum_samples || bDevice_Error_Code || bHw_sum_raw || bBlock_raw || bSequence_number)){
 
-      if (list=="hw_sum/D")//this is for the RT mode
-	list=basename+"/D";	
+      if (list=="hw_sum"+tHw_sum)//this is for the RT mode
+	list=basename+tHw_sum;
       
       if (kDEBUG)
 	QwMessage <<"base name "<<basename<<" List "<<list<<  QwLog::endl;
@@ -894,6 +917,50 @@ QwVQWK_Channel& QwVQWK_Channel::operator= (const QwVQWK_Channel &value)
   return *this;
 }
 
+/**
+ * Append the event-based data to a buffer, in the same way as operator=
+ * copies it, so that UnpackEventData restores an assigned copy.
+ */
+void QwVQWK_Channel::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (!IsNameEmpty()) {
+    buffer.push_back(fGoodEventCount);
+    buffer.push_back(fErrorFlag);
+    for (Int_t i=0; i<fBlocksPerEvent; i++){
+      buffer.push_back(fBlock_raw[i]);
+      buffer.push_back(fBlock[i]);
+      buffer.push_back(fBlockM2[i]);
+    }
+    buffer.push_back(fHardwareBlockSum_raw);
+    buffer.push_back(fSoftwareBlockSum_raw);
+    buffer.push_back(fHardwareBlockSum);
+    buffer.push_back(fHardwareBlockSumM2);
+    buffer.push_back(fHardwareBlockSumError);
+    buffer.push_back(fNumberOfSamples);
+    buffer.push_back(fSequenceNumber);
+  }
+}
+
+void QwVQWK_Channel::UnpackEventData(const Double_t*& data)
+{
+  if (!IsNameEmpty()) {
+    fGoodEventCount = Int_t(*data++);
+    fErrorFlag      = UInt_t(*data++);
+    for (Int_t i=0; i<fBlocksPerEvent; i++){
+      fBlock_raw[i] = Int_t(*data++);
+      fBlock[i]     = *data++;
+      fBlockM2[i]   = *data++;
+    }
+    fHardwareBlockSum_raw  = Int_t(*data++);
+    fSoftwareBlockSum_raw  = Int_t(*data++);
+    fHardwareBlockSum      = *data++;
+    fHardwareBlockSumM2    = *data++;
+    fHardwareBlockSumError = *data++;
+    fNumberOfSamples       = size_t(*data++);
+    fSequenceNumber        = size_t(*data++);
+  }
+}
+
 void QwVQWK_Channel::AssignScaledValue(const QwVQWK_Channel &value,
 				 Double_t scale)
 {
@@ -1370,7 +1437,10 @@ void QwVQWK_Channel::AccumulateRunningSum(const QwVQWK_Channel& value, Int_t cou
   Int_t n1 = fGoodEventCount;
   Int_t n2 = count;
   // If there are no good events, check the error flag
-  if (n2 == 0 && (value.fErrorFlag) == 0) {
+  if (fMergingRunningSums) {
+    //a running sum of another part of the run is merged (set of n2 good events)
+    if (n2 < 0) n2 = 0;
+  }else if (n2 == 0 && (value.fErrorFlag) == 0) {
     n2 = 1;
     //one event is removed from the sum (Deaccumulation)
   }else if (n2 == -1 && berror) { //check only single event cut errors except stability fail flag since by the time the value is deaccumulated this could be flagged as stability failed error. 
@@ -1427,14 +1497,14 @@ void QwVQWK_Channel::AccumulateRunningSum(const QwVQWK_Channel& value, Int_t cou
     // general version for addition of multi-event sets
     fGoodEventCount += n2;
     fHardwareBlockSum += n2 * (M12 - M11) / n;
-    fHardwareBlockSumM2 += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+    fHardwareBlockSumM2 += M22 + Double_t(n1) * n2 * (M12 - M11) * (M12 - M11) / n;
     // and for individual blocks
     for (Int_t i = 0; i < 4; i++) {
       M11 = fBlock[i];
       M12 = value.fBlock[i];
       M22 = value.fBlockM2[i];
       fBlock[i] += n2 * (M12 - M11) / n;
-      fBlockM2[i] += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+      fBlockM2[i] += M22 + Double_t(n1) * n2 * (M12 - M11) * (M12 - M11) / n;
     }
   }
 
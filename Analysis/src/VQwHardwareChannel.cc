@@ -7,6 +7,8 @@
 #endif
 #include "QwParameterFile.h"
 
+thread_local Bool_t VQwHardwareChannel::fMergingRunningSums = kFALSE;
+
 VQwHardwareChannel::VQwHardwareChannel():
   fNumberOfDataWords(0),
   fNumberOfSubElements(0), fDataToSave(kRaw)
@@ -198,6 +198,23 @@ Bool_t VQwSubsystem::RequestExternalValue(
 }
 
 
+/**
+ * Get a pointer to the value corresponding to some variable name from a
+ * different subsystem.
+ * @param name Name of the desired variable
+ * @return Pointer to the value, null if not found
+ */
+const VQwHardwareChannel* VQwSubsystem::RequestExternalPointer(const TString& name) const
+{
+  // Get the parent and check for existence (NOTE: only one parent supported)
+  QwSubsystemArray* parent = GetParent();
+  if (parent != 0) {
+    return parent->RequestExternalPointer(name);
+  }
+  return 0; // Error: could not find variable in parent
+}
+
+
 /**
  * Publish a variable name to the subsystem array
  * @param name Name of the variable
@@ -232,11 +249,34 @@ void VQwSubsystem::ClearAllBankRegistrations()
   fROC_IDs.clear();
   fCurrentROC_ID    = kNullROCID;
   fCurrentBank_ID   = kNullBankID;
+  fDispatchedROC_ID       = kNullROCID;
+  fDispatchedBank_ID      = kNullBankID;
+  fDispatchedSubbankIndex = -1;
+  ResetParentBankRoutes();
+}
+
+void VQwSubsystem::ResetParentBankRoutes()
+{
+  //  The routes are built again at the next event
+  for (size_t i = 0; i < fArrays.size(); i++)
+    if (fArrays.at(i)) fArrays.at(i)->ResetBankRoutes();
+}
+
+void VQwSubsystem::GetRegisteredBanks(std::vector<std::pair<ROCID_t,BankID_t> >& banks) const
+{
+  banks.clear();
+  for (size_t roc_index = 0; roc_index < fROC_IDs.size(); roc_index++)
+    for (size_t bank_index = 0; bank_index < fBank_IDs[roc_index].size(); bank_index++)
+      banks.push_back(std::make_pair(fROC_IDs[roc_index], fBank_IDs[roc_index][bank_index]));
 }
 
 Int_t VQwSubsystem::GetSubbankIndex(const ROCID_t roc_id, const BankID_t bank_id) const
 {
   //  Bool_t lDEBUG=kTRUE;
+  //  The subsystem array routes banks with their precomputed index
+  if (roc_id == fDispatchedROC_ID && bank_id == fDispatchedBank_ID)
+    return fDispatchedSubbankIndex;
+
   Int_t index = -1;
   Int_t roc_index = FindIndex(fROC_IDs, roc_id);//will return the vector index for the Roc from the vector fROC_IDs.
   // std::cout << "------------- roc_index" << roc_index <<std::endl;
@@ -274,11 +314,13 @@ Int_t VQwSubsystem::RegisterROCNumber(const ROCID_t roc_id, const BankID_t bank_
     fBank_IDs.push_back(tmpvec);
     fMarkerWords.resize(fROC_IDs.size());
     fMarkerWords.at(roc_index).resize(1);
+    ResetParentBankRoutes();
   } else {
     Int_t bank_index = FindIndex(fBank_IDs[roc_index],bank_id);
     if (bank_index==-1) { // if the bank_id is not registered then register it.
       fBank_IDs[roc_index].push_back(bank_id);
       fMarkerWords.at(roc_index).resize(fBank_IDs.at(roc_index).size());
+      ResetParentBankRoutes();
     } else {
       //  This subbank in this ROC has already been registered!
       QwError << std::hex << "VQwSubsystem::RegisterROCNumber:  "
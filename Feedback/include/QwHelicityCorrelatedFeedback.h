@@ -13,6 +13,7 @@
 #include "GreenMonster.h"
 #include "QwVQWK_Channel.h"
 #include "QwScaler_Channel.h"
+#include "QwExternalValue.h"
 
 #include "QwParameterFile.h"
 #include <time.h>
@@ -255,6 +256,9 @@ class QwHelicityCorrelatedFeedback : public QwHelicityPattern {
     void ClearRunningSum(Int_t mode);
 
  private:
+    /// \brief Look up the published values used for every pattern
+    void ResolveExternalValues();
+
     /// \brief Returns the charge asymmetry stats when required by feedback caluculations.
     Double_t GetChargeAsym(){
       return fChargeAsymmetry;
@@ -441,6 +445,20 @@ class QwHelicityCorrelatedFeedback : public QwHelicityPattern {
 
     QwBeamCharge   fAsymBCM7;//to access bcm7 asymmetry
     QwBeamCharge   fAsymBCM8;//to access bcm8 asymmetry
+
+    // Published values used for every pattern, looked up in ProcessOptions
+    QwExternalValue<VQwHardwareChannel> fScalerChargeHandle;
+    QwExternalValue<VQwHardwareChannel> fTargetXDiffHandle;
+    QwExternalValue<VQwHardwareChannel> fTargetXPDiffHandle;
+    QwExternalValue<VQwHardwareChannel> fTargetYDiffHandle;
+    QwExternalValue<VQwHardwareChannel> fTargetYPDiffHandle;
+    QwExternalValue<VQwHardwareChannel> f3C12XDiffHandle;
+    QwExternalValue<VQwHardwareChannel> f3C12YDiffHandle;
+    QwExternalValue<VQwHardwareChannel> fAsymBCM7Handle;
+    QwExternalValue<VQwHardwareChannel> fAsymBCM8Handle;
+    QwExternalValue<VQwHardwareChannel> fAsymUSLumiSumHandle;
+    QwExternalValue<VQwHardwareChannel> f3C12YQHandle;
+    QwExternalValue<VQwHardwareChannel> fYieldBCM8Handle;
     QwBeamCharge   fAsymBCM78DDRunningSum;//to accumulate bcm78 DD asymmetry
     QwBeamCharge   fYieldBCM8RunningSum;//to access bcm8 Yield
 
@@ -96,6 +96,25 @@ void QwHelicityCorrelatedFeedback::ProcessOptions(QwOptions &options)
     //exit(1);
   }
   //exit(1);
+
+  ResolveExternalValues();
+};
+
+/*****************************************************************/
+void QwHelicityCorrelatedFeedback::ResolveExternalValues()
+{
+  fScalerChargeHandle.Resolve(fAsymmetry, "sca_bcm");
+  fTargetXDiffHandle.Resolve(fAsymmetry, "x_targ");
+  fTargetXPDiffHandle.Resolve(fAsymmetry, "xp_targ");
+  fTargetYDiffHandle.Resolve(fAsymmetry, "y_targ");
+  fTargetYPDiffHandle.Resolve(fAsymmetry, "yp_targ");
+  f3C12XDiffHandle.Resolve(fAsymmetry, "3c12x");
+  f3C12YDiffHandle.Resolve(fAsymmetry, "3c12y");
+  fAsymBCM7Handle.Resolve(fAsymmetry, "bcm7");
+  fAsymBCM8Handle.Resolve(fAsymmetry, "bcm8");
+  fAsymUSLumiSumHandle.Resolve(fAsymmetry, "uslumisum");
+  f3C12YQHandle.Resolve(fYield, "3c12efc");
+  fYieldBCM8Handle.Resolve(fYield, "bcm8");
 };
 
 /*****************************************************************/
@@ -1044,7 +1063,8 @@ void QwHelicityCorrelatedFeedback::AccumulateRunningSum(){
 
   QwHelicityPattern::AccumulateRunningSum();
 
-  if(fAsymmetry.RequestExternalValue("sca_bcm", &fScalerCharge)){
+  if(fScalerChargeHandle.IsValid()){
+    fScalerCharge.AssignValueFrom(fScalerChargeHandle.Get());
     //fScalerChargeRunningSum.PrintValue();
     //fScalerChargeRunningSum.AccumulateRunningSum(fScalerCharge);
     if (fScalerCharge.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
@@ -1052,70 +1072,80 @@ void QwHelicityCorrelatedFeedback::AccumulateRunningSum(){
       fHAGoodPatternCounter++;//update the good HA asymmetry counter
     }
   }else{
-    QwError << " Could not get external value setting parameters to  sca_bcm" <<QwLog::endl;
     fHAIAFB=kFALSE;
   }
   
-  if(fAsymmetry.RequestExternalValue("x_targ", &fTargetParameter)){
+  if(fTargetXDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(fTargetXDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       fTargetXDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       bXDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("xp_targ", &fTargetParameter)){
+  if(fTargetXPDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(fTargetXPDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       fTargetXPDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       bXPDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("y_targ", &fTargetParameter)){
+  if(fTargetYDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(fTargetYDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       fTargetYDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       bYDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("yp_targ", &fTargetParameter)){
+  if(fTargetYPDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(fTargetYPDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       fTargetYPDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       bYPDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("3c12x", &fTargetParameter)){
+  if(f3C12XDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(f3C12XDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       f3C12XDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       b3C12XDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("3c12y", &fTargetParameter)){
+  if(f3C12YDiffHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(f3C12YDiffHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       f3C12YDiffRunningSum.AccumulateRunningSum(fTargetParameter);
       b3C12YDiff=kTRUE;
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("bcm7", &fAsymBCM7) && fAsymmetry.RequestExternalValue("bcm8", &fAsymBCM8)){
+  if(fAsymBCM7Handle.IsValid() && fAsymBCM8Handle.IsValid()){
+    fAsymBCM7.AssignValueFrom(fAsymBCM7Handle.Get());
+    fAsymBCM8.AssignValueFrom(fAsymBCM8Handle.Get());
     if (fAsymBCM7.GetEventcutErrorFlag()==0 && fAsymBCM8.GetEventcutErrorFlag()==0 && fAsymmetry.GetEventcutErrorFlag()==0){
       fAsymBCM78DDRunningSum.AccumulateRunningSum((fAsymBCM7-fAsymBCM8));
     }
   }
 
-  if(fAsymmetry.RequestExternalValue("uslumisum", &fTargetCharge)){
+  if(fAsymUSLumiSumHandle.IsValid()){
+    fTargetCharge.AssignValueFrom(fAsymUSLumiSumHandle.Get());
     if (fAsymmetry.GetEventcutErrorFlag()==0 && fTargetCharge.GetEventcutErrorFlag()==0){
       fAsymUSLumiSumRunningSum.AccumulateRunningSum(fTargetCharge);
     }
   }
-  if(fYield.RequestExternalValue("3c12efc", &fTargetParameter)){
+  if(f3C12YQHandle.IsValid()){
+    fTargetParameter.AssignValueFrom(f3C12YQHandle.Get());
     if (fTargetParameter.GetEventcutErrorFlag()==0 && fYield.GetEventcutErrorFlag()==0){
       f3C12YQRunningSum.AccumulateRunningSum(fTargetParameter);
       b3C12YQ=kTRUE;
     }
   }
-  if(fYield.RequestExternalValue("bcm8", &fTargetCharge)){
+  if(fYieldBCM8Handle.IsValid()){
+    fTargetCharge.AssignValueFrom(fYieldBCM8Handle.Get());
     if (fTargetCharge.GetEventcutErrorFlag()==0 && fYield.GetEventcutErrorFlag()==0){
       fYieldBCM8RunningSum.AccumulateRunningSum(fTargetCharge);
     }
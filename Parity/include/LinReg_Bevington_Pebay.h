@@ -10,6 +10,7 @@
  * "Formulas for Robust, One-Pass Parallel Computation of Covariances and Arbitrary-Order Statistical Moments" Philippe Peba, SANDIA REPORT SAND2008-6212, Unlimited Release, Printed September 2008
  *********************************************************************/
 
+#include <vector>
 #include <TMatrixD.h>
 
 //-----------------------------------------
@@ -33,6 +34,11 @@ class LinRegBevPeb {
   /// processing single events
   void  accumulate(double *P, double *Y);
   void  solve();
+  /// merging the accumulators of another part of the data
+  void  merge(const LinRegBevPeb &other);
+  /// (un)packing the accumulators, e.g. to merge them in another process
+  void  pack(std::vector<double> &buffer) const;
+  void  unpack(const double* &data);
   double Alpha(int ip, int iy){ return mA(ip,iy);} //ok
   bool   failed(){ return  fGoodEventNumber<2;}
 
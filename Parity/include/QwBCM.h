@@ -102,6 +102,9 @@ class QwBCM : public VQwBCM {
   }
 
   void UpdateErrorFlag(const VQwBCM *ev_error);
+  void MergeErrorCounters(const VQwBCM *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
   UInt_t GetErrorCode() const {return (fBeamCurrent.GetErrorCode());}; 
 
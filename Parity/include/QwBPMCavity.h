@@ -95,6 +95,9 @@ class QwBPMCavity : public VQwBPM {
   UInt_t  GetEventcutErrorFlag();
   UInt_t  UpdateErrorFlag();
   void UpdateErrorFlag(const VQwBPM *ev_error);
+  void MergeErrorCounters(const VQwBPM *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
   void    SetDefaultSampleSize(Int_t sample_size);
   void    SetRandomEventParameters(Double_t meanX, Double_t sigmaX, Double_t meanY, Double_t sigmaY);
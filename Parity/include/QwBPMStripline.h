@@ -64,7 +64,9 @@ class QwBPMStripline : public VQwBPM {
   QwBPMStripline(const QwBPMStripline& source)
   : VQwBPM(source),
     fWire(source.fWire),fRelPos(source.fRelPos),fAbsPos(source.fAbsPos),
-    fEffectiveCharge(source.fEffectiveCharge)
+    fEffectiveCharge(source.fEffectiveCharge),
+    fNumer(source.fNumer),fDenom(source.fDenom),
+    fTmp1(source.fTmp1),fTmp2(source.fTmp2),fRawPos(source.fRawPos)
   { }
   virtual ~QwBPMStripline() { };
 
@@ -114,6 +116,9 @@ class QwBPMStripline : public VQwBPM {
   UInt_t  UpdateErrorFlag();
 
   void    UpdateErrorFlag(const VQwBPM *ev_error);
+  void    MergeErrorCounters(const VQwBPM *source);
+  void    PackEventData(std::vector<Double_t>& buffer) const;
+  void    UnpackEventData(const Double_t*& data);
 
 
   void    SetDefaultSampleSize(Int_t sample_size);
@@ -195,6 +200,12 @@ class QwBPMStripline : public VQwBPM {
   T fAbsPos[2];
   T fEffectiveCharge;
 
+  //  Scratch channels of ProcessEvent and FillRawEventData, set up once
+  //  in InitializeChannel instead of for every event
+  mutable T fNumer, fDenom;
+  mutable T fTmp1, fTmp2;
+  mutable T fRawPos[2];
+
 private: 
   // Functions to be removed
   void    SetEventData(Double_t* block, UInt_t sequencenumber);
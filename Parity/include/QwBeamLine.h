@@ -30,6 +30,7 @@
 #include "QwLinearDiodeArray.h"
 #include "VQwClock.h"
 #include "QwBeamDetectorID.h"
+#include "QwSubbankDecodeMap.h"
 
 
 /*****************************************************************
@@ -40,11 +41,16 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
  private:
   /// Private default constructor (not implemented, will throw linker error on use)
   QwBeamLine();
+  /// Private assignment (not implemented, will throw linker error on use);
+  /// operator=(VQwSubsystem*) copies the data of the elements in place,
+  /// which keeps the decode map valid
+  QwBeamLine& operator=(const QwBeamLine& source);
 
  public:
   /// Constructor with name
   QwBeamLine(const TString& name)
-  : VQwSubsystem(name),VQwSubsystemParity(name)
+  : VQwSubsystem(name),VQwSubsystemParity(name),
+    fDeviceLayout(0)
   { };
   /// Copy constructor
   QwBeamLine(const QwBeamLine& source)
@@ -54,8 +60,12 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
     fCavity(source.fCavity),
     fHaloMonitor(source.fHaloMonitor),
     fECalculator(source.fECalculator),
-    fBeamDetectorID(source.fBeamDetectorID)
-  { this->CopyTemplatedDataElements(&source); }
+    fBeamDetectorID(source.fBeamDetectorID),
+    fDeviceLayout(source.fDeviceLayout)
+  {
+    this->CopyTemplatedDataElements(&source);
+    BuildSubbankDecodeMap();
+  }
   /// Virtual destructor
   virtual ~QwBeamLine() { };
 
@@ -81,6 +91,11 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
   //update the error flag in the subsystem level from the top level routines related to stability checks. This will uniquely update the errorflag at each channel based on the error flag in the corresponding channel in the ev_error subsystem
   void UpdateErrorFlag(const VQwSubsystem *ev_error);
 
+  //add the error counters of the corresponding channels in the source subsystem
+  void MergeErrorCounters(const VQwSubsystem *source);
+  Bool_t PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
+
   Int_t  ProcessConfigurationBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
   Int_t  ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
   void   PrintDetectorID() const;
@@ -172,6 +187,12 @@ protected:
   //when the type and the name is passed the detector index from appropriate vector will be returned
   //for example if TypeID is bcm  then the index of the detector from fBCM vector for given name will be returnd.
 
+  /// \brief Collect the decoded devices of each subbank into fSubbankDecodeMap
+  void BuildSubbankDecodeMap();
+
+  /// \brief Check that the templated devices have the same types as in input
+  Bool_t CompareDeviceTypes(const QwBeamLine* input) const;
+
   std::vector <VQwBPM_ptr> fStripline;
   std::vector <VQwBPM_ptr> fBPMCombo;
 
@@ -188,10 +209,16 @@ protected:
 
   std::vector <QwEnergyCalculator> fECalculator;
   std::vector <QwBeamDetectorID> fBeamDetectorID;
+  /// Devices read out in each subbank, resolved from fBeamDetectorID
+  QwSubbankDecodeMap fSubbankDecodeMap;
 
   std::vector<TString> fStoredBCMs;
   std::vector<TString> fStoredBPMs;
 
+  /// Layout of the templated devices, shared by all copies of a channel map
+  UInt_t fDeviceLayout;
+  static UInt_t fNextDeviceLayout;
+
 /////
 private:
   // std::vector<TString> DetectorTypes;// for example could be BCM, LUMI,BPMSTRIPLINE, etc..
@@ -18,6 +18,8 @@
 #include "VQwSubsystemParity.h"
 #include "QwIntegrationPMT.h"
 #include "QwCombinedPMT.h"
+#include "QwSubbankDecodeMap.h"
+#include "QwExternalValue.h"
 
 // Forward declarations
 class QwBlinder;
@@ -37,6 +39,10 @@ class QwBlindDetectorArray:
  private:
   /// Private default constructor (not implemented, will throw linker error on use)
   QwBlindDetectorArray();
+  /// Private assignment (not implemented, will throw linker error on use);
+  /// operator=(VQwSubsystem*) copies the data of the elements in place,
+  /// which keeps the decode map valid
+  QwBlindDetectorArray& operator=(const QwBlindDetectorArray& source);
 
  public:
   /// Constructor with name
@@ -56,7 +62,7 @@ class QwBlindDetectorArray:
     fIntegrationPMT(source.fIntegrationPMT),
     fCombinedPMT(source.fCombinedPMT),
     fMainDetID(source.fMainDetID)
-  { }
+  { BuildSubbankDecodeMap(); }
   /// Virtual destructor
   virtual ~QwBlindDetectorArray() { };
 
@@ -78,6 +84,11 @@ class QwBlindDetectorArray:
   //update the error flag in the subsystem level from the top level routines related to stability checks. This will uniquely update the errorflag at each channel based on the error flag in the corresponding channel in the ev_error subsystem
   void UpdateErrorFlag(const VQwSubsystem *ev_error);
 
+  //add the error counters of the corresponding channels in the source subsystem
+  void MergeErrorCounters(const VQwSubsystem *source);
+  Bool_t PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
+
 
   Int_t ProcessConfigurationBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
   Int_t ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
@@ -86,6 +97,7 @@ class QwBlindDetectorArray:
   Bool_t IsGoodEvent();
 
   void  ProcessEvent();
+  void  ResolveExternalValues();
   void  ExchangeProcessedData();
   void  ProcessEvent_2();
 
@@ -172,9 +184,14 @@ class QwBlindDetectorArray:
  // the detector from fIntegrationPMT vector for given name will be returnd.
  Int_t GetDetectorIndex(EQwPMTInstrumentType TypeID, TString name);
 
+ /// \brief Collect the PMTs of each subbank into fSubbankDecodeMap
+ void BuildSubbankDecodeMap();
+
   std::vector <QwIntegrationPMT> fIntegrationPMT;
   std::vector <QwCombinedPMT> fCombinedPMT;
   std::vector <QwBlindDetectorArrayID> fMainDetID;
+  /// PMTs read out in each subbank, resolved from fMainDetID
+  QwSubbankDecodeMap fSubbankDecodeMap;
 
 /*
 *	Maybe have an array of QwIntegrationPMT to describe the Sector, Ring, Slice structure?  Maybe hold Ring 5 out and have it described as one list by Sector and slice?
@@ -194,6 +211,14 @@ class QwBlindDetectorArray:
   QwBeamAngle    fTargetYprime;
   QwBeamEnergy   fTargetEnergy;
 
+  // Published beam parameters, looked up in ResolveExternalValues
+  QwExternalValue<VQwHardwareChannel> fTargetChargeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetXHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetYHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetXprimeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetYprimeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetEnergyHandle;
+
   Bool_t bIsExchangedDataValid;
 
   Bool_t bNormalization;
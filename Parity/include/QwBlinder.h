@@ -22,6 +22,7 @@
 #include "QwSubsystemArrayParity.h"
 #include "QwEPICSEvent.h"
 #include "QwTypes.h"
+#include "QwExternalValue.h"
 
 // Forward declarations
 #ifdef __USE_DATABASE__
@@ -227,6 +228,9 @@ class QwBlinder {
 
     Double_t fBeamCurrentThreshold;
     Bool_t fBeamIsPresent;
+    /// Target charge, bound to the subsystem array it was looked up in
+    QwExternalValue<VQwHardwareChannel> fTargetCharge;
+    const QwSubsystemArrayParity* fTargetChargeSource;
 
     EQwBlinderStatus CheckBlindability(std::vector<Int_t> &fCounters);
     Bool_t fBlinderIsOkay;
@@ -75,6 +75,24 @@ class QwClock : public VQwClock {
   void UpdateErrorFlag(const QwClock *ev_error){
     fClock.UpdateErrorFlag(ev_error->fClock);
   }
+  void PackEventData(std::vector<Double_t>& buffer) const {
+    if (this->GetElementName()!=""){
+      fClock.PackEventData(buffer);
+      buffer.push_back(fPedestal);
+      buffer.push_back(fCalibration);
+    }
+  };
+  void UnpackEventData(const Double_t*& data){
+    if (this->GetElementName()!=""){
+      fClock.UnpackEventData(data);
+      fPedestal = *data++;
+      fCalibration = *data++;
+    }
+  };
+  void MergeErrorCounters(const VQwClock *source){
+    const QwClock<T>* input = dynamic_cast<const QwClock<T>*>(source);
+    if (input!=NULL) fClock.MergeErrorCounters(input->fClock);
+  }
 
   /*! \brief Inherited from VQwDataElement to set the upper and lower limits (fULimit and fLLimit), stability % and the error flag on this channel */
   void SetSingleEventCuts(UInt_t errorflag, Double_t min = 0, Double_t max = 0, Double_t stability = 0);
@@ -51,7 +51,8 @@ class QwCombinedBCM : public QwBCM<T> {
     InitializeChannel(subsystemname, name,type,"raw");
   };
   QwCombinedBCM(const QwCombinedBCM& source)
-  : QwBCM<T>(source)
+  : QwBCM<T>(source),
+    fTmpADC(source.fTmpADC)
   { }
   virtual ~QwCombinedBCM() { };
 
@@ -123,6 +124,9 @@ class QwCombinedBCM : public QwBCM<T> {
   Double_t fTripRamp;
   Double_t fProbabilityOfTrip;
 
+  /// Scratch channel of ProcessEvent, set up once in InitializeChannel
+  mutable T fTmpADC;
+
  protected:
   /// \name Parity mock data generation
   // @{
@@ -59,7 +59,10 @@ class QwCombinedBPM : public VQwBPM {
     fIntercept(source.fIntercept),
     fMinimumChiSquare(source.fMinimumChiSquare),
     fAbsPos(source.fAbsPos),
-    fEffectiveCharge(source.fEffectiveCharge)
+    fEffectiveCharge(source.fEffectiveCharge),
+    fTmpQADC(source.fTmpQADC),
+    fTmp1(source.fTmp1),fTmp2(source.fTmp2),fTmp3(source.fTmp3),
+    fC(source.fC),fE(source.fE)
   { }
   virtual ~QwCombinedBPM() { };
 
@@ -116,6 +119,9 @@ class QwCombinedBPM : public VQwBPM {
   UInt_t  GetEventcutErrorFlag();
   UInt_t  UpdateErrorFlag();
   void UpdateErrorFlag(const VQwBPM *ev_error);
+  void MergeErrorCounters(const VQwBPM *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
 
   void    SetBPMForCombo(const VQwBPM* bpm, Double_t charge_weight,  Double_t x_weight, Double_t y_weight,Double_t sumqw);
@@ -217,6 +223,12 @@ class QwCombinedBPM : public VQwBPM {
   T fAbsPos[2];
   T fEffectiveCharge;
 
+  //  Scratch channels of ProcessEvent, LeastSquareFit and
+  //  RandomizeEventData, set up once in InitializeChannel
+  mutable T fTmpQADC;
+  mutable T fTmp1, fTmp2, fTmp3;
+  mutable T fC[2], fE[2];
+
 private: 
   // Functions to be removed
   void    MakeBPMComboList();
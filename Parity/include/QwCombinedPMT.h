@@ -36,7 +36,8 @@ class QwCombinedPMT : public VQwDataElement {
     fCalibration(source.fCalibration),
     fElement(source.fElement),
     fWeights(source.fWeights),
-    fSumADC(source.fSumADC)
+    fSumADC(source.fSumADC),
+    fTmpADC(source.fTmpADC)
   { }
   virtual ~QwCombinedPMT() { };
 
@@ -88,6 +89,9 @@ class QwCombinedPMT : public VQwDataElement {
 
   UInt_t UpdateErrorFlag();
   void   UpdateErrorFlag(const QwCombinedPMT *ev_error);
+  void   MergeErrorCounters(const QwCombinedPMT *source);
+  void   PackEventData(std::vector<Double_t>& buffer) const;
+  void   UnpackEventData(const Double_t*& data);
 
   void PrintInfo() const;
   void PrintValue() const;
@@ -143,6 +147,9 @@ class QwCombinedPMT : public VQwDataElement {
   QwIntegrationPMT  fSumADC;
   //QwIntegrationPMT  fAvgADC;
 
+  /// Scratch device of CalculateSumAndAverage, set up once in InitializeChannel
+  mutable QwIntegrationPMT fTmpADC;
+
   Int_t fDevice_flag; /// sets the event cut level for the device
                       /// fDevice_flag=1 Event cuts & HW check,
                       /// fDevice_flag=0 HW check, fDevice_flag=-1 no check
@@ -87,7 +87,11 @@ class QwComptonElectronDetector:
       fPWTL2(source.fPWTL2),
       fHoldOff(source.fHoldOff),
       fPipelineDelay(source.fPipelineDelay)
-   { }
+   {
+     // Keep the tree layout of the source
+     fTreeArrayIndex = source.fTreeArrayIndex;
+     fIsConfigOnly = source.fIsConfigOnly;
+   }
     /// Virtual destructor
     virtual ~QwComptonElectronDetector() { };
 
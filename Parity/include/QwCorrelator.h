@@ -42,6 +42,11 @@ class QwCorrelator : public VQwDataHandler {
     Int_t ConnectChannels(QwSubsystemArrayParity& asym, QwSubsystemArrayParity& diff);
 		
 		void unpackEvent();
+
+    /// \brief Append the accumulators of the correlator to a buffer
+    void PackAccumulators(std::vector<Double_t>& buffer) const;
+    /// \brief Merge accumulators of another part of the run from a buffer
+    void MergeAccumulators(const Double_t*& data);
 		
 		Int_t LoadChannelMap(const std::string& mapfile);
 		
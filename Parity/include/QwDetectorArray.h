@@ -18,6 +18,8 @@
 #include "VQwSubsystemParity.h"
 #include "QwIntegrationPMT.h"
 #include "QwCombinedPMT.h"
+#include "QwSubbankDecodeMap.h"
+#include "QwExternalValue.h"
 
 
 // Forward declarations
@@ -37,6 +39,10 @@ class QwDetectorArray:
  private:
   /// Private default constructor (not implemented, will throw linker error on use)
   QwDetectorArray();
+  /// Private assignment (not implemented, will throw linker error on use);
+  /// operator=(VQwSubsystem*) copies the data of the elements in place,
+  /// which keeps the decode map valid
+  QwDetectorArray& operator=(const QwDetectorArray& source);
 
  public:
   /// Constructor with name
@@ -56,7 +62,7 @@ class QwDetectorArray:
     fIntegrationPMT(source.fIntegrationPMT),
     fCombinedPMT(source.fCombinedPMT),
     fMainDetID(source.fMainDetID)
-  { }
+  { BuildSubbankDecodeMap(); }
   /// Virtual destructor
   virtual ~QwDetectorArray() { };
 
@@ -78,6 +84,11 @@ class QwDetectorArray:
   //update the error flag in the subsystem level from the top level routines related to stability checks. This will uniquely update the errorflag at each channel based on the error flag in the corresponding channel in the ev_error subsystem
   void UpdateErrorFlag(const VQwSubsystem *ev_error);
 
+  //add the error counters of the corresponding channels in the source subsystem
+  void MergeErrorCounters(const VQwSubsystem *source);
+  Bool_t PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
+
 
   Int_t ProcessConfigurationBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
   Int_t ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
@@ -86,6 +97,7 @@ class QwDetectorArray:
   Bool_t IsGoodEvent();
 
   void  ProcessEvent();
+  void  ResolveExternalValues();
   void  ExchangeProcessedData();
   void  ProcessEvent_2();
 
@@ -166,9 +178,14 @@ class QwDetectorArray:
  // the detector from fIntegrationPMT vector for given name will be returnd.
  Int_t GetDetectorIndex(EQwPMTInstrumentType TypeID, TString name);
 
+ /// \brief Collect the PMTs of each subbank into fSubbankDecodeMap
+ void BuildSubbankDecodeMap();
+
   std::vector <QwIntegrationPMT> fIntegrationPMT;
   std::vector <QwCombinedPMT> fCombinedPMT;
   std::vector <QwDetectorArrayID> fMainDetID;
+  /// PMTs read out in each subbank, resolved from fMainDetID
+  QwSubbankDecodeMap fSubbankDecodeMap;
 
 
   std::vector<TString> fStoredDets;
@@ -191,6 +208,14 @@ class QwDetectorArray:
   QwBeamAngle    fTargetYprime;
   QwBeamEnergy   fTargetEnergy;
 
+  // Published beam parameters, looked up in ResolveExternalValues
+  QwExternalValue<VQwHardwareChannel> fTargetChargeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetXHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetYHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetXprimeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetYprimeHandle;
+  QwExternalValue<VQwHardwareChannel> fTargetEnergyHandle;
+
   Bool_t bIsExchangedDataValid;
 
   Bool_t bNormalization;
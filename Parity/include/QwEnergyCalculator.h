@@ -46,7 +46,8 @@ class QwEnergyCalculator : public VQwDataElement{
     InitializeChannel(subsystem, name,"derived");
   };
   QwEnergyCalculator(const QwEnergyCalculator& source)
-  : VQwDataElement(source),fEnergyChange(source.fEnergyChange)
+  : VQwDataElement(source),fEnergyChange(source.fEnergyChange),
+    fTmp(source.fTmp)
   { }
   virtual ~QwEnergyCalculator() { };
 
@@ -90,6 +91,9 @@ class QwEnergyCalculator : public VQwDataElement{
     UInt_t   UpdateErrorFlag();
 
     void    UpdateErrorFlag(const QwEnergyCalculator *ev_error);
+    void    MergeErrorCounters(const QwEnergyCalculator *source);
+    void    PackEventData(std::vector<Double_t>& buffer) const;
+    void    UnpackEventData(const Double_t*& data);
   
 
     void    Set(const VQwBPM* device,TString type, TString property ,Double_t tmatrix_ratio);
@@ -127,6 +131,9 @@ class QwEnergyCalculator : public VQwDataElement{
 
  protected:
     QwVQWK_Channel fEnergyChange;
+    /// Scratch channel of ProcessEvent and GetProjectedPosition, set up
+    /// once in InitializeChannel
+    mutable QwVQWK_Channel fTmp;
 
 
  private:
@@ -0,0 +1,97 @@
+/**********************************************************\
+* File: QwEventPipeline.h                                  *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#ifndef __QwEventPipeline__
+#define __QwEventPipeline__
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "QwSubsystemArrayParity.h"
+
+class QwOptions;
+
+/**
+ *  \class QwEventPipeline
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Hands processed events to an analysis stage on its own thread
+ *
+ *  The event loop is split in two stages which run concurrently: the
+ *  processing stage (decoding, ProcessEvent and the single event cuts)
+ *  stays on the calling thread, and the analysis stage (event ring,
+ *  helicity pattern, histograms, trees and data handlers) runs on a
+ *  second thread.  Events are passed in order through a bounded queue
+ *  of copies of the subsystem array, so each stage sees exactly the
+ *  sequence of events of the serial loop and the output is identical.
+ *
+ *  The subsystems keep state from one event to the next (helicity
+ *  prediction, hardware checks against the previous event, differential
+ *  scalers), so events cannot be processed out of order by independent
+ *  workers; raw events are read ahead by QwEventBuffer instead.
+ *
+ *  Work that must see the analysis stage idle, such as EPICS events
+ *  which update the blinder, calls Drain() first.
+ */
+class QwEventPipeline {
+
+ public:
+  /// Analysis stage, called in order for each event
+  typedef std::function<void(QwSubsystemArrayParity&)> Stage_t;
+
+ public:
+  QwEventPipeline(QwOptions &options, QwSubsystemArrayParity &event);
+  virtual ~QwEventPipeline() { Stop(); };
+
+  /// \brief Define options
+  static void DefineOptions(QwOptions &options);
+  /// \brief Process options
+  void ProcessOptions(QwOptions &options);
+
+  /// Number of threads requested for the event loop
+  Int_t GetNumberOfThreads() const { return fNumberOfThreads; };
+  /// Does the analysis stage run on its own thread?
+  Bool_t IsEnabled() const { return fNumberOfThreads > 1; };
+
+  /// \brief Set the analysis stage and start its thread, if enabled
+  void Start(const Stage_t& analyze);
+  /// \brief Pass an event to the analysis stage
+  void Push(QwSubsystemArrayParity &event);
+  /// \brief Wait until the analysis stage has handled all queued events
+  void Drain();
+  /// \brief Handle the remaining events and stop the analysis stage thread
+  void Stop();
+
+ private:
+  QwEventPipeline();
+  QwEventPipeline(const QwEventPipeline&);
+
+  /// Body of the analysis stage thread
+  void Loop();
+
+  Int_t fNumberOfThreads;   ///< Threads requested with --threads
+  Int_t fDepth;             ///< Number of events in the queue
+
+  std::vector<QwSubsystemArrayParity> fSlots;
+  size_t fHead;             ///< Next slot to be filled
+  size_t fTail;             ///< Next slot to be analyzed
+  size_t fFilled;           ///< Slots filled and not yet analyzed
+  Bool_t fStop;             ///< No more events will be pushed
+
+  Stage_t fAnalyze;
+  std::thread fThread;
+  std::mutex fMutex;
+  std::condition_variable fNotFull;
+  std::condition_variable fNotEmpty;
+  std::condition_variable fEmpty;
+
+};
+
+#endif
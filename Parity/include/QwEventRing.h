@@ -9,8 +9,10 @@
 #define __QwEventRing__
 
 #include <vector>
+#include <deque>
 
 #include <fstream>
+#include <boost/shared_ptr.hpp>
 #include "QwSubsystemArrayParity.h"
 
 class QwEventRing {
@@ -20,6 +22,26 @@ class QwEventRing {
  *  Description : The event buffer to reduce  beam trips effects on running 
  *  averages.
  *
+ *  By default the events are stored in compact form, as the values
+ *  copied by the assignment operator, and pop() restores the oldest
+ *  one into a single event object.  Subsystems that do not support
+ *  packing are stored as copies.  With ring.full_copy, each slot holds
+ *  a full copy of the subsystem array and pop() returns the slot.
+ *
+ *  The reference returned by pop() stays valid until the next call to
+ *  push(), so the caller can analyze the event in place.  Error
+ *  counters are then incremented in the event objects and must be
+ *  collected at the end of the run with CollectErrorCounters().  To
+ *  fill histograms and trees from the event objects, construct the ring
+ *  from an object for which the histograms and tree branches have been
+ *  constructed.
+ *
+ *  Stability cut failures and beam trips flag every event in the ring.
+ *  Instead of updating all slots on push(), each failure is recorded
+ *  as a mark in a log, and the marks since an event was pushed are
+ *  applied to it when it is popped.  Only the two newest events, which
+ *  are needed for the beam trip check, are updated on push().
+ *
  ******************************************************************/
  private:
   QwEventRing();
@@ -42,6 +64,19 @@ class QwEventRing {
   /// \brief Return the read status of the ring
   Bool_t IsReady();
 
+  /// \brief Share the histograms of the source with all slots in the ring
+  void ShareHistograms(const QwSubsystemArrayParity& source);
+  /// \brief Return the number of slots in the ring
+  Int_t GetRingSize() const { return fRING_SIZE; };
+  /// \brief Return the number of event objects that pop() can return
+  Int_t GetNumberOfEvents() const { return fEvent_Ring.size(); };
+  /// \brief Return an event object that pop() can return
+  const QwSubsystemArrayParity& GetEvent(Int_t index) const { return fEvent_Ring.at(index); };
+
+  /// \brief Copy the last event read from the ring and the error counters
+  ///        of all slots into the output
+  void CollectErrorCounters(QwSubsystemArrayParity& output) const;
+
  private:
 
   Int_t fRING_SIZE;//this is the length of the ring
@@ -49,6 +84,7 @@ class QwEventRing {
 
   Int_t fNextToBeFilled;//counts events in the ring
   Int_t fNextToBeRead;//keep track off when to read next from the ring.
+  Int_t fLastRead;//last slot returned by pop(), or -1
 
   
   Bool_t bEVENT_READY; //If kTRUE, the good events are added to the event ring. After a beam trip this is set to kFALSE
@@ -56,7 +92,28 @@ class QwEventRing {
 
   Bool_t bRING_READY; //set to true after ring is filled with good events and time to process them. Set to kFALSE after processing 
   //all the events in the ring
+  //Full events: the slots of the ring, or only the event returned by pop() in compact storage
   std::vector<QwSubsystemArrayParity> fEvent_Ring;
+
+  //Compact storage of the events
+  Bool_t bCompact;
+  struct PackedEvent_t {
+    UInt_t fErrorFlag; ///< Global error flag of the event
+    std::vector<Double_t> fData; ///< Event data of the subsystems which support packing
+    std::vector< boost::shared_ptr<VQwSubsystem> > fSubsystems; ///< Copies of the other subsystems
+  };
+  std::vector<PackedEvent_t> fPacked_Ring;
+  std::vector<size_t> fUnpackedSubsystems;//indices of the subsystems stored as copies
+  boost::shared_ptr<QwSubsystemArrayParity> fScratch;//to update the flags of packed events
+
+  /// \brief Allocate the storage of the ring
+  void InitializeRing(QwSubsystemArrayParity &event);
+  /// \brief Store an event in compact form
+  void PackEvent(const QwSubsystemArrayParity& event, Int_t slot);
+  /// \brief Restore an event from compact form
+  void UnpackEvent(Int_t slot, QwSubsystemArrayParity& event);
+  /// \brief Return the global error flag of the event in a slot
+  UInt_t GetEventcutErrorFlag(Int_t slot) const;
   //to track all the rolling averages for stability checks
   QwSubsystemArrayParity fRollingAvg;
   
@@ -68,6 +125,66 @@ class QwEventRing {
   //State of the stability check - ON/OFF
   Bool_t bStability;
 
+  /// Error flags of the rolling average
+  struct ErrorFlags_t {
+    std::vector<UInt_t> fWords; ///< Error flags at the flag positions of the packed events
+    std::vector< boost::shared_ptr<VQwSubsystem> > fSubsystems; ///< Copies of the other subsystems
+  };
+  /// Error flags to be applied to the events in the ring
+  struct FlagMark_t {
+    Bool_t fStability; ///< A stability cut failed
+    Bool_t fBeamTrip;  ///< A beam trip was seen after the last stability cut failure
+    boost::shared_ptr<ErrorFlags_t> fFlags; ///< Error flags of the rolling average, if fStability
+  };
+
+  /// \brief Find where the error flags are in the packed events
+  void InitializeFlags(const QwSubsystemArrayParity& event);
+  /// \brief Store the error flags of an event
+  void StoreFlags(ErrorFlags_t& flags, const QwSubsystemArrayParity& event);
+  /// \brief Combine later error flags into earlier ones
+  void CombineFlags(ErrorFlags_t& earlier, const ErrorFlags_t& later);
+  /// \brief Update the error flags of an event with stored error flags
+  void ApplyFlags(QwSubsystemArrayParity& event, const ErrorFlags_t& flags);
+
+  /// \brief Apply a mark to an event
+  void ApplyMark(QwSubsystemArrayParity& event, const FlagMark_t& mark);
+  /// \brief Apply the marks added since the last flip to a slot
+  void ApplyNewMarks(Int_t slot);
+  /// \brief Apply all marks not yet applied to the oldest slot to its event
+  void ApplyPendingMarks(Int_t slot, QwSubsystemArrayParity& event);
+  /// \brief Add a mark to the log
+  void AddMark(const FlagMark_t& mark);
+  /// \brief Combine a later mark into an earlier one
+  void CombineMarks(FlagMark_t& earlier, const FlagMark_t& later);
+  /// \brief Move the new marks to the old marks, combined from the back
+  void FlipMarks();
+  /// \brief Drop old marks before the given mark index
+  void ExpireMarks(Long64_t first);
+  /// \brief Get error flag storage from the pool
+  boost::shared_ptr<ErrorFlags_t> AcquireFlags();
+  /// \brief Return error flag storage to the pool
+  void ReleaseFlags(FlagMark_t& mark);
+
+  // The log of marks is kept as two stacks: the old marks, each combined
+  // with all later old marks, and the new marks with their combination.
+  // The marks pending for the oldest slot are then one old mark and the
+  // combined new marks.
+  std::deque<FlagMark_t> fOldMarks;
+  std::vector<FlagMark_t> fNewMarks;
+  FlagMark_t fNewMarksCombined;
+  Long64_t fOldMarksStart;//index of the first old mark
+  Long64_t fNewMarksStart;//index of the first new mark
+  Long64_t fMarkCount;//number of marks added
+  std::vector<Long64_t> fSlotMark;//index of the first mark not applied to each slot
+  std::vector< boost::shared_ptr<ErrorFlags_t> > fFreeFlags;
+
+  // The marks keep only the error flags of the rolling average: the
+  // values which UpdateErrorFlag ORs, at their positions in the packed
+  // events, and copies of the subsystems which are not packed.
+  std::vector<size_t> fFlagSlots;//positions of the error flags in the packed events
+  std::vector<size_t> fFlagSubsystems;//indices of the subsystems whose flags are copied
+  std::vector<Double_t> fFlagBuffer;//to update the flags of full events
+
 };
 
 
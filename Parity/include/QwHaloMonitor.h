@@ -92,6 +92,15 @@ class  QwHaloMonitor : public VQwDataElement{
   void UpdateErrorFlag(const QwHaloMonitor *ev_error){
     fHalo_Counter.UpdateErrorFlag(ev_error->fHalo_Counter);
   };
+  void PackEventData(std::vector<Double_t>& buffer) const {
+    if (GetElementName()!="") fHalo_Counter.PackEventData(buffer);
+  };
+  void UnpackEventData(const Double_t*& data){
+    if (GetElementName()!="") fHalo_Counter.UnpackEventData(data);
+  };
+  void MergeErrorCounters(const QwHaloMonitor *source){
+    fHalo_Counter.MergeErrorCounters(source->fHalo_Counter);
+  };
 
   void PrintErrorCounters() const;// report number of events failed due to HW and event cut faliure
   Bool_t ApplyHWChecks();
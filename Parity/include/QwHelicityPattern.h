@@ -10,6 +10,9 @@
 // System headers
 #include <vector>
 
+// Boost headers
+#include <boost/shared_ptr.hpp>
+
 // ROOT headers
 #include <TTree.h>
 
@@ -24,6 +27,7 @@
 
 // Forward declarations
 class QwHelicity;
+class QwPackedPattern;
 
 ///
 /// \ingroup QwAnalysis_ADC
@@ -50,6 +54,9 @@ class QwHelicityPattern {
   static void DefineOptions(QwOptions &options);
   /// \brief Process the configuration options
   void ProcessOptions(QwOptions &options);
+  /// \brief Calculate the pattern from packed copies of the events
+  void EnablePackedPattern(Bool_t enable = kTRUE);
+  Bool_t IsPackedPatternEnabled() const { return fPackedPattern.get() != 0; };
 
   void  LoadEventData(QwSubsystemArrayParity &event);
   Bool_t HasDataLoaded() const { return fIsDataLoaded; };
@@ -57,6 +64,7 @@ class QwHelicityPattern {
   Bool_t PairAsymmetryIsGood();
   Bool_t NextPairIsComplete();
   void   CalculatePairAsymmetry();
+  void   CalculatePairDifference(size_t plusevt, size_t minusevt);
   void   ClearPairData(){fPairYield.ClearEventData();fPairDifference.ClearEventData(); fPairAsymmetry.ClearEventData();}
 
   Bool_t IsCompletePattern() const;
@@ -128,6 +136,10 @@ class QwHelicityPattern {
   void  AccumulateRunningSum(){AccumulateRunningSum(*this);};
   void  AccumulateRunningSum(QwHelicityPattern &entry);
   void  AccumulatePairRunningSum(QwHelicityPattern &entry);
+  /// \brief Append the running sums to a buffer
+  void  PackRunningSum(std::vector<Double_t> &buffer) const;
+  /// \brief Merge the running sums of another part of the run from a buffer
+  void  MergeRunningSum(const Double_t* &data);
 
   void  CalculateBurstAverage();
   void  CalculateRunningBurstAverage();
@@ -170,6 +182,10 @@ class QwHelicityPattern {
 
   void ProcessDataHandlerEntry();
   void FinishDataHandler();
+  /// \brief Append the accumulators of the data handlers to a buffer
+  void PackDataHandlers(std::vector<Double_t> &buffer) const;
+  /// \brief Merge the data handler accumulators of another part of the run
+  void MergeDataHandlers(const Double_t* &data);
 
   LRBCorrector& return_regress_from_LRB() {
     return regress_from_LRB;
@@ -184,12 +200,26 @@ class QwHelicityPattern {
  protected:
   Bool_t fDEBUG;
 
-  //  QwHelicity* fHelicitySubsystem;
+  /// \brief Find the helicity subsystem in the array and remember its index
+  QwHelicity* BindHelicitySubsystem(QwSubsystemArrayParity& event);
+  /// \brief Helicity subsystem of an event array with the bound layout
+  QwHelicity* GetHelicitySubsystem(QwSubsystemArrayParity& event);
+
+  /// Index of the helicity subsystem in the subsystem arrays, or -1.
+  /// All events passed to LoadEventData are copies of the array given to
+  /// the constructor, so the helicity subsystem is at the same index in each.
+  Int_t fHelicitySubsystemIndex;
 
+  /// Events of the pattern; with packed events, only the subsystems which
+  /// are not packed are copied, unless the alternate asymmetries need all
   std::vector<QwSubsystemArrayParity> fEvents;
   std::vector<Bool_t> fEventLoaded;
   std::vector<Int_t> fHelicity;// this is here up to when we code the Helicity decoding routine
   std::vector<Int_t> fEventNumber;
+  /// Helicity sign (+1 or -1) of each phase, when summed from packed events
+  std::vector<Int_t> fPhaseSign;
+  /// Packed copies of the events, if enabled
+  boost::shared_ptr<QwPackedPattern> fPackedPattern;
   Int_t fCurrentPatternNumber;
   Int_t fPatternSize;
   Int_t fQuartetNumber;
@@ -107,6 +107,9 @@ void RandomizeMollerEvent(int helicity, const QwBeamCharge& charge, const QwBeam
 
   UInt_t UpdateErrorFlag() {return GetEventcutErrorFlag();};
   void UpdateErrorFlag(const QwIntegrationPMT *ev_error);
+  void MergeErrorCounters(const QwIntegrationPMT *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
   void SetEventCutMode(Int_t bcuts){
     bEVENTCUTMODE=bcuts;
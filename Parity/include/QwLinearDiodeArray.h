@@ -44,7 +44,9 @@ class QwLinearDiodeArray : public VQwBPM {
   };    
   QwLinearDiodeArray(const QwLinearDiodeArray& source)
   : VQwBPM(source),
-    fEffectiveCharge(source.fEffectiveCharge)
+    fEffectiveCharge(source.fEffectiveCharge),
+    fMean(source.fMean),fMeanSqr(source.fMeanSqr),
+    fTmp(source.fTmp),fTmp2(source.fTmp2)
   {
     for (size_t i = 0; i < 2; i++) {
       fRelPos[i] = source.fRelPos[i];
@@ -97,6 +99,9 @@ class QwLinearDiodeArray : public VQwBPM {
   UInt_t GetEventcutErrorFlag();
   UInt_t UpdateErrorFlag();
   void UpdateErrorFlag(const VQwBPM *ev_error);
+  void MergeErrorCounters(const VQwBPM *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
   void    SetDefaultSampleSize(Int_t sample_size);
   void    SetRandomEventParameters(Double_t meanX, Double_t sigmaX, Double_t meanY, Double_t sigmaY);
@@ -162,6 +167,10 @@ class QwLinearDiodeArray : public VQwBPM {
   QwVQWK_Channel fAbsPos[2];
   QwVQWK_Channel fEffectiveCharge;
 
+  //  Scratch channels of ProcessEvent, set up once in InitializeChannel
+  mutable QwVQWK_Channel fMean, fMeanSqr;
+  mutable QwVQWK_Channel fTmp, fTmp2;
+
   std::vector<QwVQWK_Channel> fLinearArrayElementList;
 
 };
@@ -19,6 +19,8 @@
 
 // Qweak headers
 #include "QwEventRing.h"
+#include "QwEventPipeline.h"
+#include "QwRunChunks.h"
 #include "QwHelicity.h"
 #include "QwHelicityPattern.h"
 #include "VQwDataHandler.h"
@@ -40,6 +42,8 @@ void DefineOptionsParity(QwOptions& options)
   QwDetectorArray::DefineOptions(options);
   QwBlindDetectorArray::DefineOptions(options);
   QwEventRing::DefineOptions(options);
+  QwEventPipeline::DefineOptions(options);
+  QwRunChunks::DefineOptions(options);
   QwHelicity::DefineOptions(options);
   QwHelicityPattern::DefineOptions(options);
   LRBCorrector::DefineOptions(options);
@@ -0,0 +1,140 @@
+/**********************************************************\
+* File: QwPackedPattern.h                                  *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#ifndef __QwPackedPattern__
+#define __QwPackedPattern__
+
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+#include "Rtypes.h"
+
+class QwSubsystemArrayParity;
+
+/**
+ *  \class QwPackedPattern
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Events of a helicity pattern in contiguous arrays
+ *
+ *  The events of a pattern are stored with PackEventData, which writes
+ *  the values of all channels of an array (block values, hardware sums,
+ *  second moments, error flags, ...) into one contiguous buffer.  The
+ *  helicity sums, the yield and the difference of the pattern are then
+ *  calculated as simple loops over these buffers, which the compiler can
+ *  vectorize, instead of walking the subsystems, devices and channels
+ *  with virtual calls for every operation.
+ *
+ *  What operator+=, operator-=, operator= and Scale do to each value of
+ *  the buffer (add, subtract, copy, keep, clear, combine error flags or
+ *  scale) is found once, at construction, by applying the operators of
+ *  the arrays to test values.  If any value does not behave like one of
+ *  these, the store is not valid and the arrays have to be used instead.
+ *  Subsystems which do not support packing are always handled by their
+ *  own operators.
+ */
+class QwPackedPattern {
+
+ public:
+  QwPackedPattern(const QwSubsystemArrayParity& event, Int_t pattern_size);
+  virtual ~QwPackedPattern() { };
+
+  /// Can the pattern be calculated from the packed events?
+  Bool_t IsValid() const { return fValid; };
+  /// Number of values per event
+  size_t GetSize() const { return fSize; };
+
+  /// \brief Store the event of a phase of the pattern
+  void LoadEventData(Int_t phase, const QwSubsystemArrayParity& event);
+  /// \brief Copy the subsystems which are not packed into an event
+  void CopyUnpackedData(const QwSubsystemArrayParity& event, QwSubsystemArrayParity& copy) const;
+
+  /// \brief Calculate the helicity sums, yield and difference of the pattern
+  void CalculateYieldAndDifference(
+      const std::vector<Int_t>& sign,
+      const std::vector<QwSubsystemArrayParity>& events,
+      QwSubsystemArrayParity& positive,
+      QwSubsystemArrayParity& negative,
+      QwSubsystemArrayParity& yield,
+      QwSubsystemArrayParity& difference,
+      Double_t scale);
+  /// \brief Calculate the scaled sum of two phases of the pattern
+  void CalculateSum(Int_t phase1, Int_t phase2,
+      const std::vector<QwSubsystemArrayParity>& events,
+      QwSubsystemArrayParity& sum, Double_t scale);
+  /// \brief Calculate the scaled difference of two phases of the pattern
+  void CalculateDifference(Int_t phase1, Int_t phase2,
+      const std::vector<QwSubsystemArrayParity>& events,
+      QwSubsystemArrayParity& difference, Double_t scale);
+
+ private:
+  QwPackedPattern();
+
+  /// Effect of an operator on a value of the buffer
+  enum EQwPackedOperation {
+    kUnknown = 0, kZero, kKeep, kCopy, kAdd, kSubtract, kOr, kScale, kScaleSquared
+  };
+  /// \brief Find the effect of an operator from the results for two test values
+  static EQwPackedOperation Classify(Double_t x, Double_t y, Double_t result, Double_t scale);
+  /// \brief Find the effect of the operators on each value of the buffer
+  Bool_t BuildOperations(const QwSubsystemArrayParity& event);
+
+  /// \brief Value, or +0 where the mask is clear, without a branch
+  static Double_t Mask(Double_t value, ULong64_t mask) {
+    ULong64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits &= mask;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  /// \brief Combine two buffers with the effect of operator+= or operator-=
+  void Combine(Double_t* out, const Double_t* x, const Double_t* y,
+      const std::vector<ULong64_t>& use_x, const std::vector<ULong64_t>& use_y,
+      const std::vector<Double_t>& sign_y, const std::vector<size_t>& or_slots);
+  /// \brief Scale a buffer with the effect of Scale
+  void Scale(Double_t* out, Double_t scale);
+
+  Bool_t fValid;
+  size_t fSize;
+
+  /// Packed events of the pattern
+  std::vector< std::vector<Double_t> > fEvents;
+
+  /// operator+=: out = (use_x? x: 0) + (use_y? sign_y * y: 0), with all
+  /// bits of use_x and use_y set or clear, and error flags are ORed
+  std::vector<ULong64_t> fAddUseX;
+  std::vector<ULong64_t> fAddUseY;
+  std::vector<Double_t>  fAddSignY;
+  std::vector<size_t>    fAddOr;
+  /// operator-=, in the same form
+  std::vector<ULong64_t> fSubUseX;
+  std::vector<ULong64_t> fSubUseY;
+  std::vector<Double_t>  fSubSignY;
+  std::vector<size_t>    fSubOr;
+  /// Scale: power of the factor (0, 1 or 2), or -1 to clear the value
+  std::vector<Int_t>     fScalePower;
+  std::vector<ULong64_t> fScaleKeep;
+  std::vector<Double_t>  fScaleFactor;
+  Double_t fScale;
+
+  /// Combined error flags, before they are written to the output
+  std::vector<UInt_t> fFlags;
+
+  /// Subsystems which are not packed
+  std::vector<size_t> fUnpacked;
+
+  /// Helicity sums, yield and difference of the current pattern
+  std::vector<Double_t> fPositive;
+  std::vector<Double_t> fNegative;
+  std::vector<Double_t> fYield;
+  std::vector<Double_t> fDifference;
+  /// Sum or difference of two phases
+  std::vector<Double_t> fPair;
+};
+
+#endif
@@ -52,7 +52,9 @@ class QwQPD : public VQwBPM {
     fPhotodiode(source.fPhotodiode),
     fRelPos(source.fRelPos),
     fAbsPos(source.fAbsPos),
-    fEffectiveCharge(source.fEffectiveCharge)
+    fEffectiveCharge(source.fEffectiveCharge),
+    fNumer(source.fNumer),
+    fTmp(source.fTmp),fTmp1(source.fTmp1),fTmp2(source.fTmp2)
   { }
   virtual ~QwQPD() { };
   
@@ -96,6 +98,9 @@ class QwQPD : public VQwBPM {
   UInt_t  GetEventcutErrorFlag();
   UInt_t  UpdateErrorFlag();
   void UpdateErrorFlag(const VQwBPM *ev_error);
+  void MergeErrorCounters(const VQwBPM *source);
+  void PackEventData(std::vector<Double_t>& buffer) const;
+  void UnpackEventData(const Double_t*& data);
 
   void    SetDefaultSampleSize(Int_t sample_size);
   void    SetRandomEventParameters(Double_t meanX, Double_t sigmaX, Double_t meanY, Double_t sigmaY);
@@ -161,6 +166,10 @@ class QwQPD : public VQwBPM {
   QwVQWK_Channel fAbsPos[2];
   QwVQWK_Channel fEffectiveCharge;
 
+  //  Scratch channels of ProcessEvent, set up once in InitializeChannel
+  mutable QwVQWK_Channel fNumer[2];
+  mutable QwVQWK_Channel fTmp, fTmp1, fTmp2;
+
   std::vector<QwVQWK_Channel> fQPDElementList;
 
 };
@@ -0,0 +1,113 @@
+/**********************************************************\
+* File: QwRunBatch.h                                       *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#ifndef __QwRunBatch__
+#define __QwRunBatch__
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "Rtypes.h"
+#include "TString.h"
+
+class QwOptions;
+class QwEventBuffer;
+
+/**
+ *  \class QwRunBatch
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Analyzes the runs and runlets of a batch in parallel processes
+ *
+ *  The runs and runlets (run segments which are analyzed separately) are
+ *  found with an event buffer, exactly as qwparity would step through
+ *  the --run range or --runlist.  Each of them becomes a job: a qwparity
+ *  process for that run and segment, with the remaining command line
+ *  options of the batch, so that every job has its own ROOT state and
+ *  output files.  Up to --batch.jobs jobs run at the same time; no job is
+ *  started while the fraction of CPU time waiting for I/O is above
+ *  --batch.max-iowait.  Failed jobs are retried --batch.retries times.
+ *
+ *  The output of each job goes to its own log file, and the batch
+ *  manifest lists every job with its status, attempts and run time.
+ *  The manifest is rewritten whenever a job finishes, so it also shows
+ *  the progress of the batch.
+ *
+ *  A job is done only when its process exits with status zero.  The jobs
+ *  run in their own process groups, so an interrupt of the batch does not
+ *  reach them directly: the batch stops them, and lists them as pending
+ *  rather than done.  A run list with several event ranges for a run is
+ *  rejected, since a job analyzes a single event range.
+ */
+class QwRunBatch {
+
+ public:
+  QwRunBatch(QwOptions &options);
+  virtual ~QwRunBatch() { };
+
+  /// \brief Define options
+  static void DefineOptions(QwOptions &options);
+  /// \brief Process options
+  void ProcessOptions(QwOptions &options);
+
+  /// \brief Add a job for each run or runlet of the event buffer, returns
+  ///        the number of jobs, or -1 if the runs cannot be split in jobs
+  Int_t AddJobs(QwEventBuffer &eventbuffer);
+  /// \brief Run all jobs, returns the number of failed jobs
+  Int_t Run();
+
+ private:
+  QwRunBatch();
+  QwRunBatch(const QwRunBatch&);
+
+  /// Status of a job
+  enum EQwJobStatus { kJobPending, kJobRunning, kJobDone, kJobFailed };
+
+  /// A run or runlet analyzed by a single process
+  struct Job_t {
+    Int_t fRun;                             ///< Run number
+    Int_t fSegment;                         ///< Segment, or -1 for the whole run
+    std::pair<Int_t, Int_t> fSegmentRange;  ///< Segments analyzed by the job
+    std::pair<UInt_t, UInt_t> fEventRange;  ///< Event range
+    EQwJobStatus fStatus;
+    Bool_t fInterrupted;                    ///< Stopped when the batch was interrupted
+    Int_t fAttempts;                        ///< Processes started
+    Int_t fExitCode;                        ///< Exit code of the last process
+    Int_t fPid;                             ///< Process, while running
+    Double_t fStartTime;                    ///< Start of the last process
+    Double_t fElapsed;                      ///< Wall time of the last process
+    TString fLogFile;
+  };
+
+  /// \brief Command line options passed on to each job
+  void SetCommandLine(QwOptions &options);
+  /// \brief Start the process of a job
+  Bool_t Start(Job_t& job);
+  /// \brief Update a job after its process finished
+  void Finished(Job_t& job, Int_t status);
+  /// \brief Fraction of CPU time waiting for I/O since the last call
+  Double_t GetIOWait();
+  /// \brief Write the manifest of the batch
+  void WriteManifest() const;
+
+  Int_t    fNumberOfJobs;     ///< Jobs running at the same time
+  Int_t    fRetries;          ///< Retries of a failed job
+  Double_t fMaxIOWait;        ///< I/O wait above which no job is started (0 disables)
+  std::string fManifest;      ///< Manifest file name
+  std::string fLogDirectory;  ///< Directory of the job log files
+  std::string fCommand;       ///< Analysis executable
+
+  std::vector<Job_t> fJobs;
+  std::vector<std::string> fArguments;  ///< Options passed on to each job
+
+  /// Total and I/O wait CPU times at the last call of GetIOWait
+  ULong64_t fLastTotal, fLastIOWait;
+
+};
+
+#endif
@@ -0,0 +1,115 @@
+/**********************************************************\
+* File: QwRunChunks.h                                      *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#ifndef __QwRunChunks__
+#define __QwRunChunks__
+
+#include <vector>
+#include <functional>
+
+#include "Rtypes.h"
+#include "TString.h"
+
+class QwOptions;
+class QwEventBuffer;
+
+/**
+ *  \class QwRunChunks
+ *  \ingroup QwAnalysis
+ *
+ *  \brief Analyzes a run in chunks of events, in parallel child processes
+ *
+ *  Each chunk is a range of CODA event numbers, analyzed by a child
+ *  process forked after the setup of the run (so that the subsystems,
+ *  the blinder and the data handlers are shared), which writes its own
+ *  ROOT files with the chunk number appended to the run label.  At the
+ *  end of its chunk, the child packs its running sums and sends them to
+ *  the parent, which merges the chunks in order and calculates the
+ *  averages of the whole run.
+ *
+ *  The subsystems keep state from one event to the next, so each child
+ *  starts reading a number of events before its chunk (the warm-up) to
+ *  fill the event ring and synchronize the helicity prediction, and reads
+ *  past its chunk until the ring has released its last event.  Only
+ *  events (and patterns completed by events) inside the chunk are used;
+ *  Contains() tells whether an event belongs to the chunk.  The warm-up
+ *  must be longer than the event ring and the helicity resynchronization.
+ *
+ *  Children are launched while fewer than --chunk.jobs are running, and
+ *  no more chunks are launched once a child reports the end of the data.
+ *
+ *  Only the running sums of the events and of the helicity patterns, and
+ *  the correlator accumulators, are merged; they are added as sets of good
+ *  events inside a VQwHardwareChannel::MergeScope.  The burst sums, the
+ *  EPICS values, the running regression and the error counters are not
+ *  merged: they are in the ROOT files and output of each chunk only.
+ */
+class QwRunChunks {
+
+ public:
+  /// Merge of the result of a chunk, called in the parent in chunk order
+  typedef std::function<void(const Double_t*&)> Merge_t;
+  /// Packing of the result of a chunk, called in the child
+  typedef std::function<void(std::vector<Double_t>&)> Pack_t;
+
+ public:
+  QwRunChunks(QwOptions &options);
+  virtual ~QwRunChunks() { };
+
+  /// \brief Define options
+  static void DefineOptions(QwOptions &options);
+  /// \brief Process options
+  void ProcessOptions(QwOptions &options);
+
+  /// Is the run split in chunks?
+  Bool_t IsEnabled() const { return fEventsPerChunk > 0; };
+  /// Is this the process which merges the chunks?
+  Bool_t IsParent() const { return fChunk == kParent; };
+  /// Is this the process which analyzes a chunk?
+  Bool_t IsChild() const { return fChunk >= 0; };
+
+  /// \brief Analyze the chunks in child processes and merge their results
+  void Fork(QwEventBuffer &eventbuffer, const Merge_t& merge);
+  /// \brief Send the result of this chunk to the parent and exit
+  void Finish(QwEventBuffer &eventbuffer, const Pack_t& pack);
+
+  /// Label appended to the run label of the output of a chunk
+  TString GetLabel() const;
+  /// Does the event belong to this chunk (or to the run, if not a chunk)?
+  Bool_t Contains(UInt_t event) const {
+    return (! IsChild()) || (event >= fFirstEvent && event <= fLastEvent);
+  };
+
+ private:
+  QwRunChunks();
+  QwRunChunks(const QwRunChunks&);
+
+  static const Int_t kSerial = -2;
+  static const Int_t kParent = -1;
+
+  /// Running child process and the pipe from which its result is read
+  struct Child_t {
+    Int_t fChunk;
+    Int_t fPid;
+    Int_t fPipe;
+  };
+  /// \brief Read the result of a child and wait for it to exit
+  Bool_t Collect(const Child_t& child, std::vector<Double_t>& result) const;
+
+  Int_t  fEventsPerChunk;   ///< Events in a chunk (0 disables)
+  Int_t  fJobs;             ///< Chunks analyzed at the same time
+  Int_t  fWarmup;           ///< Events read before a chunk
+
+  Int_t  fChunk;            ///< Chunk of this process, or kSerial or kParent
+  UInt_t fFirstEvent;       ///< First event of the chunk
+  UInt_t fLastEvent;        ///< Last event of the chunk
+  UInt_t fLastRead;         ///< Last event read by the child
+  Int_t  fPipe;             ///< Pipe to the parent
+
+};
+
+#endif
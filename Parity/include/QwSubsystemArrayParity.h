@@ -128,6 +128,16 @@ class QwSubsystemArrayParity: public QwSubsystemArray {
 
     void UpdateErrorFlag(UInt_t errflag){fErrorFlag |= errflag;};
 
+    /// \brief Add the error counters of each channel in the source subsystem array
+    void MergeErrorCounters(const QwSubsystemArrayParity& source);
+
+    /// \brief Append the event data of the subsystems which support packing to a buffer
+    void PackEventData(std::vector<Double_t>& buffer) const;
+    /// \brief Restore the event data written by PackEventData
+    void UnpackEventData(const Double_t*& data);
+    /// \brief Merge a running sum written by PackEventData into this running sum
+    void MergeRunningSum(const Double_t*& data);
+
     /// \brief Print value of all channels
     void PrintValue() const;
 
@@ -37,6 +37,8 @@ class QwkRegBlueCorrelator  {
   void init(std::vector < TString > ivName, std::vector < TString > dvName);
   void finish();
   void addEvent(double *Pvec, double *Yvec);
+  void packAccumulators(std::vector<double> &buffer) const { linReg.pack(buffer); }
+  void mergeAccumulators(const double* &data);
   void exportAlphas(TString outPath, std::vector < TString > ivName, std::vector < TString > dvName);
   void exportAlias(TString outPath, TString macroName, std::vector < TString > ivName, std::vector < TString > dvName);
 
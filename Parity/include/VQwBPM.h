@@ -203,6 +203,11 @@ public:
   }
   virtual Bool_t ApplySingleEventCuts() = 0;//Check for good events by stting limits on the devices readings
   virtual void IncrementErrorCounters() = 0;
+  virtual void MergeErrorCounters(const VQwBPM *source) = 0;
+  /// \brief Append the event-based data copied by operator= to a buffer
+  virtual void PackEventData(std::vector<Double_t>& buffer) const;
+  /// \brief Restore the event-based data written by PackEventData
+  virtual void UnpackEventData(const Double_t*& data);
   virtual void ProcessEvent() = 0;
 
   // These only applies to a combined BPM
@@ -64,6 +64,11 @@ public:
   virtual void SetCalibrationFactor(Double_t calib) = 0;
   virtual Bool_t ApplySingleEventCuts() = 0;//Check for good events by stting limits on the devices readings
   virtual void IncrementErrorCounters() = 0;
+  virtual void MergeErrorCounters(const VQwClock *source) = 0;
+  /// \brief Append the event-based data copied by operator= to a buffer
+  virtual void PackEventData(std::vector<Double_t>& buffer) const = 0;
+  /// \brief Restore the event-based data written by PackEventData
+  virtual void UnpackEventData(const Double_t*& data) = 0;
   virtual void  ProcessEvent() = 0;
   virtual void Scale(Double_t factor) = 0;
   virtual void CalculateRunningAverage() = 0;
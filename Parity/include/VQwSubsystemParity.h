@@ -83,6 +83,15 @@ class VQwSubsystemParity: virtual public VQwSubsystem {
     virtual void PrintErrorCounters() const = 0;
     /// \brief Increment the error counters
     virtual void IncrementErrorCounters() = 0;
+    /// \brief Add the error counters of another copy of this subsystem.
+    ///        Subsystems without error counters need not override this.
+    virtual void MergeErrorCounters(const VQwSubsystem *source) { };
+
+    /// \brief Append the event-based data copied by operator= to a compact
+    ///        buffer; returns kFALSE, without writing, if not supported
+    virtual Bool_t PackEventData(std::vector<Double_t>& buffer) const { return kFALSE; };
+    /// \brief Restore the event-based data written by PackEventData
+    virtual void UnpackEventData(const Double_t*& data) { };
 
     /// \brief Return the error flag to the top level routines related to stability checks and ErrorFlag updates
     virtual UInt_t GetEventcutErrorFlag() = 0;
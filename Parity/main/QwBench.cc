@@ -0,0 +1,329 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file QwBench.cc
+
+ \brief main(...) function for the qwbench executable
+
+ Micro-benchmarks of the decoding and statistics kernels.  The channels
+ decode buffers built with their own EncodeEventData methods, and the
+ subsystem array decodes a helicity pattern of mock events built the
+ same way (by default with the mock detector configuration).  The
+ helicity pattern is timed with copies of the events and, with the
+ suffix _packed, with packed events (--enable-packed-pattern).  The mock
+ data use the default seed of the randomness generator, so the inputs
+ are the same in every run.
+
+ Each benchmark is run once to warm up and then --bench.repeat times
+ with --bench.iterations calls; the time per call of the repetitions
+ is written to --bench.output as JSON.
+
+*//*-------------------------------------------------------------------------*/
+
+// System headers
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+// Boost headers
+#include <boost/random.hpp>
+
+// ROOT headers
+#include "Rtypes.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptionsParity.h"
+#include "QwProfiler.h"
+#include "QwVQWK_Channel.h"
+#include "QwADC18_Channel.h"
+#include "QwScaler_Channel.h"
+#include "QwSubsystemArrayParity.h"
+#include "QwHelicityPattern.h"
+#include "QwHelicity.h"
+#include "LinReg_Bevington_Pebay.h"
+
+extern const char* const gGitInfo;
+
+///  Result of one benchmark, in nanoseconds per call
+struct BenchResult_t {
+  std::string fName;
+  Long64_t fCalls;
+  Double_t fMin;
+  Double_t fMedian;
+  Double_t fMean;
+};
+
+///  Runs the benchmarks and collects their results
+class QwBench {
+
+  public:
+
+    QwBench(QwOptions &options)
+    : fIterations(options.GetValue<int>("bench.iterations")),
+      fRepeat(options.GetValue<int>("bench.repeat")),
+      fFilter(options.GetValue<std::string>("bench.filter")) {
+      if (fIterations < 1) fIterations = 1;
+      if (fRepeat < 1) fRepeat = 1;
+    };
+
+    /// Time a function called once per iteration
+    void Run(const std::string& name, const std::function<void()>& call) {
+      if (fFilter != "" && name.find(fFilter) == std::string::npos) return;
+
+      //  The first repetition only warms up caches and branch predictors
+      std::vector<Double_t> times;
+      for (Int_t rep = 0; rep <= fRepeat; rep++) {
+        ULong64_t start = QwProfiler::Now();
+        for (Int_t i = 0; i < fIterations; i++) call();
+        if (rep > 0)
+          times.push_back(Double_t(QwProfiler::Now() - start) / fIterations);
+      }
+
+      BenchResult_t result;
+      result.fName  = name;
+      result.fCalls = Long64_t(fIterations) * fRepeat;
+      std::sort(times.begin(), times.end());
+      result.fMin    = times.front();
+      result.fMedian = times.at(times.size() / 2);
+      result.fMean   = 0;
+      for (size_t i = 0; i < times.size(); i++) result.fMean += times[i] / times.size();
+      fResults.push_back(result);
+
+      QwMessage << Form("%-32s %12.1f ns/call (min %.1f, mean %.1f)",
+                        name.c_str(), result.fMedian, result.fMin, result.fMean)
+                << QwLog::endl;
+    };
+
+    /// Write the results as JSON
+    Bool_t WriteJSON(const std::string& filename) const {
+      std::ofstream output(filename.c_str());
+      if (! output.good()) {
+        QwError << "Could not open " << filename << " for writing" << QwLog::endl;
+        return kFALSE;
+      }
+      output << "{" << std::endl;
+      output << "  \"commit\": \"" << GetCommit() << "\"," << std::endl;
+      output << "  \"iterations\": " << fIterations << "," << std::endl;
+      output << "  \"repeat\": " << fRepeat << "," << std::endl;
+      output << "  \"benchmarks\": [" << std::endl;
+      for (size_t i = 0; i < fResults.size(); i++) {
+        const BenchResult_t& result = fResults[i];
+        output << Form("    {\"name\": \"%s\", \"calls\": %lld, \"ns_per_call\": %.3f, "
+                       "\"ns_per_call_min\": %.3f, \"ns_per_call_mean\": %.3f}",
+                       result.fName.c_str(), result.fCalls,
+                       result.fMedian, result.fMin, result.fMean);
+        output << ((i + 1 < fResults.size())? ",": "") << std::endl;
+      }
+      output << "  ]" << std::endl;
+      output << "}" << std::endl;
+      return kTRUE;
+    };
+
+  private:
+
+    /// Commit of the build, from the git information compiled in
+    static std::string GetCommit() {
+      std::string info(gGitInfo);
+      size_t pos = info.find("commit ");
+      if (pos == std::string::npos) return "unknown";
+      pos += 7;
+      size_t end = info.find_first_not_of("0123456789abcdef", pos);
+      return info.substr(pos, end - pos);
+    };
+
+    Int_t fIterations;
+    Int_t fRepeat;
+    std::string fFilter;
+    std::vector<BenchResult_t> fResults;
+};
+
+
+///  Decode an event encoded by QwSubsystemArray::EncodeEventData, which
+///  consists of one ROC bank with a single subbank per subsystem
+void DecodeEvent(QwSubsystemArrayParity& detectors, std::vector<UInt_t>& buffer)
+{
+  detectors.ClearEventData();
+  size_t roc = 0;
+  while (roc + 1 < buffer.size()) {
+    UInt_t roc_length = buffer[roc];
+    ROCID_t roc_id = buffer[roc + 1] >> 16;
+    size_t bank = roc + 2;
+    while (bank + 1 < buffer.size() && bank < roc + 1 + roc_length) {
+      UInt_t bank_length = buffer[bank];
+      BankID_t bank_id = buffer[bank + 1] >> 16;
+      detectors.ProcessEvBuffer(1, roc_id, bank_id, &buffer[bank + 2], bank_length - 1);
+      bank += bank_length + 1;
+    }
+    roc += roc_length + 1;
+  }
+}
+
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  ///  Define the command line options
+  DefineOptionsParity(gQwOptions);
+  gQwOptions.AddOptions("Benchmark options")("bench.iterations",
+      po::value<int>()->default_value(100000),
+      "number of calls in each repetition of a benchmark");
+  gQwOptions.AddOptions("Benchmark options")("bench.repeat",
+      po::value<int>()->default_value(5),
+      "number of timed repetitions of each benchmark");
+  gQwOptions.AddOptions("Benchmark options")("bench.filter",
+      po::value<std::string>()->default_value(""),
+      "only run the benchmarks with this string in their name");
+  gQwOptions.AddOptions("Benchmark options")("bench.output",
+      po::value<std::string>()->default_value("qwbench.json"),
+      "file to write the results to, as JSON");
+
+  ///  Fill the search paths for the parameter files
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QW_PRMINPUT"));
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QWANALYSIS") + "/Parity/prminput");
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QWANALYSIS") + "/Analysis/prminput");
+
+  ///  The mock detectors are used unless configured otherwise
+  gQwOptions.SetCommandLine(argc, argv);
+  gQwOptions.SetConfigFile("qwmockdataanalysis.conf");
+  gQwLog.ProcessOptions(&gQwOptions);
+
+  QwBench bench(gQwOptions);
+  Int_t iterations = gQwOptions.GetValue<int>("bench.iterations");
+
+
+  ///  Channel decoding
+  QwVQWK_Channel vqwk("bench_vqwk");
+  vqwk.SetRandomEventParameters(2.0e4, 3.0e2);
+  vqwk.RandomizeEventData(1, 0.0);
+  std::vector<UInt_t> vqwk_buffer;
+  vqwk.EncodeEventData(vqwk_buffer);
+  bench.Run("vqwk_decode", [&]{
+    vqwk.ProcessEvBuffer(vqwk_buffer.data(), vqwk_buffer.size(), 0);
+  });
+  vqwk.ProcessEvent();
+
+  QwADC18_Channel adc18("bench_adc18");
+  adc18.SetRandomEventParameters(2.0e4, 3.0e2);
+  adc18.RandomizeEventData(1, 0.0);
+  std::vector<UInt_t> adc18_buffer;
+  adc18.EncodeEventData(adc18_buffer);
+  bench.Run("adc18_decode", [&]{
+    adc18.ProcessEvBuffer(adc18_buffer.data(), adc18_buffer.size(), 0);
+  });
+
+  QwSIS3801D24_Channel sis3801d24("bench_sis3801d24");
+  sis3801d24.SetRandomEventParameters(2.0e4, 3.0e2);
+  sis3801d24.RandomizeEventData(1, 0.0);
+  std::vector<UInt_t> sis3801d24_buffer;
+  sis3801d24.EncodeEventData(sis3801d24_buffer);
+  bench.Run("sis3801d24_decode", [&]{
+    sis3801d24.ProcessEvBuffer(sis3801d24_buffer.data(), sis3801d24_buffer.size(), 0);
+  });
+
+  QwSIS3801D32_Channel sis3801d32("bench_sis3801d32");
+  sis3801d32.SetRandomEventParameters(2.0e4, 3.0e2);
+  sis3801d32.RandomizeEventData(1, 0.0);
+  std::vector<UInt_t> sis3801d32_buffer;
+  sis3801d32.EncodeEventData(sis3801d32_buffer);
+  bench.Run("sis3801d32_decode", [&]{
+    sis3801d32.ProcessEvBuffer(sis3801d32_buffer.data(), sis3801d32_buffer.size(), 0);
+  });
+
+
+  ///  Running sums of a channel; as many events are removed as were
+  ///  added, so the sum ends up empty again
+  QwVQWK_Channel vqwk_sum("bench_vqwk_sum");
+  bench.Run("vqwk_accumulate", [&]{ vqwk_sum.AccumulateRunningSum(vqwk); });
+  bench.Run("vqwk_deaccumulate", [&]{ vqwk_sum.DeaccumulateRunningSum(vqwk); });
+
+
+  ///  Linear regression accumulators, with the dimensions of a typical
+  ///  correction of the main detector by the beam parameters
+  const Int_t nP = 5, nY = 28, nrows = 1024;
+  boost::mt19937 generator;
+  boost::normal_distribution<double> normal;
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<double> >
+    random(generator, normal);
+  std::vector<Double_t> P(nP * nrows), Y(nY * nrows);
+  std::generate(P.begin(), P.end(), random);
+  std::generate(Y.begin(), Y.end(), random);
+  LinRegBevPeb linreg;
+  linreg.setDims(nP, nY);
+  linreg.init();
+  Int_t row = 0;
+  bench.Run("linregbevpeb_accumulate", [&]{
+    linreg.accumulate(&P[nP * row], &Y[nY * row]);
+    row = (row + 1) % nrows;
+  });
+
+
+  ///  Subsystem array and helicity pattern
+  QwSubsystemArrayParity detectors(gQwOptions);
+  detectors.ProcessOptions(gQwOptions);
+  QwHelicity* helicity = dynamic_cast<QwHelicity*>(detectors.GetSubsystemByName("Helicity Info"));
+  if (detectors.empty() || ! helicity) {
+    QwWarning << "No detectors with helicity information; "
+              << "skipping the benchmarks of the subsystem array" << QwLog::endl;
+  } else {
+    //  Encode and decode one pattern of mock events
+    Int_t pattern_size = helicity->GetMaxPatternPhase() - helicity->GetMinPatternPhase() + 1;
+    helicity->SetEventPatternPhase(-1, -1, -1);
+    helicity->SetFirstBits(24, 0x5a5a5a);
+    std::vector<QwSubsystemArrayParity> events;
+    for (Int_t event = 0; event < pattern_size; event++) {
+      detectors.ClearEventData();
+      helicity->SetEventPatternPhase(event, 0, event + helicity->GetMinPatternPhase());
+      helicity->RunPredictor();
+      detectors.RandomizeEventData(helicity->GetHelicityActual()? +1: -1, event * Qw::ms);
+      std::vector<UInt_t> buffer;
+      detectors.EncodeEventData(buffer);
+      DecodeEvent(detectors, buffer);
+      detectors.ProcessEvent();
+      events.push_back(detectors);
+    }
+
+    QwSubsystemArrayParity copy(detectors);
+    bench.Run("array_assign", [&]{ copy = events[0]; });
+    bench.Run("array_add", [&]{ copy += events[1]; });
+
+    QwSubsystemArrayParity array_sum(detectors);
+    array_sum.ClearEventData();
+    bench.Run("array_accumulate", [&]{ array_sum.AccumulateRunningSum(events[0]); });
+    bench.Run("array_deaccumulate", [&]{ array_sum.DeaccumulateRunningSum(events[0]); });
+
+    //  The pattern is loaded and calculated with copies of the events,
+    //  and with packed copies (--enable-packed-pattern)
+    for (Int_t packed = 0; packed < 2; packed++) {
+      QwHelicityPattern pattern(detectors);
+      pattern.ProcessOptions(gQwOptions);
+      pattern.EnablePackedPattern(packed);
+      if (packed && ! pattern.IsPackedPatternEnabled()) continue;
+      std::string suffix = packed? "_packed": "";
+
+      //  Events and pairs as in the event loop of qwparity
+      bench.Run("pattern_load" + suffix, [&]{
+        pattern.ClearEventData();
+        for (size_t i = 0; i < events.size(); i++) {
+          pattern.LoadEventData(events[i]);
+          if (pattern.PairAsymmetryIsGood()) pattern.ClearPairData();
+        }
+      });
+      if (! pattern.IsCompletePattern()) {
+        QwWarning << "The mock events do not form a complete pattern; "
+                  << "skipping the benchmark of the asymmetry" << QwLog::endl;
+        break;
+      }
+      bench.Run("pattern_asymmetry" + suffix, [&]{ pattern.CalculateAsymmetry(); });
+    }
+  }
+
+
+  ///  Write the results
+  std::string output = gQwOptions.GetValue<std::string>("bench.output");
+  if (! bench.WriteJSON(output)) return 1;
+  QwMessage << "Results of " << iterations << " calls per repetition written to "
+            << output << QwLog::endl;
+  return 0;
+}
@@ -32,6 +32,9 @@
 #include "QwSubsystemArrayParity.h"
 #include "QwHelicityPattern.h"
 #include "QwEventRing.h"
+#include "QwEventPipeline.h"
+#include "QwRunChunks.h"
+#include "QwProfiler.h"
 #include "QwEPICSEvent.h"
 #include "QwCombiner.h"
 #include "QwCombinerSubsystem.h"
@@ -109,6 +112,8 @@ Int_t main(Int_t argc, Char_t* argv[])
     //  Parse the options again, in case there are run-ranged config files
     gQwOptions.Parse(kTRUE);
     eventbuffer.ProcessOptions(gQwOptions);
+    gQwProfiler.ProcessOptions(gQwOptions);
+    gQwProfiler.Reset();
 
     //    if (gQwOptions.GetValue<bool>("write-promptsummary")) {
     QwPromptSummary promptsummary(run_number, eventbuffer.GetSegmentNumber());
@@ -135,8 +140,6 @@ Int_t main(Int_t argc, Char_t* argv[])
     QwHelicityPattern helicitypattern(detectors,run_label);
     helicitypattern.ProcessOptions(gQwOptions);
 
-    ///  Create the event ring with the subsystem array
-    QwEventRing eventring(gQwOptions,detectors);
     //  Make a copy of the detectors object to hold the
     //  events which pass through the ring.
     QwSubsystemArrayParity ringoutput(detectors);
@@ -150,58 +153,6 @@ Int_t main(Int_t argc, Char_t* argv[])
     database.SetupOneRun(eventbuffer);
     #endif // __USE_DATABASE__
 
-    //  Open the ROOT file (close when scope ends)
-    QwRootFile *treerootfile  = NULL;
-    QwRootFile *burstrootfile = NULL;
-    QwRootFile *historootfile = NULL;
-
-
-    if (gQwOptions.GetValue<bool>("single-output-file")) {
-
-      treerootfile  = new QwRootFile(run_label);
-      burstrootfile = historootfile = treerootfile;
-      //  Construct a tree which contains map file names which are used to analyze data
-      treerootfile->WriteParamFileList("mapfiles", detectors);
-
-    } else {
-
-      treerootfile  = new QwRootFile(run_label + ".trees");
-      burstrootfile = new QwRootFile(run_label + ".bursts");
-      historootfile = new QwRootFile(run_label + ".histos");
-
-      //  Construct a tree which contains map file names which are used to analyze data
-      detectors.PrintParamFileList();
-      treerootfile->WriteParamFileList("mapfiles", detectors);
-      burstrootfile->WriteParamFileList("mapfiles", detectors);
-      historootfile->WriteParamFileList("mapfiles", detectors);
-    }
-    #ifdef __USE_DATABASE__
-    if (database.AllowsWriteAccess()) {
-      database.FillParameterFiles(detectors);
-    }
-    #endif // __USE_DATABASE__
-    //  Construct histograms
-    historootfile->ConstructHistograms("evt_histo", ringoutput);
-    historootfile->ConstructHistograms("mul_histo", helicitypattern);
-    detectors.ShareHistograms(ringoutput);
-
-    //  Construct tree branches
-    treerootfile->ConstructTreeBranches("evt", "MPS event data tree", ringoutput);
-    treerootfile->ConstructTreeBranches("mul", "Helicity event data tree", helicitypattern);
-    burstrootfile->ConstructTreeBranches("pr", "Pair tree", helicitypattern.GetPairYield(),"yield_");
-    burstrootfile->ConstructTreeBranches("pr", "Pair tree", helicitypattern.GetPairAsymmetry(),"asym_");
-    treerootfile->ConstructTreeBranches("mulc", "Helicity event data tree (corrected)", helicitypattern.return_regression());
-    treerootfile->ConstructTreeBranches("mulc_lrb", "Helicity event data tree (corrected by LinRegBlue)", helicitypattern.return_regress_from_LRB());
-    treerootfile->ConstructTreeBranches("slow", "EPICS and slow control tree", epicsevent);
-    burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstYield(),"yield_");
-    burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstAsymmetry(),"asym_");
-    burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstDifference(),"diff_");
-
-    // Summarize the ROOT file structure
-    //treerootfile->PrintTrees();
-    //treerootfile->PrintDirs();
-
-
     //  Clear the single-event running sum at the beginning of the runlet
     runningsum.ClearEventData();
     patternsum.ClearRunningSum();
@@ -216,8 +167,10 @@ Int_t main(Int_t argc, Char_t* argv[])
 
     //  Find the first EPICS event and try to initialize
     //  the blinder, but only for disk files, not online.
+    //  The events read on the way are kept in memory.
     if (! eventbuffer.IsOnline() ){
       QwMessage << "Finding first EPICS event" << QwLog::endl;
+      eventbuffer.StartRecording();
       while (eventbuffer.GetNextEvent() == CODA_OK) {
 	if (eventbuffer.IsEPICSEvent()) {
 	  eventbuffer.FillEPICSData(epicsevent);
@@ -229,142 +182,311 @@ Int_t main(Int_t argc, Char_t* argv[])
 	}
       }
       epicsevent.ResetCounters();
-      //  Rewind stream
-      QwMessage << "Rewinding stream" << QwLog::endl;
-      eventbuffer.ReOpenStream();
+      //  Replay the events read so far, or rewind the stream if
+      //  there were too many of them to keep
+      if (! eventbuffer.ReplayRecording()) {
+        QwMessage << "Rewinding stream" << QwLog::endl;
+        eventbuffer.ReOpenStream();
+      }
     }
 
-    ///  Start loop over events
-    while (eventbuffer.GetNextEvent() == CODA_OK) {
-
-      //  First, do processing of non-physics events...
-      if (eventbuffer.IsROCConfigurationEvent()) {
-        //  Send ROC configuration event data to the subsystem objects.
-        eventbuffer.FillSubsystemConfigurationData(detectors);
-      }
+    //  The chunks of a run do not use the database connection
+    #ifdef __USE_DATABASE__
+    if (database.AllowsWriteAccess()) {
+      database.FillParameterFiles(detectors);
+    }
+    #endif // __USE_DATABASE__
 
-      //  Secondly, process EPICS events
-      if (eventbuffer.IsEPICSEvent()) {
-        eventbuffer.FillEPICSData(epicsevent);
-	if (epicsevent.HasDataLoaded()){
-	  epicsevent.CalculateRunningValues();
-	  helicitypattern.UpdateBlinder(epicsevent);
-	
-	  treerootfile->FillTreeBranches(epicsevent);
-	  treerootfile->FillTree("slow");
-	}
+    ///  Split the run in chunks of events which are analyzed in parallel
+    ///  by child processes, if requested.  The parent merges the running
+    ///  sums of the chunks, and does not analyze events itself.
+    QwRunChunks chunks(gQwOptions);
+    Long64_t chunk_events = 0, chunk_patterns = 0;
+    chunks.Fork(eventbuffer, [&](const Double_t*& data) {
+      Long64_t nevents = Long64_t(*data++);
+      Long64_t npatterns = Long64_t(*data++);
+      if (nevents > 0) runningsum.MergeRunningSum(data);
+      if (npatterns > 0) {
+        patternsum.MergeRunningSum(data);
+        helicitypattern.MergeDataHandlers(data);
       }
+    });
+    TString output_label = run_label + chunks.GetLabel();
 
+    if (! chunks.IsParent()) {
 
-      //  Now, if this is not a physics event, go back and get a new event.
-      if (! eventbuffer.IsPhysicsEvent()) continue;
+      //  Open the ROOT file (close when scope ends)
+      QwRootFile *treerootfile  = NULL;
+      QwRootFile *burstrootfile = NULL;
+      QwRootFile *historootfile = NULL;
 
 
-      //  Fill the subsystem objects with their respective data for this event.
-      eventbuffer.FillSubsystemData(detectors);
+      if (gQwOptions.GetValue<bool>("single-output-file")) {
 
-      //  Process the subsystem data
-      detectors.ProcessEvent();
+        treerootfile  = new QwRootFile(output_label);
+        burstrootfile = historootfile = treerootfile;
+        //  Construct a tree which contains map file names which are used to analyze data
+        treerootfile->WriteParamFileList("mapfiles", detectors);
 
+      } else {
 
-      // The event pass the event cut constraints
-      if (detectors.ApplySingleEventCuts()) {
-	
-	//	// TEST 
-	// 	regress_sub.LinearRegression();
+        treerootfile  = new QwRootFile(output_label + ".trees");
+        burstrootfile = new QwRootFile(output_label + ".bursts");
+        historootfile = new QwRootFile(output_label + ".histos");
 
+        //  Construct a tree which contains map file names which are used to analyze data
+        detectors.PrintParamFileList();
+        treerootfile->WriteParamFileList("mapfiles", detectors);
+        burstrootfile->WriteParamFileList("mapfiles", detectors);
+        historootfile->WriteParamFileList("mapfiles", detectors);
+      }
+      //  Construct histograms
+      historootfile->ConstructHistograms("evt_histo", ringoutput);
+      historootfile->ConstructHistograms("mul_histo", helicitypattern);
+      detectors.ShareHistograms(ringoutput);
+
+      //  Construct tree branches, and keep the handles to fill them
+      auto evt_tree = treerootfile->ConstructTreeBranches("evt", "MPS event data tree", ringoutput);
+      auto mul_tree = treerootfile->ConstructTreeBranches("mul", "Helicity event data tree", helicitypattern);
+      auto pr_yield_tree = burstrootfile->ConstructTreeBranches("pr", "Pair tree", helicitypattern.GetPairYield(),"yield_");
+      auto pr_asym_tree  = burstrootfile->ConstructTreeBranches("pr", "Pair tree", helicitypattern.GetPairAsymmetry(),"asym_");
+      auto mulc_tree = treerootfile->ConstructTreeBranches("mulc", "Helicity event data tree (corrected)", helicitypattern.return_regression());
+      auto mulc_lrb_tree = treerootfile->ConstructTreeBranches("mulc_lrb", "Helicity event data tree (corrected by LinRegBlue)", helicitypattern.return_regress_from_LRB());
+      auto slow_tree = treerootfile->ConstructTreeBranches("slow", "EPICS and slow control tree", epicsevent);
+      auto burst_yield_tree = burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstYield(),"yield_");
+      auto burst_asym_tree  = burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstAsymmetry(),"asym_");
+      auto burst_diff_tree  = burstrootfile->ConstructTreeBranches("burst", "Burst level data tree", helicitypattern.GetBurstDifference(),"diff_");
+
+      ///  Create the event ring with copies of the ring output, so that
+      ///  the events can be analyzed in place in the ring; the handle of
+      ///  the evt tree fills its branches from any of them
+      QwEventRing eventring(gQwOptions,ringoutput);
+      eventring.ShareHistograms(ringoutput);
+
+      // Summarize the ROOT file structure
+      //treerootfile->PrintTrees();
+      //treerootfile->PrintDirs();
+
+
+
+      ///  Analysis stage of the event loop, for the events which passed
+      ///  the single event cuts.  With more than one thread it runs on its
+      ///  own thread, on copies of the detectors object.
+      auto analyze = [&](QwSubsystemArrayParity& event) {
         // Add event to the ring
-        eventring.push(detectors);
+        eventring.push(event);
 
         // Check to see ring is ready
         if (eventring.IsReady()) {
-	  ringoutput = eventring.pop();
-	  ringoutput.IncrementErrorCounters();
+          // Analyze the event in place in the ring
+          QwSubsystemArrayParity& ringevent = eventring.pop();
+
+          // Events around a chunk only synchronize the helicity pattern
+          if (! chunks.Contains(ringevent.GetCodaEventNumber())) {
+            helicitypattern.LoadEventData(ringevent);
+            if (helicitypattern.PairAsymmetryIsGood())
+              helicitypattern.ClearPairData();
+            if (helicitypattern.IsGoodAsymmetry())
+              helicitypattern.ClearEventData();
+            return;
+          }
+          ringevent.IncrementErrorCounters();
 
 
-	  // Accumulate the running sum to calculate the event based running average
-	  runningsum.AccumulateRunningSum(ringoutput);
+          // Accumulate the running sum to calculate the event based running average
+          runningsum.AccumulateRunningSum(ringevent);
+          if (ringevent.GetEventcutErrorFlag() == 0) chunk_events++;
 
-	  // Fill the histograms
-	  historootfile->FillHistograms(ringoutput);
+          // Fill the histograms
+          historootfile->FillHistograms(ringevent);
 
-	  // Fill mps tree branches
-	  treerootfile->FillTreeBranches(ringoutput);
-	  treerootfile->FillTree("evt");
+          // Fill mps tree branches
+          evt_tree.FillTreeBranches(ringevent);
+          evt_tree.FillTree();
 
           // Load the event into the helicity pattern
-          helicitypattern.LoadEventData(ringoutput);
-
-	  if (helicitypattern.PairAsymmetryIsGood()) {
-	    patternsum.AccumulatePairRunningSum(helicitypattern);
-	    // Fill pair tree branches
-	    treerootfile->FillTreeBranches(helicitypattern.GetPairYield());
-	    treerootfile->FillTreeBranches(helicitypattern.GetPairAsymmetry());
-	    treerootfile->FillTreeBranches(helicitypattern.GetPairDifference());
-	    treerootfile->FillTree("pr");
-	    
-	    // Clear the data
-	    helicitypattern.ClearPairData();
-	  }
+          helicitypattern.LoadEventData(ringevent);
+
+          if (helicitypattern.PairAsymmetryIsGood()) {
+            patternsum.AccumulatePairRunningSum(helicitypattern);
+            // Fill pair tree branches
+            pr_yield_tree.FillTreeBranches(helicitypattern.GetPairYield());
+            pr_asym_tree.FillTreeBranches(helicitypattern.GetPairAsymmetry());
+            pr_yield_tree.FillTree();
+
+            // Clear the data
+            helicitypattern.ClearPairData();
+          }
           // Check to see if we can calculate helicity pattern asymmetry, do so, and report if it worked
           if (helicitypattern.IsGoodAsymmetry()) {
-	    patternsum.AccumulateRunningSum(helicitypattern);
+            patternsum.AccumulateRunningSum(helicitypattern);
+            chunk_patterns++;
 
-              // Fill histograms
-              historootfile->FillHistograms(helicitypattern);
+            // Fill histograms
+            historootfile->FillHistograms(helicitypattern);
 
-              // Fill helicity tree branches
-              treerootfile->FillTreeBranches(helicitypattern);
-              treerootfile->FillTree("mul");
+            // Fill helicity tree branches
+            mul_tree.FillTreeBranches(helicitypattern);
+            mul_tree.FillTree();
 
-              // Burst mode
-              if (helicitypattern.IsEndOfBurst()) {
-                helicitypattern.AccumulateRunningBurstSum();
-                helicitypattern.CalculateBurstAverage();
+            // Burst mode
+            if (helicitypattern.IsEndOfBurst()) {
+              helicitypattern.AccumulateRunningBurstSum();
+              helicitypattern.CalculateBurstAverage();
 
-                // Fill burst tree branches
-                burstrootfile->FillTreeBranches(helicitypattern.GetBurstYield());
-                burstrootfile->FillTreeBranches(helicitypattern.GetBurstAsymmetry());
-                burstrootfile->FillTreeBranches(helicitypattern.GetBurstDifference());
-                burstrootfile->FillTree("burst");
+              // Fill burst tree branches
+              burst_yield_tree.FillTreeBranches(helicitypattern.GetBurstYield());
+              burst_asym_tree.FillTreeBranches(helicitypattern.GetBurstAsymmetry());
+              burst_diff_tree.FillTreeBranches(helicitypattern.GetBurstDifference());
+              burst_yield_tree.FillTree();
 
-                // Clear the data
-                helicitypattern.ClearBurstSum();
-              }
+              // Clear the data
+              helicitypattern.ClearBurstSum();
+            }
 
-              // Linear regression on asymmetries
-              helicitypattern.ProcessDataHandlerEntry();
+            // Linear regression on asymmetries
+            helicitypattern.ProcessDataHandlerEntry();
 
-              // Fill corrected tree branches
-	      treerootfile->FillTreeBranches(helicitypattern.return_regression());
-	      treerootfile->FillTree("mulc");
-	      treerootfile->FillTreeBranches(helicitypattern.return_regress_from_LRB());
-	      treerootfile->FillTree("mulc_lrb");
+            // Fill corrected tree branches
+            mulc_tree.FillTreeBranches(helicitypattern.return_regression());
+            mulc_tree.FillTree();
+            mulc_lrb_tree.FillTreeBranches(helicitypattern.return_regress_from_LRB());
+            mulc_lrb_tree.FillTree();
 
-              // Clear the data
-              helicitypattern.ClearEventData();
+            // Clear the data
+            helicitypattern.ClearEventData();
 
-	  } // helicitypattern.IsGoodAsymmetry()
+          } // helicitypattern.IsGoodAsymmetry()
 
         } // eventring.IsReady()
 
-      } // detectors.ApplySingleEventCuts()
+      };
+      QwEventPipeline pipeline(gQwOptions, detectors);
+      pipeline.Start(analyze);
 
-    } // end of loop over events
-    
-    //  Perform actions at the end of the event loop on the
-    //  detectors object, which ought to have handles for the
-    //  MPS based histograms.
-    ringoutput.AtEndOfEventLoop();
+      ///  Start loop over events
+      while (eventbuffer.GetNextEvent() == CODA_OK) {
+
+        //  First, do processing of non-physics events...
+        if (eventbuffer.IsROCConfigurationEvent()) {
+          //  Send ROC configuration event data to the subsystem objects.
+          eventbuffer.FillSubsystemConfigurationData(detectors);
+        }
+
+        //  Secondly, process EPICS events
+        if (eventbuffer.IsEPICSEvent()) {
+          eventbuffer.FillEPICSData(epicsevent);
+	  if (epicsevent.HasDataLoaded()){
+	    //  The blinder and the trees are used by the analysis stage
+	    pipeline.Drain();
+	    epicsevent.CalculateRunningValues();
+	    helicitypattern.UpdateBlinder(epicsevent);
 
-    QwMessage << "Number of events processed at end of run: "
-              << eventbuffer.GetEventNumber() << QwLog::endl;
+	    if (chunks.Contains(eventbuffer.GetEventNumber())) {
+	      slow_tree.FillTreeBranches(epicsevent);
+	      slow_tree.FillTree();
+	    }
+	  }
+        }
 
 
+        //  Now, if this is not a physics event, go back and get a new event.
+        if (! eventbuffer.IsPhysicsEvent()) continue;
+
+
+        //  Fill the subsystem objects with their respective data for this event.
+        eventbuffer.FillSubsystemData(detectors);
+
+        //  Process the subsystem data
+        detectors.ProcessEvent();
+
+
+        // The event pass the event cut constraints
+        if (detectors.ApplySingleEventCuts()) {
+
+	  //	// TEST 
+	  // 	regress_sub.LinearRegression();
+
+          // Pass the event on to the analysis stage
+          pipeline.Push(detectors);
+
+        } // detectors.ApplySingleEventCuts()
+
+      } // end of loop over events
+
+      //  Analyze the events still queued
+      pipeline.Stop();
+
+      //  Collect the last event and the error counters from the ring
+      eventring.CollectErrorCounters(ringoutput);
+
+      //  Perform actions at the end of the event loop on the
+      //  detectors object, which ought to have handles for the
+      //  MPS based histograms.
+      ringoutput.AtEndOfEventLoop();
+
+      QwMessage << "Number of events processed at end of run: "
+                << eventbuffer.GetEventNumber() << QwLog::endl;
+
+
+      //  Report the time spent in each stage of the event loop
+      gQwProfiler.CollectSubsystemTimes(detectors);
+      gQwProfiler.Print();
+      //  Store the profile in the root file before it is written and closed
+      if (gQwProfiler.IsWriteEnabled()) {
+        treerootfile->cd();
+        gQwProfiler.Write();
+      }
+
+      /*  Write to the root file, being sure to delete the old cycles  *
+       *  which were written by Autosave.                              *
+       *  Doing this will remove the multiple copies of the ntuples    *
+       *  from the root file.                                          *
+       *                                                               *
+       *  Then, we need to delete the histograms here.                 *
+       *  If we wait until the subsystem destructors, we get a         *
+       *  segfault; but in addition to that we should delete them      *
+       *  here, in case we run over multiple runs at a time.           */
+      treerootfile->Write(0,TObject::kOverwrite);
+      treerootfile->ProfileTrees();
+      if (treerootfile != historootfile) {
+        burstrootfile->Write(0,TObject::kOverwrite);
+        historootfile->Write(0,TObject::kOverwrite);
+        burstrootfile->ProfileTrees();
+      }
+
+      if (treerootfile == historootfile) {
+        delete treerootfile; treerootfile = 0; burstrootfile = 0; historootfile = 0;
+      } else {
+        delete treerootfile; treerootfile = 0;
+        delete burstrootfile; burstrootfile = 0;
+        delete historootfile; historootfile = 0;
+      }
+
+      //  Print the event cut error summary for each subsystem
+      if (gQwOptions.GetValue<bool>("print-errorcounters")) {
+        QwMessage << " ------------ error counters ------------------ " << QwLog::endl;
+        ringoutput.PrintErrorCounters();
+      }
+
+      //  A chunk hands its running sums to the parent, and exits
+      chunks.Finish(eventbuffer, [&](std::vector<Double_t>& buffer) {
+        buffer.push_back(chunk_events);
+        buffer.push_back(chunk_patterns);
+        if (chunk_events > 0) runningsum.PackEventData(buffer);
+        if (chunk_patterns > 0) {
+          patternsum.PackRunningSum(buffer);
+          helicitypattern.PackDataHandlers(buffer);
+        }
+      });
+
+    } // ! chunks.IsParent()
+
     // Calculate running averages over helicity patterns
     if (patternsum.IsRunningSumEnabled()) {
       patternsum.CalculateRunningAverage();
-      if (helicitypattern.IsBurstSumEnabled()) {
+      //  The burst sums of chunks are not merged
+      if (helicitypattern.IsBurstSumEnabled() && ! chunks.IsParent()) {
         helicitypattern.CalculateRunningBurstAverage();
       }
     }
@@ -380,33 +502,6 @@ Int_t main(Int_t argc, Char_t* argv[])
     }
    
   
-    /*  Write to the root file, being sure to delete the old cycles  *
-     *  which were written by Autosave.                              *
-     *  Doing this will remove the multiple copies of the ntuples    *
-     *  from the root file.                                          *
-     *                                                               *
-     *  Then, we need to delete the histograms here.                 *
-     *  If we wait until the subsystem destructors, we get a         *
-     *  segfault; but in addition to that we should delete them      *
-     *  here, in case we run over multiple runs at a time.           */
-    if (treerootfile == historootfile) {
-      treerootfile->Write(0,TObject::kOverwrite);
-      delete treerootfile; treerootfile = 0; burstrootfile = 0; historootfile = 0;
-    } else {
-      treerootfile->Write(0,TObject::kOverwrite);
-      burstrootfile->Write(0,TObject::kOverwrite);
-      historootfile->Write(0,TObject::kOverwrite);
-      delete treerootfile; treerootfile = 0;
-      delete burstrootfile; burstrootfile = 0;
-      delete historootfile; historootfile = 0;
-    }
-
-    //  Print the event cut error summary for each subsystem
-    if (gQwOptions.GetValue<bool>("print-errorcounters")) {
-      QwMessage << " ------------ error counters ------------------ " << QwLog::endl;
-      ringoutput.PrintErrorCounters();
-    }
-    
     if (gQwOptions.GetValue<bool>("write-promptsummary")) {
       //      runningsum.WritePromptSummary(&promptsummary, "yield");
       // runningsum.WritePromptSummary(&promptsummary, "asymmetry");
@@ -422,9 +517,13 @@ Int_t main(Int_t argc, Char_t* argv[])
     if (database.AllowsWriteAccess()) {
       patternsum.FillDB(&database);
       patternsum.FillErrDB(&database);
-      epicsevent.FillDB(&database);
-      helicitypattern.return_running_regression().FillDB(&database,"asymmetry");
-      ringoutput.FillDB_MPS(&database, "optics");
+      //  The EPICS values, the running regression and the event data
+      //  of chunks are not merged
+      if (! chunks.IsParent()) {
+        epicsevent.FillDB(&database);
+        helicitypattern.return_running_regression().FillDB(&database,"asymmetry");
+        ringoutput.FillDB_MPS(&database, "optics");
+      }
     }
     #endif // __USE_DATABASE__    
   
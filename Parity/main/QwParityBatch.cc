@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file QwParityBatch.cc
+
+ \brief main(...) function for the qwparitybatch executable
+
+ Analyzes the runs and runlets selected with --run, --runlist and --segment
+ in parallel qwparity processes; all other options are passed on to them.
+
+*//*-------------------------------------------------------------------------*/
+
+// System headers
+#include <iostream>
+
+// ROOT headers
+#include "Rtypes.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptionsParity.h"
+#include "QwEventBuffer.h"
+#include "QwRunBatch.h"
+
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  ///  Define the command line options
+  DefineOptionsParity(gQwOptions);
+  QwRunBatch::DefineOptions(gQwOptions);
+
+  ///  Without anything, print usage
+  if (argc == 1) {
+    gQwOptions.Usage();
+    exit(0);
+  }
+
+  ///  Fill the search paths for the parameter files, as the jobs will
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QW_PRMINPUT"));
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QWANALYSIS") + "/Parity/prminput");
+  QwParameterFile::AppendToSearchPath(getenv_safe_string("QWANALYSIS") + "/Analysis/prminput");
+
+  gQwOptions.SetCommandLine(argc, argv);
+  gQwOptions.ListConfigFiles();
+
+  /// Setup screen and file logging
+  gQwLog.ProcessOptions(&gQwOptions);
+
+  ///  Find the runs and runlets of the batch
+  QwEventBuffer eventbuffer;
+  eventbuffer.ProcessOptions(gQwOptions);
+
+  QwRunBatch batch(gQwOptions);
+  Int_t jobs = batch.AddJobs(eventbuffer);
+  if (jobs < 0) return 1;
+  if (jobs == 0) {
+    QwError << "No runs found for the batch" << QwLog::endl;
+    return 1;
+  }
+
+  ///  Analyze them and report the jobs which did not succeed
+  Int_t failed = batch.Run();
+  return (failed > 0)? 1: 0;
+}
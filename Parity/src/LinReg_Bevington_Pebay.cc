@@ -110,6 +110,85 @@ void LinRegBevPeb::accumulate(double *P, double *Y){
 }
 
 
+//==========================================================
+//==========================================================
+void LinRegBevPeb::merge(const LinRegBevPeb &other){
+  // pairwise update of the means and co-moments, Pebay eq. 1.1 and 3.1
+  if(other.fGoodEventNumber<1) return;
+  if(other.par_nP!=par_nP || other.par_nY!=par_nY) {
+    printf("LinRegBevPeb::merge dims differ: nP=%d/%d nY=%d/%d, skip\n",par_nP,other.par_nP,par_nY,other.par_nY);
+    return;
+  }
+  if(fGoodEventNumber<1) {
+    fGoodEventNumber=other.fGoodEventNumber;
+    mMP=other.mMP; mMY=other.mMY;
+    mVPP=other.mVPP; mVPY=other.mVPY; mVY2=other.mVY2;
+    return;
+  }
+
+  double na=fGoodEventNumber;
+  double nb=other.fGoodEventNumber;
+  double n=na+nb;
+  double fac=na*nb/n;
+
+  std::vector<double> delP(par_nP), delY(par_nY);
+  for (int i = 0; i <par_nP; i++) delP[i]=other.mMP(i,0)-mMP(i,0);
+  for (int j = 0; j <par_nY; j++) delY[j]=other.mMY(j,0)-mMY(j,0);
+
+  for (int i = 0; i <par_nP; i++) {
+    for (int j = i; j < par_nP; j++) // only upper triangle
+      mVPP(i,j)+=other.mVPP(i,j)+fac*delP[i]*delP[j];
+    for (int j = 0; j <par_nY; j++)
+      mVPY(i,j)+=other.mVPY(i,j)+fac*delP[i]*delY[j];
+    mMP(i,0)+=delP[i]*nb/n;
+  }
+  for (int j = 0; j <par_nY; j++) {
+    mVY2(j,0)+=other.mVY2(j,0)+fac*delY[j]*delY[j];
+    mMY(j,0)+=delY[j]*nb/n;
+  }
+
+  fGoodEventNumber+=other.fGoodEventNumber;
+}
+
+
+//==========================================================
+//==========================================================
+void LinRegBevPeb::pack(std::vector<double> &buffer) const {
+  buffer.push_back(par_nP);
+  buffer.push_back(par_nY);
+  buffer.push_back(fGoodEventNumber);
+  for (int i = 0; i <par_nP; i++) {
+    buffer.push_back(mMP(i,0));
+    for (int j = i; j < par_nP; j++) buffer.push_back(mVPP(i,j));
+    for (int j = 0; j <par_nY; j++)  buffer.push_back(mVPY(i,j));
+  }
+  for (int j = 0; j <par_nY; j++) {
+    buffer.push_back(mMY(j,0));
+    buffer.push_back(mVY2(j,0));
+  }
+}
+
+
+//==========================================================
+//==========================================================
+void LinRegBevPeb::unpack(const double* &data){
+  // restores the accumulators written by pack(), the dimensions included
+  setDims(int(data[0]),int(data[1]));
+  data+=2;
+  init();
+  fGoodEventNumber=Long64_t(*data++);
+  for (int i = 0; i <par_nP; i++) {
+    mMP(i,0)=*data++;
+    for (int j = i; j < par_nP; j++) mVPP(i,j)=*data++;
+    for (int j = 0; j <par_nY; j++)  mVPY(i,j)=*data++;
+  }
+  for (int j = 0; j <par_nY; j++) {
+    mMY(j,0)=*data++;
+    mVY2(j,0)=*data++;
+  }
+}
+
+
 //==========================================================
 //==========================================================
 Int_t  LinRegBevPeb::getMeanP(const int i, Double_t &mean ){
@@ -237,23 +237,19 @@ void QwBCM<T>::PrintErrorCounters() const
 /********************************************************/
 template<typename T>
 void QwBCM<T>::UpdateErrorFlag(const VQwBCM *ev_error){
-  try {
-    if(typeid(*ev_error)==typeid(*this)) {
-      // std::cout<<" Here in QwBCM::UpdateErrorFlag \n";
-      if (this->GetElementName()!="") {
-        const QwBCM<T>* value_bcm = dynamic_cast<const QwBCM<T>* >(ev_error);
-	fBeamCurrent.UpdateErrorFlag(value_bcm->fBeamCurrent);
-      }
-    } else {
-      TString loc="Standard exception from QwBCM::UpdateErrorFlag :"+
-        ev_error->GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
-    }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl; 
+  if (this->GetElementName()!="") {
+    const QwBCM<T>* value_bcm = static_cast<const QwBCM<T>* >(ev_error);
+    fBeamCurrent.UpdateErrorFlag(value_bcm->fBeamCurrent);
+  }
+}
+
+template<typename T>
+void QwBCM<T>::MergeErrorCounters(const VQwBCM *source){
+  if (this->GetElementName()!="") {
+    const QwBCM<T>* input = static_cast<const QwBCM<T>* >(source);
+    fBeamCurrent.MergeErrorCounters(input->fBeamCurrent);
   }
-};
+}
 
 
 /********************************************************/
@@ -282,31 +278,29 @@ QwBCM<T>& QwBCM<T>::operator= (const QwBCM<T> &value)
 }
 
 template<typename T>
-VQwBCM& QwBCM<T>::operator= (const VQwBCM &value)
+void QwBCM<T>::PackEventData(std::vector<Double_t>& buffer) const
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwBCM::operator= \n";
-      if (this->GetElementName()!="") {
-        const QwBCM<T>* value_bcm = dynamic_cast<const QwBCM<T>* >(&value);
-        QwBCM<T>* this_cast = dynamic_cast<QwBCM<T>* >(this);
-        this_cast->fBeamCurrent= value_bcm->fBeamCurrent;
-      }
-    } else {
-      TString loc="Standard exception from QwBCM::operato= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
-    }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
-//   std::cout<<" to be copied \n";
-//   value.Print();
-//   std::cout<<" copied \n";
-//   this->Print();
+  if (this->GetElementName()!="")
+    fBeamCurrent.PackEventData(buffer);
+}
 
-  return *this;
+template<typename T>
+void QwBCM<T>::UnpackEventData(const Double_t*& data)
+{
+  if (this->GetElementName()!="")
+    fBeamCurrent.UnpackEventData(data);
+}
+
+template<typename T>
+/**
+ * The operators on a VQwBCM are called from the arithmetic of QwBeamLine,
+ * which has checked once that both beamlines hold the same types of
+ * devices (QwBeamLine::Compare).  The operand is therefore a QwBCM<T>,
+ * and is cast without a run-time type check to call the typed operator.
+ */
+VQwBCM& QwBCM<T>::operator= (const VQwBCM &value)
+{
+  return *this = static_cast<const QwBCM<T>& >(value);
 }
 
 template<typename T>
@@ -322,59 +316,22 @@ QwBCM<T>& QwBCM<T>::operator+= (const QwBCM<T> &value)
 template<typename T>
 VQwBCM& QwBCM<T>::operator+= (const VQwBCM &value)
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwBCM::operator+= \n";
-      if (this->GetElementName()!="") {
-        const QwBCM<T>* value_bcm = dynamic_cast<const QwBCM<T>* >(&value);
-        QwBCM<T>* this_cast = dynamic_cast<QwBCM<T>* >(this);
-        this_cast->fBeamCurrent+=value_bcm->fBeamCurrent;
-      }
-    } else {
-      TString loc="Standard exception from QwBCM::operator+= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
-    }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
-
- return *this;
+  return *this += static_cast<const QwBCM<T>& >(value);
 }
 
 template<typename T>
 VQwBCM& QwBCM<T>::operator-= (const VQwBCM &value)
 {
-  if (this->GetElementName()!="")
-    {
-      const QwBCM<T>* value_bcm = dynamic_cast<const QwBCM<T>* >(&value);
-      QwBCM<T>* this_cast = dynamic_cast<QwBCM<T>* >(this);
-      this_cast->fBeamCurrent-=value_bcm->fBeamCurrent;
-    }
-  return *this;
+  return *this -= static_cast<const QwBCM<T>& >(value);
 }
 
 template<typename T>
 QwBCM<T>& QwBCM<T>::operator-= (const QwBCM<T> &value)
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwBCM::operator-= \n";
-      if (this->GetElementName()!="") {
-        const QwBCM<T>* value_bcm = dynamic_cast<const QwBCM<T>* >(&value);
-        QwBCM<T>* this_cast = dynamic_cast<QwBCM<T>* >(this);
-        this_cast->fBeamCurrent-=value_bcm->fBeamCurrent;
-      }
-    } else {
-      TString loc="Standard exception from QwBCM::operator-= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
+  if (this->GetElementName()!="")
+    {
+      this->fBeamCurrent-=value.fBeamCurrent;
     }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
   return *this;
 }
 
@@ -394,8 +351,8 @@ void QwBCM<T>::Difference(QwBCM<T> &value1, QwBCM<T> &value2){
 template<typename T>
 void QwBCM<T>::Ratio(const VQwBCM &numer, const VQwBCM &denom)
 {
-  Ratio(*dynamic_cast<const QwBCM<T>* >(&numer),
-      *dynamic_cast<const QwBCM<T>* >(&denom));
+  Ratio(static_cast<const QwBCM<T>& >(numer),
+      static_cast<const QwBCM<T>& >(denom));
 }
 
 template<typename T>
@@ -424,12 +381,12 @@ void QwBCM<T>::CalculateRunningAverage()
 template<typename T>
 void QwBCM<T>::AccumulateRunningSum(const VQwBCM& value) {
   fBeamCurrent.AccumulateRunningSum(
-      dynamic_cast<const QwBCM<T>* >(&value)->fBeamCurrent);
+      static_cast<const QwBCM<T>& >(value).fBeamCurrent);
 }
 
 template<typename T>
 void QwBCM<T>::DeaccumulateRunningSum(VQwBCM& value) {
-  fBeamCurrent.DeaccumulateRunningSum(dynamic_cast<QwBCM<T>* >(&value)->fBeamCurrent);
+  fBeamCurrent.DeaccumulateRunningSum(static_cast<QwBCM<T>& >(value).fBeamCurrent);
 }
 template<typename T>
 void QwBCM<T>::PrintValue() const
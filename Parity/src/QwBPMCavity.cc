@@ -321,6 +321,32 @@ void QwBPMCavity::UpdateErrorFlag(const VQwBPM *ev_error){
   }   
 };
 
+void QwBPMCavity::MergeErrorCounters(const VQwBPM *source){
+  Short_t i=0;
+  try {
+    if(typeid(*source)==typeid(*this)) {
+      if (this->GetElementName()!="") {
+        const QwBPMCavity* input = dynamic_cast<const QwBPMCavity* >(source);
+	for(i=0;i<2;i++){
+	  fWire[i].MergeErrorCounters(input->fWire[i]);
+	}
+	for(i=kXAxis;i<kNumAxes;i++) {
+	  fRelPos[i].MergeErrorCounters(input->fRelPos[i]);
+	  fAbsPos[i].MergeErrorCounters(input->fAbsPos[i]);
+	}
+	fEffectiveCharge.MergeErrorCounters(input->fEffectiveCharge);
+      }
+    } else {
+      TString loc="Standard exception from QwBPMCavity::MergeErrorCounters :"+
+        source->GetElementName()+" "+this->GetElementName()+" are not of the "
+        +"same type";
+      throw std::invalid_argument(loc.Data());
+    }
+  } catch (std::exception& e) {
+    std::cerr<< e.what()<<std::endl;
+  }
+};
+
 
 
 void  QwBPMCavity::ProcessEvent()
@@ -460,6 +486,38 @@ QwBPMCavity& QwBPMCavity::operator= (const QwBPMCavity &value)
   return *this;
 }
 
+void QwBPMCavity::PackEventData(std::vector<Double_t>& buffer) const
+{
+  VQwBPM::PackEventData(buffer);
+
+  buffer.push_back(bRotated);
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.PackEventData(buffer);
+    for(i=0;i<2;i++) {
+      fWire[i].PackEventData(buffer);
+      fRelPos[i].PackEventData(buffer);
+      fAbsPos[i].PackEventData(buffer);
+    }
+  }
+}
+
+void QwBPMCavity::UnpackEventData(const Double_t*& data)
+{
+  VQwBPM::UnpackEventData(data);
+
+  bRotated = (*data++ != 0);
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.UnpackEventData(data);
+    for(i=0;i<2;i++) {
+      fWire[i].UnpackEventData(data);
+      fRelPos[i].UnpackEventData(data);
+      fAbsPos[i].UnpackEventData(data);
+    }
+  }
+}
+
 
 QwBPMCavity& QwBPMCavity::operator+= (const QwBPMCavity &value)
 {
@@ -46,6 +46,13 @@ void  QwBPMStripline<T>::InitializeChannel(TString name)
 
   for(i=kXAxis;i<kNumAxes;i++) fRelPos[i].InitializeChannel(name+"Rel"+kAxisLabel[i],"derived");
 
+  fNumer.InitializeChannel("numerator","derived");
+  fDenom.InitializeChannel("denominator","derived");
+  fTmp1.InitializeChannel("tmp1","derived");
+  fTmp2.InitializeChannel("tmp2","derived");
+  fRawPos[kXAxis].InitializeChannel("rawpos_0","derived");
+  fRawPos[kYAxis].InitializeChannel("rawpos_1","derived");
+
   bFullSave=kTRUE;
 
   return;
@@ -80,6 +87,13 @@ void  QwBPMStripline<T>::InitializeChannel(TString subsystem, TString name)
 
   for(i=kXAxis;i<kNumAxes;i++) fRelPos[i].InitializeChannel(subsystem, "QwBPMStripline", name+"Rel"+kAxisLabel[i],"derived");
 
+  fNumer.InitializeChannel("numerator","derived");
+  fDenom.InitializeChannel("denominator","derived");
+  fTmp1.InitializeChannel("tmp1","derived");
+  fTmp2.InitializeChannel("tmp2","derived");
+  fRawPos[kXAxis].InitializeChannel("rawpos_0","derived");
+  fRawPos[kYAxis].InitializeChannel("rawpos_1","derived");
+
   bFullSave=kTRUE;
 
   return;
@@ -185,29 +199,33 @@ UInt_t QwBPMStripline<T>::UpdateErrorFlag()
 template<typename T>
 void QwBPMStripline<T>::UpdateErrorFlag(const VQwBPM *ev_error){
   Short_t i=0;
-  try {
-    if(typeid(*ev_error)==typeid(*this)) {
-      // std::cout<<" Here in QwBPMStripline::UpdateErrorFlag \n";
-      if (this->GetElementName()!="") {
-        const QwBPMStripline<T>* value_bpm = dynamic_cast<const QwBPMStripline<T>* >(ev_error);
-	for(i=0;i<4;i++){
-	  fWire[i].UpdateErrorFlag(value_bpm->fWire[i]);
-	}
-	for(i=kXAxis;i<kNumAxes;i++) {
-	  fRelPos[i].UpdateErrorFlag(value_bpm->fRelPos[i]);
-	  fAbsPos[i].UpdateErrorFlag(value_bpm->fAbsPos[i]); 
-	}
-	fEffectiveCharge.UpdateErrorFlag(value_bpm->fEffectiveCharge); 
-      }
-    } else {
-      TString loc="Standard exception from QwBPMStripline::UpdateErrorFlag :"+
-        ev_error->GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
+  if (this->GetElementName()!="") {
+    const QwBPMStripline<T>* value_bpm = static_cast<const QwBPMStripline<T>* >(ev_error);
+    for(i=0;i<4;i++){
+      fWire[i].UpdateErrorFlag(value_bpm->fWire[i]);
     }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }  
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].UpdateErrorFlag(value_bpm->fRelPos[i]);
+      fAbsPos[i].UpdateErrorFlag(value_bpm->fAbsPos[i]);
+    }
+    fEffectiveCharge.UpdateErrorFlag(value_bpm->fEffectiveCharge);
+  }
+};
+
+template<typename T>
+void QwBPMStripline<T>::MergeErrorCounters(const VQwBPM *source){
+  Short_t i=0;
+  if (this->GetElementName()!="") {
+    const QwBPMStripline<T>* input = static_cast<const QwBPMStripline<T>* >(source);
+    for(i=0;i<4;i++){
+      fWire[i].MergeErrorCounters(input->fWire[i]);
+    }
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].MergeErrorCounters(input->fRelPos[i]);
+      fAbsPos[i].MergeErrorCounters(input->fAbsPos[i]);
+    }
+    fEffectiveCharge.MergeErrorCounters(input->fEffectiveCharge);
+  }
 };
 
 
@@ -367,9 +385,6 @@ template<typename T>
 void  QwBPMStripline<T>::ProcessEvent()
 {
   Bool_t localdebug = kFALSE;
-  static T numer("numerator","derived"), denom("denominator","derived");
-  static T tmp1("tmp1","derived"), tmp2("tmp2","derived");
-  static T rawpos[2] = {T("rawpos_0","derived"),T("rawpos_1","derived")};
 
   Short_t i = 0;
 
@@ -411,10 +426,10 @@ void  QwBPMStripline<T>::ProcessEvent()
 //      fWire[i*2+1].PrintInfo();
       fWire[i*2+1].Scale(fRelativeGains[i]);
 //      fWire[i*2+1].PrintInfo();
-      numer.Difference(fWire[i*2],fWire[i*2+1]);
-      denom.Sum(fWire[i*2],fWire[i*2+1]);
-      rawpos[i].Ratio(numer,denom);
-      rawpos[i].Scale(fQwStriplineCalibration);
+      fNumer.Difference(fWire[i*2],fWire[i*2+1]);
+      fDenom.Sum(fWire[i*2],fWire[i*2+1]);
+      fRawPos[i].Ratio(fNumer,fDenom);
+      fRawPos[i].Scale(fQwStriplineCalibration);
 
       if(localdebug)
 	{
@@ -423,20 +438,20 @@ void  QwBPMStripline<T>::ProcessEvent()
 	  std::cout<<" hw  Wire["<<i*2<<"]="<<fWire[i*2].GetValue()<<"  ";
 	  std::cout<<" hw relative gain *  Wire["<<i*2+1<<"]="<<fWire[i*2+1].GetValue()<<"\n";
 	  std::cout<<" Relative gain["<<i<<"]="<<fRelativeGains[i]<<"\n";
-	  std::cout<<" hw numerator= "<<numer.GetValue()<<"  ";
-	  std::cout<<" hw denominator= "<<denom.GetValue()<<"\n";
+	  std::cout<<" hw numerator= "<<fNumer.GetValue()<<"  ";
+	  std::cout<<" hw denominator= "<<fDenom.GetValue()<<"\n";
 	  std::cout<<" Rotation = "<<fRotationAngle<<std::endl;
 	}
     }
 
   for(i=kXAxis;i<kNumAxes;i++){ 
-    tmp1.AssignScaledValue(rawpos[i],   fCosRotation);
+    fTmp1.AssignScaledValue(fRawPos[i],   fCosRotation);
 //    tmp1.PrintInfo();
-    tmp2.AssignScaledValue(rawpos[1-i], fSinRotation);
+    fTmp2.AssignScaledValue(fRawPos[1-i], fSinRotation);
     if (i == kXAxis) {
-      fRelPos[i].Difference(tmp1,tmp2);
+      fRelPos[i].Difference(fTmp1,fTmp2);
     } else {
-      fRelPos[i].Sum(tmp1,tmp2);
+      fRelPos[i].Sum(fTmp1,fTmp2);
     }
   }
 
@@ -554,11 +569,12 @@ void  QwBPMStripline<T>::GetAbsolutePosition()
 }
 
 
+/// The operators on a VQwBPM cast the operand to a QwBPMStripline<T> without a
+/// type check: QwBeamLine::Compare has checked the device types once.
 template<typename T>
 VQwBPM& QwBPMStripline<T>::operator= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwBPMStripline<T>*>(this)) =
-    *(dynamic_cast<const QwBPMStripline<T>*>(&value));
+  *this = static_cast<const QwBPMStripline<T>& >(value);
   return *this;
 }
 
@@ -580,11 +596,42 @@ QwBPMStripline<T>& QwBPMStripline<T>::operator= (const QwBPMStripline<T> &value)
   return *this;
 }
 
+template<typename T>
+void QwBPMStripline<T>::PackEventData(std::vector<Double_t>& buffer) const
+{
+  VQwBPM::PackEventData(buffer);
+
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.PackEventData(buffer);
+    for(i=0;i<4;i++) fWire[i].PackEventData(buffer);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].PackEventData(buffer);
+      fAbsPos[i].PackEventData(buffer);
+    }
+  }
+}
+
+template<typename T>
+void QwBPMStripline<T>::UnpackEventData(const Double_t*& data)
+{
+  VQwBPM::UnpackEventData(data);
+
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.UnpackEventData(data);
+    for(i=0;i<4;i++) fWire[i].UnpackEventData(data);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].UnpackEventData(data);
+      fAbsPos[i].UnpackEventData(data);
+    }
+  }
+}
+
 template<typename T>
 VQwBPM& QwBPMStripline<T>::operator+= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwBPMStripline<T>*>(this)) +=
-    *(dynamic_cast<const QwBPMStripline<T>*>(&value));
+  *this += static_cast<const QwBPMStripline<T>& >(value);
   return *this;
 }
 
@@ -607,8 +654,7 @@ QwBPMStripline<T>& QwBPMStripline<T>::operator+= (const QwBPMStripline<T> &value
 template<typename T>
 VQwBPM& QwBPMStripline<T>::operator-= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwBPMStripline<T>*>(this)) -=
-    *(dynamic_cast<const QwBPMStripline<T>*>(&value));
+  *this -= static_cast<const QwBPMStripline<T>& >(value);
   return *this;
 }
 template<typename T>
@@ -630,8 +676,8 @@ QwBPMStripline<T>& QwBPMStripline<T>::operator-= (const QwBPMStripline<T> &value
 template<typename T>
 void QwBPMStripline<T>::Ratio( VQwBPM &numer, VQwBPM &denom)
 {
-  Ratio(*dynamic_cast<QwBPMStripline<T>*>(&numer),
-      *dynamic_cast<QwBPMStripline<T>*>(&denom));
+  Ratio(static_cast<QwBPMStripline<T>& >(numer),
+      static_cast<QwBPMStripline<T>& >(denom));
 }
 
 template<typename T>
@@ -682,7 +728,7 @@ void QwBPMStripline<T>::CalculateRunningAverage()
 template<typename T>
 void QwBPMStripline<T>::AccumulateRunningSum(const VQwBPM& value)
 {
-  AccumulateRunningSum(*dynamic_cast<const QwBPMStripline<T>* >(&value));
+  AccumulateRunningSum(static_cast<const QwBPMStripline<T>& >(value));
 }
 
 template<typename T>
@@ -701,7 +747,7 @@ void QwBPMStripline<T>::AccumulateRunningSum(const QwBPMStripline<T>& value)
 }
 template<typename T>
 void    QwBPMStripline<T>::DeaccumulateRunningSum(VQwBPM& value){
-  DeaccumulateRunningSum(*dynamic_cast<QwBPMStripline<T>* >(&value));
+  DeaccumulateRunningSum(static_cast<QwBPMStripline<T>& >(value));
 };
 
 template<typename T>
@@ -1009,9 +1055,6 @@ void QwBPMStripline<T>::RandomizeEventData(int helicity, double time)
 /* First randomize AbsX and AbsY, then go backwards through the steps of QwBPMStripline<T>::ProcessEvent() to get the randomized wire values.*/
 
   size_t i;
-  static T numer("numerator","derived"), denom("denominator","derived");
-  static T tmp1("tmp1","derived"), tmp2("tmp2","derived");
-  static T rawpos[2] = {T("rawpos_0","derived"),T("rawpos_1","derived")};
 
   //  std::cout << "In QwBPMStripline<T>::RandomizeEventData" << std::endl;
   for(i=kXAxis;i<kNumAxes;i++){
@@ -1091,9 +1134,6 @@ void QwBPMStripline<T>::FillRawEventData()
  // XP = XM*(A+tmpX)/(A-tmpX);
 
   size_t i;
-  static T numer("numerator","derived"), denom("denominator","derived");
-  static T tmp1("tmp1","derived"), tmp2("tmp2","derived");
-  static T rawpos[2] = {T("rawpos_0","derived"),T("rawpos_1","derived")};
   int helicity = 0; double time = 0.0;
 
   for(i=kXAxis;i<kNumAxes;i++){
@@ -1104,30 +1144,30 @@ void QwBPMStripline<T>::FillRawEventData()
   }
 
   for(i=kXAxis; i<kNumAxes; i++){ 
-    tmp1.AssignScaledValue(fRelPos[i],   fCosRotation);
-    tmp2.AssignScaledValue(fRelPos[1-i], fSinRotation);
+    fTmp1.AssignScaledValue(fRelPos[i],   fCosRotation);
+    fTmp2.AssignScaledValue(fRelPos[1-i], fSinRotation);
     if (i == kXAxis) {
-      rawpos[i].Sum(tmp1,tmp2);
+      fRawPos[i].Sum(fTmp1,fTmp2);
     } else {
-      rawpos[i].Difference(tmp1,tmp2);
+      fRawPos[i].Difference(fTmp1,fTmp2);
     }
   }
 
   for(i=kXAxis; i<kNumAxes; i++){
-      numer.AssignScaledValue(rawpos[i],1.0);
-      numer.AddChannelOffset(fQwStriplineCalibration);
-      denom.AssignScaledValue(rawpos[i],-1.0);
-      denom.AddChannelOffset(fQwStriplineCalibration);
+      fNumer.AssignScaledValue(fRawPos[i],1.0);
+      fNumer.AddChannelOffset(fQwStriplineCalibration);
+      fDenom.AssignScaledValue(fRawPos[i],-1.0);
+      fDenom.AddChannelOffset(fQwStriplineCalibration);
       // tmp2.SetRandomEventParameters(5.0, 0.005);
-      tmp2.SetRandomEventParameters(5.0, 0.0);
-      tmp2.RandomizeEventData(helicity, time);
-      tmp1.Ratio(numer,denom);
-      if (tmp1.GetValue()<1.0){
-         fWire[i*2+1].AssignScaledValue(tmp2, 1.0);
-         fWire[i*2].Product(tmp1, tmp2);
+      fTmp2.SetRandomEventParameters(5.0, 0.0);
+      fTmp2.RandomizeEventData(helicity, time);
+      fTmp1.Ratio(fNumer,fDenom);
+      if (fTmp1.GetValue()<1.0){
+         fWire[i*2+1].AssignScaledValue(fTmp2, 1.0);
+         fWire[i*2].Product(fTmp1, fTmp2);
       } else {
-         fWire[i*2].AssignScaledValue(tmp2, 1.0);
-         fWire[i*2+1].Ratio(tmp2, tmp1);
+         fWire[i*2].AssignScaledValue(fTmp2, 1.0);
+         fWire[i*2+1].Ratio(fTmp2, fTmp1);
       }
       fWire[i*2].SetRawEventData();
       fWire[i*2+1].SetRawEventData();
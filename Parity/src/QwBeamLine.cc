@@ -423,11 +423,52 @@ Int_t QwBeamLine::LoadChannelMap(TString mapfile)
     }
   }
   ldebug=kFALSE;
-  
+
+  // Resolve the devices read out in each subbank
+  BuildSubbankDecodeMap();
+
+  // Copies of this beamline share its device types
+  fDeviceLayout = ++fNextDeviceLayout;
+
   mapstr.Close(); // Close the file (ifstream)
   return 0;
 }
 
+//*****************************************************************//
+/**
+ * Collect, for each subbank, the devices to be decoded from it with their
+ * word offset and subelement, in channel map order.  Only the readout
+ * devices are included; combined devices have no data in the subbanks.
+ * Must be called again whenever the device vectors are rebuilt.
+ */
+void QwBeamLine::BuildSubbankDecodeMap()
+{
+  fSubbankDecodeMap.Clear();
+  for (size_t i = 0; i < fBeamDetectorID.size(); i++) {
+    const QwBeamDetectorID& id = fBeamDetectorID[i];
+    if (id.fSubbankIndex < 0 || id.fIndex < 0) continue;
+    switch (id.fTypeID) {
+      // Devices with several channels in the subbank
+      case kQwBPMStripline:
+      case kQwQPD:
+      case kQwLinearArray:
+      case kQwBPMCavity:
+        fSubbankDecodeMap.AddTarget(id.fSubbankIndex, GetElement(id),
+                                    id.fWordInSubbank, id.fSubelement);
+        break;
+      // Devices with a single channel
+      case kQwBCM:
+      case kQwClock:
+      case kQwHaloMonitor:
+        fSubbankDecodeMap.AddTarget(id.fSubbankIndex, GetElement(id),
+                                    id.fWordInSubbank);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 
 //*****************************************************************//
 Int_t QwBeamLine::LoadEventCuts(TString  filename)
@@ -1165,102 +1206,7 @@ Int_t QwBeamLine::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id,
 		  << std::endl;
     }
 
-    for(size_t i=0;i<fBeamDetectorID.size();i++)
-      {
-	if(fBeamDetectorID[i].fSubbankIndex==index)
-	  {
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBPMStripline)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found stripline data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fStripline[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwQPD)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found qpd data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fQPD[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwLinearArray)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found linear array data for "<<fBeamDetectorID[i].fdetectorname<<fBeamDetectorID[i].fIndex<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fLinearArray[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBPMCavity)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found stripline data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fCavity[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBCM)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found bcm data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fBCM[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwClock)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found clock data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fClock[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwHaloMonitor)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found halo monitor data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fHaloMonitor[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
-
-	  }
-      }
+    fSubbankDecodeMap.ProcessEvBuffer(index, buffer, num_words);
   }
 
   return 0;
@@ -1535,6 +1481,35 @@ void QwBeamLine::UpdateErrorFlag(const VQwSubsystem *ev_error){
     }
 }
 
+void QwBeamLine::MergeErrorCounters(const VQwSubsystem *source){
+  VQwSubsystem* tmp = const_cast<VQwSubsystem*>(source);
+  if(Compare(tmp))
+    {
+      const QwBeamLine* input = dynamic_cast<const QwBeamLine*>(source);
+
+      for(size_t i=0;i<input->fClock.size();i++)
+	(this->fClock[i].get())->MergeErrorCounters(input->fClock[i].get());
+      for(size_t i=0;i<input->fStripline.size();i++)
+	(this->fStripline[i].get())->MergeErrorCounters(input->fStripline[i].get());
+      for(size_t i=0;i<input->fQPD.size();i++)
+	(this->fQPD[i]).MergeErrorCounters(&(input->fQPD[i]));
+      for(size_t i=0;i<input->fLinearArray.size();i++)
+	(this->fLinearArray[i]).MergeErrorCounters(&(input->fLinearArray[i]));
+      for(size_t i=0;i<input->fCavity.size();i++)
+	(this->fCavity[i]).MergeErrorCounters(&(input->fCavity[i]));
+      for(size_t i=0;i<input->fBCM.size();i++)
+	(this->fBCM[i].get())->MergeErrorCounters(input->fBCM[i].get());
+      for(size_t i=0;i<input->fBCMCombo.size();i++)
+	(this->fBCMCombo[i].get())->MergeErrorCounters(input->fBCMCombo[i].get());
+      for(size_t i=0;i<input->fBPMCombo.size();i++)
+	(this->fBPMCombo[i].get())->MergeErrorCounters(input->fBPMCombo[i].get());
+      for(size_t i=0;i<input->fECalculator.size();i++)
+	(this->fECalculator[i]).MergeErrorCounters(&(input->fECalculator[i]));
+      for(size_t i=0;i<input->fHaloMonitor.size();i++)
+	(this->fHaloMonitor[i]).MergeErrorCounters(&(input->fHaloMonitor[i]));
+    }
+}
+
 
 //*****************************************************************//
 void  QwBeamLine::ProcessEvent()
@@ -2065,6 +2040,59 @@ VQwSubsystem&  QwBeamLine::operator=  (VQwSubsystem *value)
 }
 
 
+//*****************************************************************//
+Bool_t QwBeamLine::PackEventData(std::vector<Double_t>& buffer) const
+{
+  //  Same devices as operator=, without the publishing list which does
+  //  not change from event to event
+  for(size_t i=0;i<fClock.size();i++)
+    fClock[i]->PackEventData(buffer);
+  for(size_t i=0;i<fStripline.size();i++)
+    fStripline[i]->PackEventData(buffer);
+  for(size_t i=0;i<fQPD.size();i++)
+    fQPD[i].PackEventData(buffer);
+  for(size_t i=0;i<fLinearArray.size();i++)
+    fLinearArray[i].PackEventData(buffer);
+  for(size_t i=0;i<fCavity.size();i++)
+    fCavity[i].PackEventData(buffer);
+  for(size_t i=0;i<fBCM.size();i++)
+    fBCM[i]->PackEventData(buffer);
+  for(size_t i=0;i<fHaloMonitor.size();i++)
+    fHaloMonitor[i].PackEventData(buffer);
+  for(size_t i=0;i<fBCMCombo.size();i++)
+    fBCMCombo[i]->PackEventData(buffer);
+  for(size_t i=0;i<fBPMCombo.size();i++)
+    fBPMCombo[i]->PackEventData(buffer);
+  for(size_t i=0;i<fECalculator.size();i++)
+    fECalculator[i].PackEventData(buffer);
+  return kTRUE;
+}
+
+void QwBeamLine::UnpackEventData(const Double_t*& data)
+{
+  for(size_t i=0;i<fClock.size();i++)
+    fClock[i]->UnpackEventData(data);
+  for(size_t i=0;i<fStripline.size();i++)
+    fStripline[i]->UnpackEventData(data);
+  for(size_t i=0;i<fQPD.size();i++)
+    fQPD[i].UnpackEventData(data);
+  for(size_t i=0;i<fLinearArray.size();i++)
+    fLinearArray[i].UnpackEventData(data);
+  for(size_t i=0;i<fCavity.size();i++)
+    fCavity[i].UnpackEventData(data);
+  for(size_t i=0;i<fBCM.size();i++)
+    fBCM[i]->UnpackEventData(data);
+  for(size_t i=0;i<fHaloMonitor.size();i++)
+    fHaloMonitor[i].UnpackEventData(data);
+  for(size_t i=0;i<fBCMCombo.size();i++)
+    fBCMCombo[i]->UnpackEventData(data);
+  for(size_t i=0;i<fBPMCombo.size();i++)
+    fBPMCombo[i]->UnpackEventData(data);
+  for(size_t i=0;i<fECalculator.size();i++)
+    fECalculator[i].UnpackEventData(data);
+}
+
+
 //*****************************************************************//
 VQwSubsystem&  QwBeamLine::operator+=  (VQwSubsystem *value)
 {
@@ -2334,6 +2362,30 @@ void QwBeamLine::DeaccumulateRunningSum(VQwSubsystem* value1){
   }
 };
 
+//*****************************************************************//
+UInt_t QwBeamLine::fNextDeviceLayout = 0;
+
+/**
+ * Check that the templated devices of two beamlines have the same types,
+ * so that the arithmetic of the devices can cast its operands without
+ * run-time type checks.  Beamlines copied from the same channel map share
+ * the layout number and are not checked again.
+ */
+Bool_t QwBeamLine::CompareDeviceTypes(const QwBeamLine* input) const
+{
+  for(size_t i=0;i<fClock.size();i++)
+    if(typeid(*(input->fClock[i].get()))!=typeid(*(fClock[i].get()))) return kFALSE;
+  for(size_t i=0;i<fStripline.size();i++)
+    if(typeid(*(input->fStripline[i].get()))!=typeid(*(fStripline[i].get()))) return kFALSE;
+  for(size_t i=0;i<fBCM.size();i++)
+    if(typeid(*(input->fBCM[i].get()))!=typeid(*(fBCM[i].get()))) return kFALSE;
+  for(size_t i=0;i<fBCMCombo.size();i++)
+    if(typeid(*(input->fBCMCombo[i].get()))!=typeid(*(fBCMCombo[i].get()))) return kFALSE;
+  for(size_t i=0;i<fBPMCombo.size();i++)
+    if(typeid(*(input->fBPMCombo[i].get()))!=typeid(*(fBPMCombo[i].get()))) return kFALSE;
+  return kTRUE;
+}
+
 //*****************************************************************//
 Bool_t QwBeamLine::Compare(VQwSubsystem *value)
 {
@@ -2379,6 +2431,8 @@ Bool_t QwBeamLine::Compare(VQwSubsystem *value)
 	res=kFALSE;
       }else if(input->fQPD.size()!=fQPD.size()){
 	res=kFALSE;
+      }else if(input->fDeviceLayout!=fDeviceLayout && !CompareDeviceTypes(input)){
+	res=kFALSE;
       }
  
     }
@@ -444,10 +444,30 @@ Int_t QwBlindDetectorArray::LoadChannelMap(TString mapfile)
           fMainDetID[i].Print();
     }
   ldebug=kFALSE;
+
+  // Resolve the PMTs read out in each subbank
+  BuildSubbankDecodeMap();
+
   mapstr.Close(); // Close the file (ifstream)
   return 0;
 }
 
+/**
+ * Collect, for each subbank, the integration PMTs to be decoded from it
+ * with their word offset, in channel map order.  Must be called again
+ * whenever fIntegrationPMT is rebuilt.
+ */
+void QwBlindDetectorArray::BuildSubbankDecodeMap()
+{
+  fSubbankDecodeMap.Clear();
+  for (size_t i = 0; i < fMainDetID.size(); i++) {
+    if (fMainDetID[i].fTypeID == kQwIntegrationPMT && fMainDetID[i].fIndex >= 0)
+      fSubbankDecodeMap.AddTarget(fMainDetID[i].fSubbankIndex,
+                                  &(fIntegrationPMT[fMainDetID[i].fIndex]),
+                                  fMainDetID[i].fWordInSubbank);
+  }
+}
+
 
 Int_t QwBlindDetectorArray::LoadEventCuts(TString filename)
 {
@@ -719,59 +739,54 @@ void  QwBlindDetectorArray::RandomizeMollerEvent(int helicity /*, const QwBeamCh
   fTargetYprime.PrintInfo();
   fTargetEnergy.PrintInfo();*/
 
-  if(RequestExternalValue("x_targ", &fTargetX)){
+  if(fTargetXHandle.IsValid()){
+    fTargetX.AssignValueFrom(fTargetXHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetX)->PrintInfo();
       QwWarning << "QwBlindDetectorArray::RandomizeMollerEvent Found "<<fTargetX.GetElementName()<< QwLog::endl;  
     }    
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetX.GetElementName() << QwLog::endl;
   }
 
-  if(RequestExternalValue("y_targ", &fTargetY)){
+  if(fTargetYHandle.IsValid()){
+    fTargetY.AssignValueFrom(fTargetYHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetY)->PrintInfo();
       QwWarning << "QwBlindDetectorArray::RandomizeMollerEvent Found "<<fTargetY.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetY.GetElementName() << QwLog::endl;
   }
 
-  if(RequestExternalValue("xp_targ", &fTargetXprime)){
+  if(fTargetXprimeHandle.IsValid()){
+    fTargetXprime.AssignValueFrom(fTargetXprimeHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetXprime)->PrintInfo();
       QwWarning << "QwBlindDetectorArray::RandomizeMollerEvent Found "<<fTargetXprime.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetXprime.GetElementName() << QwLog::endl;
   }
   
-  if(RequestExternalValue("yp_targ", &fTargetYprime)){
+  if(fTargetYprimeHandle.IsValid()){
+    fTargetYprime.AssignValueFrom(fTargetYprimeHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetYprime)->PrintInfo();
       QwWarning << "QwBlindDetectorArray::RandomizeMollerEvent Found "<<fTargetYprime.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetYprime.GetElementName() << QwLog::endl;
   }
   
-  if(RequestExternalValue("e_targ", &fTargetEnergy)){
+  if(fTargetEnergyHandle.IsValid()){
+    fTargetEnergy.AssignValueFrom(fTargetEnergyHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetEnergy)->PrintInfo();
       QwWarning << "QwBlindDetectorArray::RandomizeMollerEvent Found "<<fTargetEnergy.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetEnergy.GetElementName() << QwLog::endl;
   }
     
   for (size_t i = 0; i < fMainDetID.size(); i++) 
@@ -813,23 +828,7 @@ Int_t QwBlindDetectorArray::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t
         << " and subbank "<<bank_id
         << " number of words="<<num_words<<std::endl;
 
-      for (size_t i=0;i<fMainDetID.size();i++)
-        {
-          if (fMainDetID[i].fSubbankIndex==index)
-            {
-
-              if (fMainDetID[i].fTypeID == kQwIntegrationPMT)
-                {
-                  if (lkDEBUG)
-                    {
-                      std::cout<<"found IntegrationPMT data for "<<fMainDetID[i].fdetectorname<<std::endl;
-                      std::cout<<"word left to read in this buffer:"<<num_words-fMainDetID[i].fWordInSubbank<<std::endl;
-                    }
-                  fIntegrationPMT[fMainDetID[i].fIndex].ProcessEvBuffer(&(buffer[fMainDetID[i].fWordInSubbank]),
-                      num_words-fMainDetID[i].fWordInSubbank);
-                }
-            }
-        }
+      fSubbankDecodeMap.ProcessEvBuffer(index, buffer, num_words);
     }
 
   return 0;
@@ -911,6 +910,19 @@ void QwBlindDetectorArray::UpdateErrorFlag(const VQwSubsystem *ev_error){
   }
 };
 
+void QwBlindDetectorArray::MergeErrorCounters(const VQwSubsystem *source){
+  VQwSubsystem* tmp = const_cast<VQwSubsystem*>(source);
+  if(Compare(tmp)){
+    const QwBlindDetectorArray* input = dynamic_cast<const QwBlindDetectorArray*> (source);
+
+    for (size_t i=0;i<input->fIntegrationPMT.size();i++)
+      this->fIntegrationPMT[i].MergeErrorCounters(&(input->fIntegrationPMT[i]));
+
+    for (size_t i=0;i<input->fCombinedPMT.size();i++)
+      this->fCombinedPMT[i].MergeErrorCounters(&(input->fCombinedPMT[i]));
+  }
+};
+
 
 void  QwBlindDetectorArray::ProcessEvent()
 {
@@ -927,6 +939,20 @@ void  QwBlindDetectorArray::ProcessEvent()
   return;
 }
 
+/**
+ * Look up the published beam parameters, once all subsystems in the
+ * parent array have published their values
+ */
+void  QwBlindDetectorArray::ResolveExternalValues()
+{
+  fTargetChargeHandle.Resolve(*this, "q_targ");
+  fTargetXHandle.Resolve(*this, "x_targ");
+  fTargetYHandle.Resolve(*this, "y_targ");
+  fTargetXprimeHandle.Resolve(*this, "xp_targ");
+  fTargetYprimeHandle.Resolve(*this, "yp_targ");
+  fTargetEnergyHandle.Resolve(*this, "e_targ");
+}
+
 /**
  * Exchange data between subsystems
  */
@@ -974,7 +1000,8 @@ void  QwBlindDetectorArray::ExchangeProcessedData()
 
     */
 
-    if(RequestExternalValue("q_targ", &fTargetCharge)){
+    if(fTargetChargeHandle.IsValid()){
+      fTargetCharge.AssignValueFrom(fTargetChargeHandle.Get());
       if (bDEBUG){
 	QwWarning << "QwBlindDetectorArray::ExchangeProcessedData Found "<<fTargetCharge.GetElementName()<< QwLog::endl;
 	//QwWarning <<"****QwBlindDetectorArray****"<< QwLog::endl;
@@ -983,8 +1010,6 @@ void  QwBlindDetectorArray::ExchangeProcessedData()
     }
     else{
       bIsExchangedDataValid = kFALSE;
-      QwError << GetSubsystemName() << " could not get external value for "
-	      << fTargetCharge.GetElementName() << QwLog::endl;
     }
     
   }
@@ -1147,6 +1172,28 @@ VQwSubsystem&  QwBlindDetectorArray::operator=  (VQwSubsystem *value)
 }
 
 
+Bool_t QwBlindDetectorArray::PackEventData(std::vector<Double_t>& buffer) const
+{
+  for (size_t i=0;i<fIntegrationPMT.size();i++)
+    fIntegrationPMT[i].PackEventData(buffer);
+
+  for (size_t i=0;i<fCombinedPMT.size();i++)
+    fCombinedPMT[i].PackEventData(buffer);
+
+  return kTRUE;
+}
+
+
+void QwBlindDetectorArray::UnpackEventData(const Double_t*& data)
+{
+  for (size_t i=0;i<fIntegrationPMT.size();i++)
+    fIntegrationPMT[i].UnpackEventData(data);
+
+  for (size_t i=0;i<fCombinedPMT.size();i++)
+    fCombinedPMT[i].UnpackEventData(data);
+}
+
+
 VQwSubsystem&  QwBlindDetectorArray::operator+=  (VQwSubsystem *value)
 {
   if (Compare(value))
@@ -79,6 +79,7 @@ QwBlinder::QwBlinder(const EQwBlindingStrategy blinding_strategy):
   //
   fBeamCurrentThreshold(1.0),
   fBeamIsPresent(kFALSE),
+  fTargetChargeSource(0),
   fBlindingStrategy(blinding_strategy),
   fBlindingOffset(0.0),
   fBlindingOffset_Base(0.0),
@@ -162,18 +163,20 @@ void QwBlinder::Update(QwParityDB* db)
  */
 void QwBlinder::Update(const QwSubsystemArrayParity& detectors)
 {
-  static QwVQWK_Channel q_targ("q_targ");
   if (fBlindingStrategy != kDisabled && fTargetBlindability==kBlindable) {
     // Check for the target blindability flag
     
 
+    // Look up the target charge only when the array changes
+    if (&detectors != fTargetChargeSource) {
+      fTargetCharge.Resolve(detectors, "q_targ");
+      fTargetChargeSource = &detectors;
+    }
+
     // Check that the current on target is above acceptable limit
     Bool_t tmp_beam = kFALSE;
-    //    if (detectors.ReturnInternalValue(q_targ.GetElementName(), &q_targ)) {
-    if (detectors.ReturnInternalValue("q_targ", &q_targ)) {
-      if (q_targ.GetValue() > fBeamCurrentThreshold){
-	// 	std::cerr << "q_targ.GetValue()==" 
-	// 		  << q_targ.GetValue() << std::endl;
+    if (fTargetCharge.IsValid()) {
+      if (fTargetCharge->GetValue() > fBeamCurrentThreshold){
 	tmp_beam = kTRUE;
       }
     }
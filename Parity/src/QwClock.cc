@@ -161,34 +161,15 @@ QwClock<T>& QwClock<T>::operator= (const QwClock<T> &value)
 }
 
 template<typename T>
+/**
+ * The operators on a VQwClock are called from the arithmetic of QwBeamLine,
+ * which has checked once that both beamlines hold the same types of
+ * devices, so the operand is cast to a QwClock<T> without a run-time
+ * type check.
+ */
 VQwClock& QwClock<T>::operator= (const VQwClock &value)
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwClock::operator= \n";
-      if (this->GetElementName()!="") {
-        const QwClock<T>* value_bcm = dynamic_cast<const QwClock<T>* >(&value);
-        QwClock<T>* this_cast = dynamic_cast<QwClock<T>* >(this);
-        this_cast->fClock= value_bcm->fClock;
-        this_cast->fPedestal=value_bcm->fPedestal;
-        this_cast->fCalibration=value_bcm->fCalibration;
-      }
-    } else {
-      TString loc="Standard exception from QwClock::operato= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
-    }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
-//   std::cout<<" to be copied \n";
-//   value.Print();
-//   std::cout<<" copied \n";
-//   this->Print();
-
-  return *this;
-
+  return *this = static_cast<const QwClock<T>& >(value);
 }
 
 template<typename T>
@@ -206,65 +187,24 @@ QwClock<T>& QwClock<T>::operator+= (const QwClock<T> &value)
 template<typename T>
 VQwClock& QwClock<T>::operator+= (const VQwClock &value)
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwClock::operator+= \n";
-      if (this->GetElementName()!="") {
-        const QwClock<T>* value_bcm = dynamic_cast<const QwClock<T>* >(&value);
-        QwClock<T>* this_cast = dynamic_cast<QwClock<T>* >(this);
-        this_cast->fClock+=value_bcm->fClock;
-        this_cast->fPedestal+=value_bcm->fPedestal;
-        this_cast->fCalibration=0;
-      }
-    } else {
-      TString loc="Standard exception from QwClock::operator+= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
-    }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
-
- return *this;
+  return *this += static_cast<const QwClock<T>& >(value);
 }
 
 template<typename T>
 VQwClock& QwClock<T>::operator-= (const VQwClock &value)
 {
-  if (this->GetElementName()!="")
-    {
-      const QwClock<T>* value_bcm = dynamic_cast<const QwClock<T>* >(&value);
-      QwClock<T>* this_cast = dynamic_cast<QwClock<T>* >(this);
-      this_cast->fClock-=value_bcm->fClock;
-      this_cast->fPedestal-=value_bcm->fPedestal;
-      this_cast->fCalibration=0;
-    }
-  return *this;
+  return *this -= static_cast<const QwClock<T>& >(value);
 }
 
 template<typename T>
 QwClock<T>& QwClock<T>::operator-= (const QwClock<T> &value)
 {
-  try {
-    if(typeid(value)==typeid(*this)) {
-      // std::cout<<" Here in QwClock::operator-= \n";
-      if (this->GetElementName()!="") {
-        const QwClock<T>* value_bcm = dynamic_cast<const QwClock<T>* >(&value);
-        QwClock<T>* this_cast = dynamic_cast<QwClock<T>* >(this);
-        this_cast->fClock-=value_bcm->fClock;
-        this_cast->fPedestal-=value_bcm->fPedestal;
-        this_cast->fCalibration=0;
-      }
-    } else {
-      TString loc="Standard exception from QwClock::operator-= :"+
-        value.GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
+  if (this->GetElementName()!="")
+    {
+      this->fClock-=value.fClock;
+      this->fPedestal-=value.fPedestal;
+      this->fCalibration=0;
     }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }
   return *this;
 }
 
@@ -284,8 +224,8 @@ void QwClock<T>::Difference(QwClock<T> &value1, QwClock<T> &value2){
 template<typename T>
 void QwClock<T>::Ratio(const VQwClock &numer, const VQwClock &denom)
 {
-  Ratio(*dynamic_cast<const QwClock<T>* >(&numer),
-      *dynamic_cast<const QwClock<T>* >(&denom));
+  Ratio(static_cast<const QwClock<T>& >(numer),
+      static_cast<const QwClock<T>& >(denom));
 }
 
 template<typename T>
@@ -317,7 +257,7 @@ void QwClock<T>::CalculateRunningAverage(){
 template<typename T>
 void QwClock<T>::AccumulateRunningSum(const VQwClock& value) {
   fClock.AccumulateRunningSum(
-      dynamic_cast<const QwClock<T>* >(&value)->fClock);
+      static_cast<const QwClock<T>& >(value).fClock);
 }
 
 template<typename T>
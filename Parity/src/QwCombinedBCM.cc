@@ -66,6 +66,7 @@ void  QwCombinedBCM<T>::InitializeChannel(TString name, TString datatosave)
   fLastTripTime = -99999.9;
   this->SetElementName(name);
   this->fBeamCurrent.InitializeChannel(name,"derived");
+  fTmpADC.InitializeChannel("tmp","derived");
 }
 
 template<typename T>
@@ -76,6 +77,7 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name, TStri
   fLastTripTime = -99999.9;
   this->SetElementName(name);
   this->fBeamCurrent.InitializeChannel(subsystem, "QwCombinedBCM", name,"derived");
+  fTmpADC.InitializeChannel("tmp","derived");
 }
 
 template<typename T>
@@ -88,6 +90,7 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name,
   this->SetElementName(name);
   this->SetModuleType(type);
   this->fBeamCurrent.InitializeChannel(subsystem, "QwCombinedBCM", name,"derived");
+  fTmpADC.InitializeChannel("tmp","derived");
 }
 
 
@@ -95,15 +98,12 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name,
 template<typename T>
 void  QwCombinedBCM<T>::ProcessEvent()
 {
-  static T tmpADC;
-  tmpADC.InitializeChannel("tmp","derived");
-
   this->ClearEventData();
 
   for (size_t i = 0; i < fElement.size(); i++) {
-    tmpADC = fElement[i]->fBeamCurrent;
-    tmpADC.Scale(fWeights[i]);
-    this->fBeamCurrent += tmpADC;
+    fTmpADC = fElement[i]->fBeamCurrent;
+    fTmpADC.Scale(fWeights[i]);
+    this->fBeamCurrent += fTmpADC;
   }
   this->fBeamCurrent.Scale(1.0/fSumQweights);
 
@@ -297,11 +297,7 @@ QwCombinedBCM<T>& QwCombinedBCM<T>::operator= (const QwCombinedBCM<T> &value)
 template<typename T>
 VQwBCM& QwCombinedBCM<T>::operator= (const VQwBCM &value)
 {
-  if (this->GetElementName()!="")
-    dynamic_cast<QwCombinedBCM<T>* >(this)->fBeamCurrent=
-      dynamic_cast<const QwCombinedBCM<T>* >(&value)->fBeamCurrent;
-
-  return *this;
+  return *this = static_cast<const QwCombinedBCM<T>& >(value);
 }
 
 
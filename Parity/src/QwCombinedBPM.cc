@@ -34,6 +34,15 @@ void  QwCombinedBPM<T>::InitializeChannel(TString name)
     fMinimumChiSquare[axis].InitializeChannel(name+kAxisLabel[axis]+"MinChiSquare","derived");
   }
 
+  fTmpQADC.InitializeChannel("tmpQADC","raw");
+  fTmp1.InitializeChannel("tmp1","derived");
+  fTmp2.InitializeChannel("tmp2","derived");
+  fTmp3.InitializeChannel("tmp3","derived");
+  fC[kXAxis].InitializeChannel("cx","derived");
+  fC[kYAxis].InitializeChannel("cy","derived");
+  fE[kXAxis].InitializeChannel("ex","derived");
+  fE[kYAxis].InitializeChannel("ey","derived");
+
   fixedParamCalculated = false;
 
   fElement.clear();
@@ -70,6 +79,15 @@ void  QwCombinedBPM<T>::InitializeChannel(TString subsystem, TString name)
     fIntercept[axis].InitializeChannel(subsystem, "QwCombinedBPM", name+kAxisLabel[axis]+"Intercept","derived");
     fMinimumChiSquare[axis].InitializeChannel(subsystem, "QwCombinedBPM",name+kAxisLabel[axis]+"MinChiSquare","derived");
   }
+
+  fTmpQADC.InitializeChannel("tmpQADC","raw");
+  fTmp1.InitializeChannel("tmp1","derived");
+  fTmp2.InitializeChannel("tmp2","derived");
+  fTmp3.InitializeChannel("tmp3","derived");
+  fC[kXAxis].InitializeChannel("cx","derived");
+  fC[kYAxis].InitializeChannel("cy","derived");
+  fE[kXAxis].InitializeChannel("ex","derived");
+  fE[kYAxis].InitializeChannel("ey","derived");
   
   fixedParamCalculated = false;
 
@@ -428,28 +446,31 @@ void QwCombinedBPM<T>::SetSingleEventCuts(TString ch_name, UInt_t errorflag,Doub
 template<typename T>
 void QwCombinedBPM<T>::UpdateErrorFlag(const VQwBPM *ev_error){
   Short_t i=0;
-  try {
-    if(typeid(*ev_error)==typeid(*this)) {
-      // std::cout<<" Here in QwBPMStripline::UpdateErrorFlag \n";
-      if (this->GetElementName()!="") {
-        const QwCombinedBPM<T>* value_bpm = dynamic_cast<const QwCombinedBPM<T>* >(ev_error);
-	for(i=kXAxis;i<kNumAxes;i++) {
-	  fAbsPos[i].UpdateErrorFlag(value_bpm->fAbsPos[i]);
-	  fSlope[i].UpdateErrorFlag(value_bpm->fSlope[i]);
-	  fIntercept[i].UpdateErrorFlag(value_bpm->fIntercept[i]);
-	  fMinimumChiSquare[i].UpdateErrorFlag(value_bpm->fMinimumChiSquare[i]);
-	}
-	fEffectiveCharge.UpdateErrorFlag(value_bpm->fEffectiveCharge);
-      }
-    } else {
-      TString loc="Standard exception from QwCombinedBPM::UpdateErrorFlag :"+
-        ev_error->GetElementName()+" "+this->GetElementName()+" are not of the "
-        +"same type";
-      throw std::invalid_argument(loc.Data());
+  if (this->GetElementName()!="") {
+    const QwCombinedBPM<T>* value_bpm = static_cast<const QwCombinedBPM<T>* >(ev_error);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fAbsPos[i].UpdateErrorFlag(value_bpm->fAbsPos[i]);
+      fSlope[i].UpdateErrorFlag(value_bpm->fSlope[i]);
+      fIntercept[i].UpdateErrorFlag(value_bpm->fIntercept[i]);
+      fMinimumChiSquare[i].UpdateErrorFlag(value_bpm->fMinimumChiSquare[i]);
     }
-  } catch (std::exception& e) {
-    std::cerr<< e.what()<<std::endl;
-  }  
+    fEffectiveCharge.UpdateErrorFlag(value_bpm->fEffectiveCharge);
+  }
+};
+
+template<typename T>
+void QwCombinedBPM<T>::MergeErrorCounters(const VQwBPM *source){
+  Short_t i=0;
+  if (this->GetElementName()!="") {
+    const QwCombinedBPM<T>* input = static_cast<const QwCombinedBPM<T>* >(source);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fAbsPos[i].MergeErrorCounters(input->fAbsPos[i]);
+      fSlope[i].MergeErrorCounters(input->fSlope[i]);
+      fIntercept[i].MergeErrorCounters(input->fIntercept[i]);
+      fMinimumChiSquare[i].MergeErrorCounters(input->fMinimumChiSquare[i]);
+    }
+    fEffectiveCharge.MergeErrorCounters(input->fEffectiveCharge);
+  }
 };
 
 
@@ -459,8 +480,6 @@ void  QwCombinedBPM<T>::ProcessEvent()
 {
   Bool_t ldebug = kFALSE;
 
-  static T  tmpQADC("tmpQADC"), tmpADC("tmpADC");
-
   this->ClearEventData();
   //check to see if the fixed parameters are calculated
   if(!fixedParamCalculated){
@@ -478,9 +497,9 @@ void  QwCombinedBPM<T>::ProcessEvent()
 	       <<" and  y weight ="<<fYWeights[i]<<"\n"<<std::flush;
 
     }
-    tmpQADC.AssignValueFrom(fElement[i]->GetEffectiveCharge());
-    tmpQADC.Scale(fQWeights[i]);
-    fEffectiveCharge+=tmpQADC;
+    fTmpQADC.AssignValueFrom(fElement[i]->GetEffectiveCharge());
+    fTmpQADC.Scale(fQWeights[i]);
+    fEffectiveCharge+=fTmpQADC;
 
 
     if(ldebug) {
@@ -556,7 +575,7 @@ template<typename T>
  {
 
    Bool_t ldebug = kFALSE;
-   static Double_t zpos = 0.0;
+   Double_t zpos = 0.0;
 
    for(size_t i=0;i<fElement.size();i++){
      zpos = fElement[i]->GetPositionInZ();
@@ -619,46 +638,35 @@ template<typename T>
    **/
 
    Bool_t ldebug = kFALSE;
-   static Double_t zpos = 0;
-   static T tmp1("tmp1","derived");
-   static T tmp2("tmp2","derived");
-   static T tmp3("tmp3","derived");
-   static T C[kNumAxes];
-   static T E[kNumAxes];
-
-   // initialize the VQWK_Channel arrays
-   C[kXAxis].InitializeChannel("cx","derived");
-   C[kYAxis].InitializeChannel("cy","derived");
-   E[kXAxis].InitializeChannel("ex","derived");
-   E[kYAxis].InitializeChannel("ey","derived");
-
-   C[axis].ClearEventData();
-   E[axis].ClearEventData();
+   Double_t zpos = 0;
+
+   fC[axis].ClearEventData();
+   fE[axis].ClearEventData();
    for(size_t i=0;i<fElement.size();i++){
      zpos = fElement[i]->GetPositionInZ();
-     tmp1.ClearEventData();
-     tmp1.AssignValueFrom(fElement[i]->GetPosition(axis));
-     tmp1.Scale(fWeights[i]);
-     C[axis] += tmp1; //xw or yw
-     tmp1.Scale(zpos);//xzw or yzw
-     E[axis] += tmp1;
+     fTmp1.ClearEventData();
+     fTmp1.AssignValueFrom(fElement[i]->GetPosition(axis));
+     fTmp1.Scale(fWeights[i]);
+     fC[axis] += fTmp1; //xw or yw
+     fTmp1.Scale(zpos);//xzw or yzw
+     fE[axis] += fTmp1;
    }
 
    if(ldebug) std::cout<<"\n A ="<<A[axis]
 		       <<" -- B ="<<B[axis]
-		       <<" --C ="<<C[axis].GetValue()
+		       <<" --C ="<<fC[axis].GetValue()
 		       <<" --D ="<<D[axis]
-		       <<" --E ="<<E[axis].GetValue()<<"\n";
+		       <<" --E ="<<fE[axis].GetValue()<<"\n";
 
    // calculate the slope  a = E*erra + C*covab
-   fSlope[axis].AssignScaledValue(E[axis], erra[axis]);
-   tmp2.AssignScaledValue(C[axis], covab[axis]);
-   fSlope[axis] += tmp2;
+   fSlope[axis].AssignScaledValue(fE[axis], erra[axis]);
+   fTmp2.AssignScaledValue(fC[axis], covab[axis]);
+   fSlope[axis] += fTmp2;
 
    // calculate the intercept  b = C*errb + E*covab
-   fIntercept[axis].AssignScaledValue(C[axis], errb[axis]);
-   tmp2.AssignScaledValue(E[axis], covab[axis]);
-   fIntercept[axis] += tmp2;
+   fIntercept[axis].AssignScaledValue(fC[axis], errb[axis]);
+   fTmp2.AssignScaledValue(fE[axis], covab[axis]);
+   fIntercept[axis] += fTmp2;
 
    if(ldebug)    std::cout<<" Least Squares Fit Parameters for "<< axis
 			  <<" are: \n slope = "<< fSlope[axis].GetValue()
@@ -666,7 +674,7 @@ template<typename T>
 
 
    // absolute positions at target  using X = Za + b
-   tmp1.ClearEventData();
+   fTmp1.ClearEventData();
    // Absolute position of the combined bpm is not a physical position but a derived one.
 
 
@@ -674,42 +682,42 @@ template<typename T>
    //UInt_t err_flag=fAbsPos[axis].GetEventcutErrorFlag();    
    fAbsPos[axis] = fIntercept[axis]; // X =  b
    //fAbsPos[axis].ResetErrorFlag(err_flag);
-   tmp1.AssignScaledValue(fSlope[axis],zpos); //az
-   fAbsPos[axis] += tmp1;  //X = az+b
+   fTmp1.AssignScaledValue(fSlope[axis],zpos); //az
+   fAbsPos[axis] += fTmp1;  //X = az+b
 
 
    // to perform the minimul chi-square test
    // We want to calculte (X-az-b)^2 for each bpm in the combination and sum over the values
-   tmp3.ClearEventData();
+   fTmp3.ClearEventData();
    fMinimumChiSquare[axis].ClearEventData();
 
    for(size_t i=0;i<fElement.size();i++){
-     tmp1.ClearEventData();
-     tmp2.ClearEventData();
+     fTmp1.ClearEventData();
+     fTmp2.ClearEventData();
      //std::cout<<"\nName -------- ="<<(fElement[i]->GetElementName())<<std::endl;
      //std::cout<<"\nRead value ="<<(fElement[i]->GetPosition(axis))->GetValue()<<std::endl;
 
-     tmp1.AssignValueFrom(fElement[i]->GetPosition(axis)); // = X
-     //std::cout<<"Read value ="<<tmp1.GetValue()<<std::endl;
-
-     tmp2.AssignScaledValue(fSlope[axis],fElement[i]->GetPositionInZ());
-     tmp2+=fIntercept[axis];
-     //std::cout<<"Calculated abs value ="<<tmp2.GetValue()<<std::endl;
-
-     tmp1 -= tmp2;      // = X-Za-b
-     //std::cout<<"Read-calculated ="<<tmp1.GetValue()<<std::endl;
-     tmp1.Product(tmp1,tmp1); // = (X-Za-b)^2
-     //std::cout<<"(Read-calculated)^2 ="<<tmp1.GetValue()<<std::endl;
-     tmp1.Scale(fWeights[i]*fWeights[i]); // = [(X-Za-b)^2]W
-     //std::cout<<"(Read-calculated)^2/weight ="<<tmp1.GetValue()<<std::endl;
-     tmp3+=tmp1; //sum over
-     //std::cout<<"Sum (Read-calculated)^2/weight +="<<tmp3.GetValue()<<std::endl;
+     fTmp1.AssignValueFrom(fElement[i]->GetPosition(axis)); // = X
+     //std::cout<<"Read value ="<<fTmp1.GetValue()<<std::endl;
+
+     fTmp2.AssignScaledValue(fSlope[axis],fElement[i]->GetPositionInZ());
+     fTmp2+=fIntercept[axis];
+     //std::cout<<"Calculated abs value ="<<fTmp2.GetValue()<<std::endl;
+
+     fTmp1 -= fTmp2;      // = X-Za-b
+     //std::cout<<"Read-calculated ="<<fTmp1.GetValue()<<std::endl;
+     fTmp1.Product(fTmp1,fTmp1); // = (X-Za-b)^2
+     //std::cout<<"(Read-calculated)^2 ="<<fTmp1.GetValue()<<std::endl;
+     fTmp1.Scale(fWeights[i]*fWeights[i]); // = [(X-Za-b)^2]W
+     //std::cout<<"(Read-calculated)^2/weight ="<<fTmp1.GetValue()<<std::endl;
+     fTmp3+=fTmp1; //sum over
+     //std::cout<<"Sum (Read-calculated)^2/weight +="<<fTmp3.GetValue()<<std::endl;
    }
 
    if (fElement.size()>2){
-     fMinimumChiSquare[axis].AssignScaledValue(tmp3,1.0/(fElement.size()-2)); //minimul chi-square
+     fMinimumChiSquare[axis].AssignScaledValue(fTmp3,1.0/(fElement.size()-2)); //minimul chi-square
    } else {
-     fMinimumChiSquare[axis].AssignScaledValue(tmp3,0.0);
+     fMinimumChiSquare[axis].AssignScaledValue(fTmp3,0.0);
    }
 
    //std::cout << "1.0/fElement.size() = " << 1.0/fElement.size() << std::endl;
@@ -804,11 +812,12 @@ void QwCombinedBPM<T>::PrintInfo() const
 }
 
 
+/// The operators on a VQwBPM cast the operand to a QwCombinedBPM<T> without a
+/// type check: QwBeamLine::Compare has checked the device types once.
 template<typename T>
 VQwBPM& QwCombinedBPM<T>::operator= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwCombinedBPM<T>*>(this))=
-    *(dynamic_cast<const QwCombinedBPM<T>*>(&value));
+  *this = static_cast<const QwCombinedBPM<T>& >(value);
   return *this;
 }
 
@@ -828,12 +837,41 @@ QwCombinedBPM<T>& QwCombinedBPM<T>::operator= (const QwCombinedBPM<T> &value)
   return *this;
 }
 
+template<typename T>
+void QwCombinedBPM<T>::PackEventData(std::vector<Double_t>& buffer) const
+{
+  VQwBPM::PackEventData(buffer);
+  if (this->GetElementName()!=""){
+    fEffectiveCharge.PackEventData(buffer);
+    for(Short_t axis=kXAxis;axis<kNumAxes;axis++){
+      fSlope[axis].PackEventData(buffer);
+      fIntercept[axis].PackEventData(buffer);
+      fAbsPos[axis].PackEventData(buffer);
+      fMinimumChiSquare[axis].PackEventData(buffer);
+    }
+  }
+}
+
+template<typename T>
+void QwCombinedBPM<T>::UnpackEventData(const Double_t*& data)
+{
+  VQwBPM::UnpackEventData(data);
+  if (this->GetElementName()!=""){
+    fEffectiveCharge.UnpackEventData(data);
+    for(Short_t axis=kXAxis;axis<kNumAxes;axis++){
+      fSlope[axis].UnpackEventData(data);
+      fIntercept[axis].UnpackEventData(data);
+      fAbsPos[axis].UnpackEventData(data);
+      fMinimumChiSquare[axis].UnpackEventData(data);
+    }
+  }
+}
+
 
 template<typename T>
 VQwBPM& QwCombinedBPM<T>::operator+= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwCombinedBPM<T>*>(this))+=
-    *(dynamic_cast<const QwCombinedBPM<T>*>(&value));
+  *this += static_cast<const QwCombinedBPM<T>& >(value);
   return *this;
 }
 
@@ -856,8 +894,7 @@ QwCombinedBPM<T>& QwCombinedBPM<T>::operator+= (const QwCombinedBPM<T> &value)
 template<typename T>
 VQwBPM& QwCombinedBPM<T>::operator-= (const VQwBPM &value)
 {
-  *(dynamic_cast<QwCombinedBPM<T>*>(this))-=
-    *(dynamic_cast<const QwCombinedBPM<T>*>(&value));
+  *this -= static_cast<const QwCombinedBPM<T>& >(value);
   return *this;
 }
 
@@ -882,8 +919,8 @@ QwCombinedBPM<T>& QwCombinedBPM<T>::operator-= (const QwCombinedBPM<T> &value)
 template<typename T>
 void QwCombinedBPM<T>::Ratio(VQwBPM &numer, VQwBPM &denom)
 {
-  Ratio(*dynamic_cast<QwCombinedBPM<T>*>(&numer),
-      *dynamic_cast<QwCombinedBPM<T>*>(&denom));
+  Ratio(static_cast<QwCombinedBPM<T>& >(numer),
+      static_cast<QwCombinedBPM<T>& >(denom));
 }
 
 template<typename T>
@@ -939,7 +976,7 @@ void QwCombinedBPM<T>::CalculateRunningAverage()
 template<typename T>
 void QwCombinedBPM<T>::AccumulateRunningSum(const VQwBPM& value)
 {
-  AccumulateRunningSum(*dynamic_cast<const QwCombinedBPM<T>* >(&value));
+  AccumulateRunningSum(static_cast<const QwCombinedBPM<T>& >(value));
 }
 
 template<typename T>
@@ -957,7 +994,7 @@ void QwCombinedBPM<T>::AccumulateRunningSum(const QwCombinedBPM<T>& value)
 template<typename T>
 void QwCombinedBPM<T>::DeaccumulateRunningSum(VQwBPM& value)
 {
-  DeaccumulateRunningSum(*dynamic_cast<QwCombinedBPM<T>* >(&value));
+  DeaccumulateRunningSum(static_cast<QwCombinedBPM<T>& >(value));
 }
 
 template<typename T>
@@ -1170,8 +1207,7 @@ void QwCombinedBPM<T>::MakeBPMComboList()
 template<typename T>
 void QwCombinedBPM<T>::RandomizeEventData(int helicity, double time)
 {
-  static Double_t zpos = 0;
-  static T tmp1("tmp1","derived");
+  Double_t zpos = 0;
   // Randomize the abs position and angle.
   for (size_t axis=kXAxis; axis<kNumAxes; axis++) 
   {
@@ -1184,8 +1220,8 @@ void QwCombinedBPM<T>::RandomizeEventData(int helicity, double time)
     //UInt_t err_flag=fAbsPos[axis].GetEventcutErrorFlag();    
     fIntercept[axis] = fAbsPos[axis]; // b =  X
     //fAbsPos[axis].ResetErrorFlag(err_flag);
-    tmp1.AssignScaledValue(fSlope[axis],zpos); //az
-    fIntercept[axis] -= tmp1;  //b = X - az
+    fTmp1.AssignScaledValue(fSlope[axis],zpos); //az
+    fIntercept[axis] -= fTmp1;  //b = X - az
     //    std::cout << axis << " " << fAbsPos[axis].GetValue() << "-" << fSlope[axis].GetValue() <<"*"<<zpos <<"=?" << fIntercept[axis].GetValue() << std::endl;
    }
  return;
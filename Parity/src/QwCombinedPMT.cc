@@ -27,6 +27,7 @@ void  QwCombinedPMT::InitializeChannel(TString name, TString datatosave)
     if (datatosave=="derived") fDataToSave=kDerived;
 
   fSumADC.InitializeChannel(name, datatosave);
+  fTmpADC.InitializeChannel("tmpADC","raw");
   SetBlindability(kTRUE);
   return;
 }
@@ -41,6 +42,7 @@ void  QwCombinedPMT::InitializeChannel(TString subsystemname, TString name, TStr
     if (datatosave=="derived") fDataToSave=kDerived;
 
   fSumADC.InitializeChannel(subsystemname, "QwCombinedPMT", name, datatosave);
+  fTmpADC.InitializeChannel("tmpADC","raw");
   SetBlindability(kTRUE);
 
   return;
@@ -83,17 +85,16 @@ void QwCombinedPMT::CalculateSumAndAverage()
   Double_t  total_weights=0.0;
 
   fSumADC.ClearEventData();
-  static QwIntegrationPMT tmpADC("tmpADC");
 
   for (size_t i=0;i<fElement.size();i++)
     {
       //std::cout<<"=========fElement["<<i<<"]=========="<<std::endl;
       //fElement[i]->Print();
-      tmpADC = *(fElement[i]);
+      fTmpADC = *(fElement[i]);
       //std::cout<<"=========tmpADC========="<<std::endl;
       //tmpADC->Print();
-      tmpADC.Scale(fWeights[i]);
-      fSumADC += tmpADC;
+      fTmpADC.Scale(fWeights[i]);
+      fSumADC += fTmpADC;
       total_weights += fWeights[i];
     }
 
@@ -192,6 +193,23 @@ void QwCombinedPMT::UpdateErrorFlag(const QwCombinedPMT *ev_error){
   }  
 };
 
+void QwCombinedPMT::MergeErrorCounters(const QwCombinedPMT *source){
+  try {
+    if(typeid(*source)==typeid(*this)) {
+      if (this->GetElementName()!="") {
+	fSumADC.MergeErrorCounters(&(source->fSumADC));
+      }
+    } else {
+      TString loc="Standard exception from QwCombinedPMT::MergeErrorCounters :"+
+        source->GetElementName()+" "+this->GetElementName()+" are not of the "
+        +"same type";
+      throw std::invalid_argument(loc.Data());
+    }
+  } catch (std::exception& e) {
+    std::cerr<< e.what()<<std::endl;
+  }
+};
+
 
 /********************************************************/
 Bool_t QwCombinedPMT::ApplySingleEventCuts(){
@@ -235,6 +253,20 @@ QwCombinedPMT& QwCombinedPMT::operator= (const QwCombinedPMT &value)
   return *this;
 }
 
+/// Only the sum is packed; the elements and weights are configuration
+/// and are only shared by operator= with an identically set up source.
+void QwCombinedPMT::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (GetElementName()!="")
+    fSumADC.PackEventData(buffer);
+}
+
+void QwCombinedPMT::UnpackEventData(const Double_t*& data)
+{
+  if (GetElementName()!="")
+    fSumADC.UnpackEventData(data);
+}
+
 QwCombinedPMT& QwCombinedPMT::operator+= (const QwCombinedPMT &value)
 {
   //std::cout<<"Calling QwCombinedPMT::operator+="<<std::endl;
@@ -114,6 +114,32 @@ void QwCorrelator::CalcCorrelations() {
 }
 
 
+/**
+ * Append the accumulators of the correlator to a buffer, so that they
+ * can be merged with those of other parts of the run
+ */
+void QwCorrelator::PackAccumulators(std::vector<Double_t>& buffer) const {
+
+  if (! fEnableCorrelation) return;
+
+  corA.packAccumulators(buffer);
+
+}
+
+
+/**
+ * Merge the accumulators written by PackAccumulators for another part of
+ * the run, before CalcCorrelations
+ */
+void QwCorrelator::MergeAccumulators(const Double_t*& data) {
+
+  if (! fEnableCorrelation) return;
+
+  corA.mergeAccumulators(data);
+
+}
+
+
 //******************************************************************************************************************************************************
 
 
@@ -445,10 +445,30 @@ Int_t QwDetectorArray::LoadChannelMap(TString mapfile)
           fMainDetID[i].Print();
     }
   ldebug=kFALSE;
+
+  // Resolve the PMTs read out in each subbank
+  BuildSubbankDecodeMap();
+
   mapstr.Close(); // Close the file (ifstream)
   return 0;
 }
 
+/**
+ * Collect, for each subbank, the integration PMTs to be decoded from it
+ * with their word offset, in channel map order.  Must be called again
+ * whenever fIntegrationPMT is rebuilt.
+ */
+void QwDetectorArray::BuildSubbankDecodeMap()
+{
+  fSubbankDecodeMap.Clear();
+  for (size_t i = 0; i < fMainDetID.size(); i++) {
+    if (fMainDetID[i].fTypeID == kQwIntegrationPMT && fMainDetID[i].fIndex >= 0)
+      fSubbankDecodeMap.AddTarget(fMainDetID[i].fSubbankIndex,
+                                  &(fIntegrationPMT[fMainDetID[i].fIndex]),
+                                  fMainDetID[i].fWordInSubbank);
+  }
+}
+
 
 Int_t QwDetectorArray::LoadEventCuts(TString filename)
 {
@@ -720,59 +740,54 @@ void  QwDetectorArray::RandomizeMollerEvent(int helicity /*, const QwBeamCharge&
   fTargetYprime.PrintInfo();
   fTargetEnergy.PrintInfo();*/
 
-  if(RequestExternalValue("x_targ", &fTargetX)){
+  if(fTargetXHandle.IsValid()){
+    fTargetX.AssignValueFrom(fTargetXHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetX)->PrintInfo();
       QwWarning << "QwDetectorArray::RandomizeMollerEvent Found "<<fTargetX.GetElementName()<< QwLog::endl;  
     }    
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetX.GetElementName() << QwLog::endl;
   }
   
-  if(RequestExternalValue("y_targ", &fTargetY)){
+  if(fTargetYHandle.IsValid()){
+    fTargetY.AssignValueFrom(fTargetYHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetY)->PrintInfo();
       QwWarning << "QwDetectorArray::RandomizeMollerEvent Found "<<fTargetY.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetY.GetElementName() << QwLog::endl;
   }
   
-  if(RequestExternalValue("xp_targ", &fTargetXprime)){
+  if(fTargetXprimeHandle.IsValid()){
+    fTargetXprime.AssignValueFrom(fTargetXprimeHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetXprime)->PrintInfo();
       QwWarning << "QwDetectorArray::RandomizeMollerEvent Found "<<fTargetXprime.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetXprime.GetElementName() << QwLog::endl;
   }
 
-  if(RequestExternalValue("yp_targ", &fTargetYprime)){
+  if(fTargetYprimeHandle.IsValid()){
+    fTargetYprime.AssignValueFrom(fTargetYprimeHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetYprime)->PrintInfo();
       QwWarning << "QwDetectorArray::RandomizeMollerEvent Found "<<fTargetYprime.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetYprime.GetElementName() << QwLog::endl;
   }
 
-  if(RequestExternalValue("e_targ", &fTargetEnergy)){
+  if(fTargetEnergyHandle.IsValid()){
+    fTargetEnergy.AssignValueFrom(fTargetEnergyHandle.Get());
     if (bDEBUG){
       dynamic_cast<QwVQWK_Channel*>(&fTargetEnergy)->PrintInfo();
       QwWarning << "QwDetectorArray::RandomizeMollerEvent Found "<<fTargetEnergy.GetElementName()<< QwLog::endl;
     }
   }else{
     bIsExchangedDataValid = kFALSE;
-    QwError << GetSubsystemName() << " could not get external value for "
-	    << fTargetEnergy.GetElementName() << QwLog::endl;
   }
     
   for (size_t i = 0; i < fMainDetID.size(); i++) 
@@ -814,23 +829,7 @@ Int_t QwDetectorArray::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank
         << " and subbank "<<bank_id
         << " number of words="<<num_words<<std::endl;
 
-      for (size_t i=0;i<fMainDetID.size();i++)
-        {
-          if (fMainDetID[i].fSubbankIndex==index)
-            {
-
-              if (fMainDetID[i].fTypeID == kQwIntegrationPMT)
-                {
-                  if (lkDEBUG)
-                    {
-                      std::cout<<"found IntegrationPMT data for "<<fMainDetID[i].fdetectorname<<std::endl;
-                      std::cout<<"word left to read in this buffer:"<<num_words-fMainDetID[i].fWordInSubbank<<std::endl;
-                    }
-                  fIntegrationPMT[fMainDetID[i].fIndex].ProcessEvBuffer(&(buffer[fMainDetID[i].fWordInSubbank]),
-                      num_words-fMainDetID[i].fWordInSubbank);
-                }
-            }
-        }
+      fSubbankDecodeMap.ProcessEvBuffer(index, buffer, num_words);
     }
 
   return 0;
@@ -912,6 +911,19 @@ void QwDetectorArray::UpdateErrorFlag(const VQwSubsystem *ev_error){
   }
 };
 
+void QwDetectorArray::MergeErrorCounters(const VQwSubsystem *source){
+  VQwSubsystem* tmp = const_cast<VQwSubsystem*>(source);
+  if(Compare(tmp)){
+    const QwDetectorArray* input = dynamic_cast<const QwDetectorArray*> (source);
+
+    for (size_t i=0;i<input->fIntegrationPMT.size();i++)
+      this->fIntegrationPMT[i].MergeErrorCounters(&(input->fIntegrationPMT[i]));
+
+    for (size_t i=0;i<input->fCombinedPMT.size();i++)
+      this->fCombinedPMT[i].MergeErrorCounters(&(input->fCombinedPMT[i]));
+  }
+};
+
 
 void  QwDetectorArray::ProcessEvent()
 {
@@ -928,6 +940,20 @@ void  QwDetectorArray::ProcessEvent()
   return;
 }
 
+/**
+ * Look up the published beam parameters, once all subsystems in the
+ * parent array have published their values
+ */
+void  QwDetectorArray::ResolveExternalValues()
+{
+  fTargetChargeHandle.Resolve(*this, "q_targ");
+  fTargetXHandle.Resolve(*this, "x_targ");
+  fTargetYHandle.Resolve(*this, "y_targ");
+  fTargetXprimeHandle.Resolve(*this, "xp_targ");
+  fTargetYprimeHandle.Resolve(*this, "yp_targ");
+  fTargetEnergyHandle.Resolve(*this, "e_targ");
+}
+
 /**
  * Exchange data between subsystems
  */
@@ -937,7 +963,8 @@ void  QwDetectorArray::ExchangeProcessedData()
   bIsExchangedDataValid = kTRUE;
   if (1==1 || bNormalization){
 
-    if(RequestExternalValue("q_targ", &fTargetCharge)){
+    if(fTargetChargeHandle.IsValid()){
+      fTargetCharge.AssignValueFrom(fTargetChargeHandle.Get());
       if (bDEBUG){
 	QwWarning << "QwDetectorArray::ExchangeProcessedData Found "<<fTargetCharge.GetElementName()<< QwLog::endl;
 	//QwWarning <<"****QwDetectorArray****"<< QwLog::endl;
@@ -946,8 +973,6 @@ void  QwDetectorArray::ExchangeProcessedData()
     }
     else{
       bIsExchangedDataValid = kFALSE;
-      QwError << GetSubsystemName() << " could not get external value for "
-	      << fTargetCharge.GetElementName() << QwLog::endl;
     }
     
   }
@@ -1110,6 +1135,28 @@ VQwSubsystem&  QwDetectorArray::operator=  (VQwSubsystem *value)
 }
 
 
+Bool_t QwDetectorArray::PackEventData(std::vector<Double_t>& buffer) const
+{
+  for (size_t i=0;i<fIntegrationPMT.size();i++)
+    fIntegrationPMT[i].PackEventData(buffer);
+
+  for (size_t i=0;i<fCombinedPMT.size();i++)
+    fCombinedPMT[i].PackEventData(buffer);
+
+  return kTRUE;
+}
+
+
+void QwDetectorArray::UnpackEventData(const Double_t*& data)
+{
+  for (size_t i=0;i<fIntegrationPMT.size();i++)
+    fIntegrationPMT[i].UnpackEventData(data);
+
+  for (size_t i=0;i<fCombinedPMT.size();i++)
+    fCombinedPMT[i].UnpackEventData(data);
+}
+
+
 VQwSubsystem&  QwDetectorArray::operator+=  (VQwSubsystem *value)
 {
   if (Compare(value))
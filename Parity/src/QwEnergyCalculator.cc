@@ -24,6 +24,7 @@ void QwEnergyCalculator::InitializeChannel(TString name,TString datatosave )
 {
   SetElementName(name);
   fEnergyChange.InitializeChannel(name,datatosave);
+  fTmp.InitializeChannel("tmp","derived");
   //  beamx.InitializeChannel("beamx","derived");
   return;
 }
@@ -32,6 +33,7 @@ void QwEnergyCalculator::InitializeChannel(TString subsystem, TString name,TStri
 {
   SetElementName(name);
   fEnergyChange.InitializeChannel(subsystem, "QwEnergyCalculator", name,datatosave);
+  fTmp.InitializeChannel("tmp","derived");
   //  beamx.InitializeChannel("beamx","derived");
   return;
 }
@@ -70,20 +72,18 @@ void QwEnergyCalculator::ProcessEvent()
 {
   //Bool_t ldebug = kFALSE;
   //Double_t targetbeamangle = 0.0;
-  static QwVQWK_Channel tmp;
-  tmp.InitializeChannel("tmp","derived");
-  tmp.ClearEventData();
+  fTmp.ClearEventData();
 
   this->ClearEventData();
 
   for(UInt_t i = 0; i<fProperty.size(); i++){
     if(fProperty[i].Contains("targetbeamangle")){
-      tmp.ArcTan((((QwCombinedBPM<QwVQWK_Channel>*)fDevice[i])->fSlope[VQwBPM::kXAxis]));
+      fTmp.ArcTan((((QwCombinedBPM<QwVQWK_Channel>*)fDevice[i])->fSlope[VQwBPM::kXAxis]));
      } else {
-      tmp.AssignValueFrom(fDevice[i]->GetPosition(VQwBPM::kXAxis));
+      fTmp.AssignValueFrom(fDevice[i]->GetPosition(VQwBPM::kXAxis));
      }
-    tmp.Scale(fTMatrixRatio[i]);
-    fEnergyChange += tmp;
+    fTmp.Scale(fTMatrixRatio[i]);
+    fEnergyChange += fTmp;
    }
 /*
     if(fProperty[i].Contains("targetbeamangle")){
@@ -136,9 +136,7 @@ void QwEnergyCalculator::GetProjectedPosition(VQwBPM *device)
 
   if (idevice>fProperty.size()) return;  // Return without trying to find a new position if "device" doesn't contribute to the energy calculator
 
-  static QwVQWK_Channel tmp;
-  tmp.InitializeChannel("tmp","derived");
-  tmp.ClearEventData();
+  fTmp.ClearEventData();
   //  Set the device position value to be equal to the energy change 
   (device->GetPosition(VQwBPM::kXAxis))->AssignValueFrom(&fEnergyChange);
   /** qwk_1c12X changes only **/
@@ -151,13 +149,13 @@ void QwEnergyCalculator::GetProjectedPosition(VQwBPM *device)
    } else {
       //  Calculate contribution to fEnergyChange from the other devices
       if(fProperty[i].Contains("targetbeamangle")) {
-       tmp.ArcTan((((QwCombinedBPM<QwVQWK_Channel>*)fDevice[i])->fSlope[VQwBPM::kXAxis]));
+       fTmp.ArcTan((((QwCombinedBPM<QwVQWK_Channel>*)fDevice[i])->fSlope[VQwBPM::kXAxis]));
       } else {
-       tmp.AssignValueFrom(fDevice[i]->GetPosition(VQwBPM::kXAxis));
+       fTmp.AssignValueFrom(fDevice[i]->GetPosition(VQwBPM::kXAxis));
       }
-     tmp.Scale(fTMatrixRatio[i]);
+     fTmp.Scale(fTMatrixRatio[i]);
      //  And subtract it from the device we are trying to get the position of.
-     (device->GetPosition(VQwBPM::kXAxis))->operator-=(&tmp);
+     (device->GetPosition(VQwBPM::kXAxis))->operator-=(&fTmp);
    }
   } // end of for(UInt_t i = 0; i<fProperty.size(); i++)
 
@@ -270,6 +268,10 @@ void QwEnergyCalculator::UpdateErrorFlag(const QwEnergyCalculator *ev_error){
   fEnergyChange.UpdateErrorFlag(ev_error->fEnergyChange);
 };
 
+void QwEnergyCalculator::MergeErrorCounters(const QwEnergyCalculator *source){
+  fEnergyChange.MergeErrorCounters(source->fEnergyChange);
+};
+
 
 void QwEnergyCalculator::CalculateRunningAverage(){
   fEnergyChange.CalculateRunningAverage();
@@ -299,6 +301,18 @@ QwEnergyCalculator& QwEnergyCalculator::operator= (const QwEnergyCalculator &val
   return *this;
 }
 
+void QwEnergyCalculator::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (GetElementName()!="")
+    fEnergyChange.PackEventData(buffer);
+}
+
+void QwEnergyCalculator::UnpackEventData(const Double_t*& data)
+{
+  if (GetElementName()!="")
+    fEnergyChange.UnpackEventData(data);
+}
+
 QwEnergyCalculator& QwEnergyCalculator::operator+= (const QwEnergyCalculator &value){
 
   if (GetElementName()!="")
@@ -0,0 +1,139 @@
+/**********************************************************\
+* File: QwEventPipeline.cc                                 *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#include "QwEventPipeline.h"
+
+// ROOT headers
+#include "TROOT.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptions.h"
+
+QwEventPipeline::QwEventPipeline(QwOptions &options, QwSubsystemArrayParity &event)
+: fNumberOfThreads(1),
+  fDepth(16),
+  fHead(0),
+  fTail(0),
+  fFilled(0),
+  fStop(kFALSE)
+{
+  ProcessOptions(options);
+  //  The queue is only needed when the analysis stage has its own thread
+  if (IsEnabled())
+    fSlots.resize(fDepth, event);
+}
+
+void QwEventPipeline::DefineOptions(QwOptions &options)
+{
+  // Define the execution options
+  options.AddOptions()("threads",
+      po::value<int>()->default_value(1),
+      "number of threads in the event loop (1 runs serially, 2 runs the analysis stage on its own thread)");
+  options.AddOptions()("pipeline.depth",
+      po::value<int>()->default_value(16),
+      "QwEventPipeline: number of events queued for the analysis stage");
+}
+
+void QwEventPipeline::ProcessOptions(QwOptions &options)
+{
+  fNumberOfThreads = options.GetValue<int>("threads");
+  fDepth = options.GetValue<int>("pipeline.depth");
+  if (fNumberOfThreads < 1) fNumberOfThreads = 1;
+  if (fDepth < 1) fDepth = 1;
+
+  if (fNumberOfThreads > 2) {
+    QwWarning << "QwEventPipeline: the event loop has two stages, "
+              << "using 2 of " << fNumberOfThreads << " threads; "
+              << "use --prefetch-events to read ahead on another thread."
+              << QwLog::endl;
+    fNumberOfThreads = 2;
+  }
+}
+
+void QwEventPipeline::Start(const Stage_t& analyze)
+{
+  Stop();
+  fAnalyze = analyze;
+  if (! IsEnabled()) return;
+  //  Histograms and trees are filled on the analysis stage thread
+  ROOT::EnableThreadSafety();
+  fHead   = 0;
+  fTail   = 0;
+  fFilled = 0;
+  fStop   = kFALSE;
+  fThread = std::thread(&QwEventPipeline::Loop, this);
+  QwMessage << "Analyzing events on a separate thread, with up to "
+            << fDepth << " events queued" << QwLog::endl;
+}
+
+void QwEventPipeline::Push(QwSubsystemArrayParity &event)
+{
+  //  Without a thread, analyze the event right away
+  if (! fThread.joinable()) {
+    fAnalyze(event);
+    return;
+  }
+  size_t slot;
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fNotFull.wait(lock, [this]{ return fFilled < fSlots.size(); });
+    slot = fHead;
+  }
+  //  Copy outside of the lock; the analysis stage does not use this slot
+  fSlots[slot] = event;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fHead = (fHead + 1) % fSlots.size();
+    fFilled++;
+  }
+  fNotEmpty.notify_one();
+}
+
+void QwEventPipeline::Drain()
+{
+  if (! fThread.joinable()) return;
+  std::unique_lock<std::mutex> lock(fMutex);
+  fEmpty.wait(lock, [this]{ return fFilled == 0; });
+}
+
+void QwEventPipeline::Stop()
+{
+  if (fThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = kTRUE;
+    }
+    fNotEmpty.notify_all();
+    fThread.join();
+  }
+}
+
+void QwEventPipeline::Loop()
+{
+  while (true) {
+    //  Wait for the next event; after Stop() the queue is emptied first
+    size_t slot;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fNotEmpty.wait(lock, [this]{ return fFilled > 0 || fStop; });
+      if (fFilled == 0) return;
+      slot = fTail;
+    }
+    //  The slot stays counted as filled until it has been analyzed
+    fAnalyze(fSlots[slot]);
+    Bool_t empty;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fTail = (fTail + 1) % fSlots.size();
+      fFilled--;
+      empty = (fFilled == 0);
+    }
+    fNotFull.notify_one();
+    if (empty) fEmpty.notify_all();
+  }
+}
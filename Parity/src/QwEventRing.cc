@@ -1,21 +1,20 @@
 #include "QwEventRing.h"
 
+// ROOT headers
+#include "TSystem.h"
+
+// Qweak headers
+#include "QwProfiler.h"
+
 
 
 QwEventRing::QwEventRing(QwSubsystemArrayParity &event, Int_t ring_size)
 : fRollingAvg(event)
 {
   fRING_SIZE=ring_size;
-  fEvent_Ring.resize(fRING_SIZE,event);
+  bCompact=kTRUE;
 
-  bRING_READY=kFALSE;
-  bEVENT_READY=kTRUE;
-  fNextToBeFilled=0;
-  fNextToBeRead=0;
-  
-  //open the log file
-  if (bDEBUG_Write)
-    out_file = fopen("Ring_log.txt", "wt");
+  InitializeRing(event);
 }
 
 
@@ -24,12 +23,71 @@ QwEventRing::QwEventRing(QwOptions &options, QwSubsystemArrayParity &event)
 {
   ProcessOptions(options);
 
-  fEvent_Ring.resize(fRING_SIZE,event);
+  InitializeRing(event);
+}
+
+
+void QwEventRing::InitializeRing(QwSubsystemArrayParity &event)
+{
+  ProcInfo_t before, after;
+  gSystem->GetProcInfo(&before);
+  if (bCompact){
+    //  Subsystems which cannot be packed are stored as copies
+    std::vector<Double_t> buffer;
+    for (size_t i=0;i<event.size();i++){
+      VQwSubsystemParity* subsys =
+        dynamic_cast<VQwSubsystemParity*>(event.at(i).get());
+      if (subsys!=NULL && !subsys->PackEventData(buffer))
+        fUnpackedSubsystems.push_back(i);
+    }
+    //  Only the event returned by pop() is kept in full
+    fEvent_Ring.resize(1,event);
+    gSystem->GetProcInfo(&after);
+    Long_t full_size = after.fMemResident-before.fMemResident;
+
+    fScratch.reset(new QwSubsystemArrayParity(event));
+    gSystem->GetProcInfo(&before);
+    fPacked_Ring.resize(fRING_SIZE);
+    for (Int_t i=0;i<fRING_SIZE;i++){
+      for (size_t j=0;j<fUnpackedSubsystems.size();j++)
+        fPacked_Ring[i].fSubsystems.push_back(boost::shared_ptr<VQwSubsystem>(event.at(fUnpackedSubsystems[j])->Clone()));
+      PackEvent(event,i);
+    }
+    gSystem->GetProcInfo(&after);
+    Long_t packed_size = after.fMemResident-before.fMemResident;
+
+    QwMessage << "QwEventRing: " << fRING_SIZE << " events in compact storage, "
+              << fPacked_Ring[0].fData.size() << " values per event";
+    if (fUnpackedSubsystems.size()>0){
+      QwMessage << " and copies of";
+      for (size_t j=0;j<fUnpackedSubsystems.size();j++)
+        QwMessage << " " << event.at(fUnpackedSubsystems[j])->GetSubsystemName();
+    }
+    QwMessage << QwLog::endl;
+    QwMessage << "QwEventRing: memory used " << packed_size/1024 << " MB, about "
+              << full_size*fRING_SIZE/1024 << " MB with full copies ("
+              << full_size << " kB per event)" << QwLog::endl;
+  } else {
+    fEvent_Ring.resize(fRING_SIZE,event);
+    gSystem->GetProcInfo(&after);
+    QwMessage << "QwEventRing: " << fRING_SIZE << " events as full copies, memory used "
+              << (after.fMemResident-before.fMemResident)/1024 << " MB" << QwLog::endl;
+  }
+
+  InitializeFlags(event);
 
   bRING_READY=kFALSE;
   bEVENT_READY=kTRUE;
   fNextToBeFilled=0;
   fNextToBeRead=0;
+  fLastRead=-1;
+
+  fOldMarksStart=0;
+  fNewMarksStart=0;
+  fMarkCount=0;
+  fNewMarksCombined.fStability=kFALSE;
+  fNewMarksCombined.fBeamTrip=kFALSE;
+  fSlotMark.assign(fRING_SIZE,0);
 
   //open the log file
   if (bDEBUG_Write)
@@ -47,6 +105,9 @@ void QwEventRing::DefineOptions(QwOptions &options)
   options.AddOptions()("ring.stability_cut",
       po::value<double>()->default_value(1),
       "QwEventRing: Stability ON/OFF");
+  options.AddOptions()("ring.full_copy",
+      po::value<bool>()->default_bool_value(false),
+      "QwEventRing: keep full copies of the events instead of compact storage");
 }
 
 void QwEventRing::ProcessOptions(QwOptions &options)
@@ -63,10 +124,15 @@ void QwEventRing::ProcessOptions(QwOptions &options)
     bStability=kTRUE;
   else
     bStability=kFALSE;
+
+  bCompact=kTRUE;
+  if (gQwOptions.HasValue("ring.full_copy"))
+    bCompact=!gQwOptions.GetValue<bool>("ring.full_copy");
  
 }
 void QwEventRing::push(QwSubsystemArrayParity &event)
 {
+  QwProfiler::Scope profile(QwProfiler::kRing);
   if (bDEBUG) QwMessage << "QwEventRing::push:  BEGIN" <<QwLog::endl;
 
   
@@ -74,7 +140,12 @@ void QwEventRing::push(QwSubsystemArrayParity &event)
   if (bEVENT_READY){
     Int_t thisevent = fNextToBeFilled;
     Int_t prevevent = (thisevent+fRING_SIZE-1)%fRING_SIZE;
-    fEvent_Ring[thisevent]=event;//copy the current good event to the ring 
+    if (bCompact)
+      PackEvent(event,thisevent);
+    else
+      fEvent_Ring[thisevent]=event;//copy the current good event to the ring 
+    gQwProfiler.AddRingCopy(bCompact ? fPacked_Ring[thisevent].fData.size()*sizeof(Double_t) : 0);
+    fSlotMark[thisevent]=fMarkCount;//no earlier marks apply to this event
     if (bStability){
       fRollingAvg.AccumulateAllRunningSum(event);
     }
@@ -108,16 +179,24 @@ void QwEventRing::push(QwSubsystemArrayParity &event)
 	  //  This test really needs to determine in any of the subelements
 	  //  might have a local stability cut failure, instead of just this
 	  //  global stability cut failure.
-	  for(Int_t i=0;i<fRING_SIZE;i++){
-	    fEvent_Ring[i].UpdateErrorFlag(fRollingAvg);
-	    fEvent_Ring[i].UpdateErrorFlag();
-	  }
+	  FlagMark_t mark;
+	  mark.fStability=kTRUE;
+	  mark.fBeamTrip=kFALSE;
+	  mark.fFlags=AcquireFlags();
+	  StoreFlags(*(mark.fFlags),fRollingAvg);
+	  AddMark(mark);
 	}
-	if ((fEvent_Ring[thisevent].GetEventcutErrorFlag() & kBCMErrorFlag)!=0 &&
-	    (fEvent_Ring[prevevent].GetEventcutErrorFlag() & kBCMErrorFlag)!=0){
-	  for(Int_t i=0;i<fRING_SIZE;i++){
-	    fEvent_Ring[i].UpdateErrorFlag(kBeamTripError);
-	  }
+	//  The beam trip check needs the flags of this and the previous event
+	ApplyNewMarks(thisevent);
+	ApplyNewMarks(prevevent);
+	if ((GetEventcutErrorFlag(thisevent) & kBCMErrorFlag)!=0 &&
+	    (GetEventcutErrorFlag(prevevent) & kBCMErrorFlag)!=0){
+	  FlagMark_t mark;
+	  mark.fStability=kFALSE;
+	  mark.fBeamTrip=kTRUE;
+	  AddMark(mark);
+	  ApplyNewMarks(thisevent);
+	  ApplyNewMarks(prevevent);
 	}
     }
     //ring processing is done at a separate location
@@ -129,6 +208,7 @@ void QwEventRing::push(QwSubsystemArrayParity &event)
 
 
 QwSubsystemArrayParity& QwEventRing::pop(){
+  QwProfiler::Scope profile(QwProfiler::kRing);
   Int_t tempIndex;
   tempIndex=fNextToBeRead;  
   if (bDEBUG) QwMessage<<" Read at "<<fNextToBeRead<<QwLog::endl; 
@@ -137,11 +217,16 @@ QwSubsystemArrayParity& QwEventRing::pop(){
   if (fNextToBeRead==(fRING_SIZE-1)){
     bRING_READY=kFALSE;//setting to false is an extra measure of security to prevent reading a NULL value. 
   }
+  QwSubsystemArrayParity& event = bCompact ? fEvent_Ring[0] : fEvent_Ring[tempIndex];
+  if (bCompact) UnpackEvent(tempIndex,event);
+  ApplyPendingMarks(tempIndex,event);
   if (bStability){
-     fRollingAvg.DeaccumulateRunningSum(fEvent_Ring[tempIndex]);
+     fRollingAvg.DeaccumulateRunningSum(event);
   }
   fNextToBeRead=(fNextToBeRead+1)%fRING_SIZE;  
-  return fEvent_Ring[tempIndex];  
+  ExpireMarks(fSlotMark[fNextToBeRead]);
+  fLastRead=bCompact ? 0 : tempIndex;
+  return event;
 }
 
 
@@ -149,3 +234,278 @@ Bool_t QwEventRing::IsReady(){ //Check for readyness to read data from the ring
   return bRING_READY;
 }
 
+
+void QwEventRing::ShareHistograms(const QwSubsystemArrayParity& source)
+{
+  //  In compact storage only the event returned by pop() is kept in full
+  for(size_t i=0;i<fEvent_Ring.size();i++){
+    fEvent_Ring[i].ShareHistograms(source);
+  }
+}
+
+
+void QwEventRing::CollectErrorCounters(QwSubsystemArrayParity& output) const
+{
+  //  The output was not updated while events were read in place,
+  //  so bring it to the state of the last event read
+  if (fLastRead>=0){
+    output = fEvent_Ring[fLastRead];
+  }
+  //  In compact storage the counters are all in the event returned by
+  //  pop(), since every event is unpacked into it before its cuts are applied
+  for(size_t i=0;i<fEvent_Ring.size();i++){
+    output.MergeErrorCounters(fEvent_Ring[i]);
+  }
+}
+
+
+void QwEventRing::PackEvent(const QwSubsystemArrayParity& event, Int_t slot)
+{
+  PackedEvent_t& packed = fPacked_Ring[slot];
+  packed.fErrorFlag = event.GetEventcutErrorFlag();
+  packed.fData.clear();
+  event.PackEventData(packed.fData);
+  for (size_t j=0;j<fUnpackedSubsystems.size();j++){
+    VQwSubsystemParity* copy =
+      dynamic_cast<VQwSubsystemParity*>(packed.fSubsystems[j].get());
+    *copy = event.at(fUnpackedSubsystems[j]).get();
+  }
+}
+
+
+void QwEventRing::UnpackEvent(Int_t slot, QwSubsystemArrayParity& event)
+{
+  const PackedEvent_t& packed = fPacked_Ring[slot];
+  const Double_t* data = &(packed.fData[0]);
+  event.UnpackEventData(data);
+  for (size_t j=0;j<fUnpackedSubsystems.size();j++){
+    VQwSubsystemParity* subsys =
+      dynamic_cast<VQwSubsystemParity*>(event.at(fUnpackedSubsystems[j]).get());
+    *subsys = packed.fSubsystems[j].get();
+  }
+}
+
+
+UInt_t QwEventRing::GetEventcutErrorFlag(Int_t slot) const
+{
+  if (bCompact)
+    return fPacked_Ring[slot].fErrorFlag;
+  else
+    return fEvent_Ring[slot].GetEventcutErrorFlag();
+}
+
+
+void QwEventRing::ApplyMark(QwSubsystemArrayParity& event, const FlagMark_t& mark)
+{
+  //  Same updates as were applied to all slots on push
+  if (mark.fStability){
+    ApplyFlags(event,*(mark.fFlags));
+    event.UpdateErrorFlag();
+  }
+  if (mark.fBeamTrip){
+    event.UpdateErrorFlag(kBeamTripError);
+  }
+}
+
+
+void QwEventRing::ApplyNewMarks(Int_t slot)
+{
+  //  Only used for the newest events, which have at most the marks of
+  //  the current push pending
+  if (fSlotMark[slot]>=fMarkCount) return;
+  QwSubsystemArrayParity& event = bCompact ? *fScratch : fEvent_Ring[slot];
+  if (bCompact) UnpackEvent(slot,event);
+  for (Long64_t i=fSlotMark[slot]; i<fMarkCount; i++){
+    ApplyMark(event, fNewMarks[i-fNewMarksStart]);
+  }
+  if (bCompact) PackEvent(event,slot);
+  fSlotMark[slot]=fMarkCount;
+}
+
+
+void QwEventRing::ApplyPendingMarks(Int_t slot, QwSubsystemArrayParity& event)
+{
+  Long64_t first = fSlotMark[slot];
+  if (first<fMarkCount){
+    //  The combined old marks start at the first mark of the slot
+    if (first>=fNewMarksStart) FlipMarks();
+    ApplyMark(event, fOldMarks[first-fOldMarksStart]);
+    ApplyMark(event, fNewMarksCombined);
+  }
+  fSlotMark[slot]=fMarkCount;
+}
+
+
+void QwEventRing::AddMark(const FlagMark_t& mark)
+{
+  fNewMarks.push_back(mark);
+  CombineMarks(fNewMarksCombined, mark);
+  fMarkCount++;
+}
+
+
+void QwEventRing::CombineMarks(FlagMark_t& earlier, const FlagMark_t& later)
+{
+  //  A stability update recomputes the error flags of the event and
+  //  so clears an earlier beam trip flag
+  if (later.fStability){
+    if (earlier.fFlags){
+      CombineFlags(*(earlier.fFlags),*(later.fFlags));
+    } else {
+      earlier.fFlags=AcquireFlags();
+      earlier.fFlags->fWords=later.fFlags->fWords;
+      for (size_t j=0;j<fFlagSubsystems.size();j++){
+        VQwSubsystemParity* copy =
+          dynamic_cast<VQwSubsystemParity*>(earlier.fFlags->fSubsystems[j].get());
+        *copy = later.fFlags->fSubsystems[j].get();
+      }
+    }
+    earlier.fStability=kTRUE;
+    earlier.fBeamTrip=later.fBeamTrip;
+  } else {
+    earlier.fBeamTrip=(earlier.fBeamTrip || later.fBeamTrip);
+  }
+}
+
+
+void QwEventRing::FlipMarks()
+{
+  //  No slot needs the old marks anymore
+  ExpireMarks(fNewMarksStart);
+  fOldMarks.resize(fNewMarks.size());
+  for (Int_t i=fNewMarks.size()-1; i>=0; i--){
+    fOldMarks[i]=fNewMarks[i];
+    if (i<(Int_t)fNewMarks.size()-1)
+      CombineMarks(fOldMarks[i], fOldMarks[i+1]);
+  }
+  fNewMarks.clear();
+  ReleaseFlags(fNewMarksCombined);
+  fNewMarksCombined.fStability=kFALSE;
+  fNewMarksCombined.fBeamTrip=kFALSE;
+  fOldMarksStart=fNewMarksStart;
+  fNewMarksStart=fMarkCount;
+}
+
+
+void QwEventRing::ExpireMarks(Long64_t first)
+{
+  while (!fOldMarks.empty() && fOldMarksStart<first){
+    ReleaseFlags(fOldMarks.front());
+    fOldMarks.pop_front();
+    fOldMarksStart++;
+  }
+}
+
+
+boost::shared_ptr<QwEventRing::ErrorFlags_t> QwEventRing::AcquireFlags()
+{
+  boost::shared_ptr<ErrorFlags_t> flags;
+  if (fFreeFlags.empty()){
+    flags.reset(new ErrorFlags_t);
+    flags->fWords.resize(fFlagSlots.size());
+    for (size_t j=0;j<fFlagSubsystems.size();j++)
+      flags->fSubsystems.push_back(boost::shared_ptr<VQwSubsystem>(fRollingAvg.at(fFlagSubsystems[j])->Clone()));
+  } else {
+    flags=fFreeFlags.back();
+    fFreeFlags.pop_back();
+  }
+  return flags;
+}
+
+
+void QwEventRing::ReleaseFlags(FlagMark_t& mark)
+{
+  if (mark.fFlags) fFreeFlags.push_back(mark.fFlags);
+  mark.fFlags.reset();
+}
+
+
+/**
+ * Find the values of the packed events which UpdateErrorFlag ORs with the
+ * error flags of another event, by applying it to test values.  Only these
+ * values, and copies of the subsystems which are not packed, are stored in
+ * a mark.  If UpdateErrorFlag does anything else to the packed values, all
+ * subsystems are copied.
+ */
+void QwEventRing::InitializeFlags(const QwSubsystemArrayParity& event)
+{
+  fFlagSlots.clear();
+  fFlagSubsystems.clear();
+
+  std::vector<Double_t> buffer;
+  event.PackEventData(buffer);
+  size_t size = buffer.size();
+  QwSubsystemArrayParity target(event), source(event);
+  std::vector<Double_t> x(size,3.0), y(size,5.0);
+  const Double_t* data = &x[0];
+  target.UnpackEventData(data);
+  data = &y[0];
+  source.UnpackEventData(data);
+  target.UpdateErrorFlag(source);
+  buffer.clear();
+  target.PackEventData(buffer);
+
+  Bool_t packed = kTRUE;
+  for (size_t k=0;k<size;k++){
+    if (buffer[k]==7.0) fFlagSlots.push_back(k);
+    else if (buffer[k]!=3.0) packed = kFALSE;
+  }
+  if (! packed) fFlagSlots.clear();
+
+  for (size_t i=0;i<event.size();i++){
+    const VQwSubsystemParity* subsys =
+      dynamic_cast<const VQwSubsystemParity*>(event.at(i).get());
+    buffer.clear();
+    if (subsys!=NULL && (! packed || ! subsys->PackEventData(buffer)))
+      fFlagSubsystems.push_back(i);
+  }
+}
+
+
+void QwEventRing::StoreFlags(ErrorFlags_t& flags, const QwSubsystemArrayParity& event)
+{
+  if (! fFlagSlots.empty()){
+    fFlagBuffer.clear();
+    event.PackEventData(fFlagBuffer);
+    for (size_t j=0;j<fFlagSlots.size();j++)
+      flags.fWords[j] = UInt_t(fFlagBuffer[fFlagSlots[j]]);
+  }
+  for (size_t j=0;j<fFlagSubsystems.size();j++){
+    VQwSubsystemParity* copy =
+      dynamic_cast<VQwSubsystemParity*>(flags.fSubsystems[j].get());
+    *copy = event.at(fFlagSubsystems[j]).get();
+  }
+}
+
+
+void QwEventRing::CombineFlags(ErrorFlags_t& earlier, const ErrorFlags_t& later)
+{
+  for (size_t j=0;j<earlier.fWords.size();j++)
+    earlier.fWords[j] |= later.fWords[j];
+  for (size_t j=0;j<fFlagSubsystems.size();j++){
+    VQwSubsystemParity* subsys =
+      dynamic_cast<VQwSubsystemParity*>(earlier.fSubsystems[j].get());
+    subsys->UpdateErrorFlag(later.fSubsystems[j].get());
+  }
+}
+
+
+void QwEventRing::ApplyFlags(QwSubsystemArrayParity& event, const ErrorFlags_t& flags)
+{
+  //  Same as event.UpdateErrorFlag(rolling average)
+  if (! fFlagSlots.empty()){
+    fFlagBuffer.clear();
+    event.PackEventData(fFlagBuffer);
+    for (size_t j=0;j<fFlagSlots.size();j++){
+      Double_t& value = fFlagBuffer[fFlagSlots[j]];
+      value = UInt_t(value) | flags.fWords[j];
+    }
+    const Double_t* data = &fFlagBuffer[0];
+    event.UnpackEventData(data);
+  }
+  for (size_t j=0;j<fFlagSubsystems.size();j++){
+    VQwSubsystemParity* subsys =
+      dynamic_cast<VQwSubsystemParity*>(event.at(fFlagSubsystems[j]).get());
+    subsys->UpdateErrorFlag(flags.fSubsystems[j].get());
+  }
+}
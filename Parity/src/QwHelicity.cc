@@ -121,6 +121,10 @@ QwHelicity::QwHelicity(const QwHelicity& source)
 
   fInputReg_FakeMPS = source.fInputReg_FakeMPS;
 
+  // Keep the histogram and tree layout of the source
+  fHistoType = source.fHistoType;
+  fTreeArrayIndex = source.fTreeArrayIndex;
+
   this->fWord.resize(source.fWord.size());
   for(size_t i=0;i<this->fWord.size();i++)
     {
@@ -16,6 +16,8 @@
 #include "QwHelicity.h"
 #include "QwBlinder.h"
 #include "VQwDataElement.h"
+#include "QwProfiler.h"
+#include "QwPackedPattern.h"
 
 
 /*****************************************************************/
@@ -37,6 +39,9 @@ void QwHelicityPattern::DefineOptions(QwOptions &options)
   options.AddOptions("Helicity pattern")
     ("enable-alternateasym", po::value<bool>()->default_bool_value(false),
      "enable alternate asymmetries");
+  options.AddOptions("Helicity pattern")
+    ("enable-packed-pattern", po::value<bool>()->default_bool_value(false),
+     "calculate the yield and difference from packed copies of the events");
 
   options.AddOptions("Helicity pattern")
     ("print-burstsum", po::value<bool>()->default_bool_value(false),
@@ -73,14 +78,32 @@ void QwHelicityPattern::ProcessOptions(QwOptions &options)
     fEnableAlternateAsym = kFALSE;
   }
 
+  EnablePackedPattern(options.GetValue<bool>("enable-packed-pattern"));
+
   fBlinder.ProcessOptions(options);
 }
 
+/*****************************************************************/
+void QwHelicityPattern::EnablePackedPattern(Bool_t enable)
+{
+  fPackedPattern.reset();
+  if (enable) {
+    fPackedPattern.reset(new QwPackedPattern(fYield, fPatternSize));
+    if (! fPackedPattern->IsValid()) {
+      QwWarning << "QwHelicityPattern::EnablePackedPattern: "
+                << "The events cannot be packed; the 'enable-packed-pattern' flag is disabled."
+                << QwLog::endl;
+      fPackedPattern.reset();
+    }
+  }
+}
+
 /*****************************************************************/
 QwHelicityPattern::QwHelicityPattern(QwSubsystemArrayParity &event, const TString &run)
   : fBlinder(),
     fHelicityIsMissing(kFALSE),   
     fIgnoreHelicity(kFALSE),
+    fHelicitySubsystemIndex(-1),
     fYield(event), 
     fDifference(event), 
     fAsymmetry(event),   
@@ -114,22 +137,10 @@ QwHelicityPattern::QwHelicityPattern(QwSubsystemArrayParity &event, const TStrin
     running_regression(regression)
 {
   // Retrieve the helicity subsystem to query for
-  std::vector<VQwSubsystem*> subsys_helicity = event.GetSubsystemByType("QwHelicity");
-  if (subsys_helicity.size() > 0) {
-
-    // Take the first helicity subsystem
-    //    fHelicitySubsystem = dynamic_cast<QwHelicity*>(subsys_helicity.at(0));
-    QwHelicity* helicity = dynamic_cast<QwHelicity*>(subsys_helicity.at(0));
-
+  QwHelicity* helicity = BindHelicitySubsystem(event);
+  if (helicity != 0) {
     // Get the maximum pattern phase (i.e. pattern size)
     fPatternSize = helicity->GetMaxPatternPhase();
-
-    // Warn if more than one helicity subsystem defined
-    if (subsys_helicity.size() > 1)
-      QwWarning << "Multiple helicity subsystems defined! "
-                << "Using " << helicity->GetSubsystemName() << "."
-                << QwLog::endl;
-
   } else {
     // We are not using any helicity subsystem
     QwError << "No helicity subsystem defined!  " 
@@ -146,6 +157,7 @@ QwHelicityPattern::QwHelicityPattern(QwSubsystemArrayParity &event, const TStrin
         {
           fEvents.resize(fPatternSize,event);
           fHelicity.resize(fPatternSize,-9999);
+          fPhaseSign.resize(fPatternSize,0);
           fEventNumber.resize(fPatternSize,-1);
           fEventLoaded.resize(fPatternSize,kFALSE);
 
@@ -200,6 +212,7 @@ QwHelicityPattern::QwHelicityPattern(const QwHelicityPattern &source)
     fPositiveHelicitySum(source.fYield), 
     fNegativeHelicitySum(source.fYield),
     fNextPair(source.fNextPair),
+    fHelicitySubsystemIndex(source.fHelicitySubsystemIndex),
     correlator(gQwOptions,*this, 999999),
     regress_from_LRB(gQwOptions,*this,999999),
     regression(gQwOptions,*this),
@@ -209,6 +222,55 @@ QwHelicityPattern::QwHelicityPattern(const QwHelicityPattern &source)
 
 
 
+//*****************************************************************
+/**
+ * Look up the helicity subsystem by type and store its index in the
+ * subsystem array, so that the event loop can access it directly.
+ * @param event Subsystem array with the layout of all events
+ * @return First helicity subsystem, or null if there is none
+ */
+QwHelicity* QwHelicityPattern::BindHelicitySubsystem(QwSubsystemArrayParity &event)
+{
+  fHelicitySubsystemIndex = -1;
+  std::vector<VQwSubsystem*> subsys_helicity = event.GetSubsystemByType("QwHelicity");
+  if (subsys_helicity.size() == 0) return 0;
+
+  // Take the first helicity subsystem
+  QwHelicity* helicity = dynamic_cast<QwHelicity*>(subsys_helicity.at(0));
+  for (size_t i = 0; i < event.size(); i++) {
+    if (event.at(i).get() == subsys_helicity.at(0)) {
+      fHelicitySubsystemIndex = i;
+      break;
+    }
+  }
+
+  // Warn if more than one helicity subsystem defined
+  if (subsys_helicity.size() > 1)
+    QwWarning << "Multiple helicity subsystems defined! "
+              << "Using " << helicity->GetSubsystemName() << "."
+              << QwLog::endl;
+
+  return helicity;
+}
+
+/**
+ * Return the helicity subsystem of the event array from the index found
+ * by BindHelicitySubsystem.  Only if the array does not have a helicity
+ * subsystem at that index is it searched again.
+ * @param event Subsystem array
+ * @return Helicity subsystem, or null if there is none
+ */
+QwHelicity* QwHelicityPattern::GetHelicitySubsystem(QwSubsystemArrayParity &event)
+{
+  if (fHelicitySubsystemIndex >= 0
+   && (size_t) fHelicitySubsystemIndex < event.size()) {
+    QwHelicity* helicity =
+      dynamic_cast<QwHelicity*>(event.at(fHelicitySubsystemIndex).get());
+    if (helicity != 0) return helicity;
+  }
+  return BindHelicitySubsystem(event);
+}
+
 //*****************************************************************
 /**
  * Load event data corresponding to the current pattern from the
@@ -216,6 +278,7 @@ QwHelicityPattern::QwHelicityPattern(const QwHelicityPattern &source)
  */
 void QwHelicityPattern::LoadEventData(QwSubsystemArrayParity &event)
 {
+  QwProfiler::Scope profile(QwProfiler::kPattern);
 
   Bool_t localdebug = kFALSE;
   fPatternIsGood = kFALSE;
@@ -229,12 +292,9 @@ void QwHelicityPattern::LoadEventData(QwSubsystemArrayParity &event)
   
   // Get the list of helicity subsystems
   if (! fHelicityIsMissing){
-    std::vector<VQwSubsystem*> subsys_helicity = event.GetSubsystemByType("QwHelicity");
-    QwHelicity* helicity = 0;
+    QwHelicity* helicity = GetHelicitySubsystem(event);
     
-    if (subsys_helicity.size() > 0) {
-      // Take the first helicity subsystem
-      helicity = dynamic_cast<QwHelicity*>(subsys_helicity.at(0));
+    if (helicity != 0) {
       if (helicity->HasDataLoaded()){
 	localIgnoreHelicity = helicity->IsHelicityIgnored();
 	// Get the event, pattern, phase number and helicity
@@ -252,8 +312,8 @@ void QwHelicityPattern::LoadEventData(QwSubsystemArrayParity &event)
       if (! user_has_been_warned) {
 	QwError << "No helicity subsystem found!  Dropping to \"Missing Helicity\" mode!" << QwLog::endl;
 	user_has_been_warned = kTRUE;
-	fHelicityIsMissing = kTRUE;
       }
+      fHelicityIsMissing = kTRUE;
     }
   }
   if (fHelicityIsMissing){
@@ -298,7 +358,17 @@ void QwHelicityPattern::LoadEventData(QwSubsystemArrayParity &event)
       std::cout<<"QwHelicityPattern::LoadEventData local i="
 	       <<localPhaseNumber<<"\n";
     }
-    fEvents[localPhaseNumber]      = event;
+    if (! fPackedPattern) {
+      fEvents[localPhaseNumber] = event;
+    } else {
+      //  The packed events are used instead of the copies, except by the
+      //  alternate asymmetries and for the subsystems which are not packed
+      fPackedPattern->LoadEventData(localPhaseNumber, event);
+      if (fEnableAlternateAsym)
+        fEvents[localPhaseNumber] = event;
+      else
+        fPackedPattern->CopyUnpackedData(event, fEvents[localPhaseNumber]);
+    }
     fEventLoaded[localPhaseNumber] = kTRUE;
     fHelicity[localPhaseNumber]    = localHelicityActual;
     fEventNumber[localPhaseNumber] = localEventNumber;
@@ -354,19 +424,20 @@ void  QwHelicityPattern::CalculatePairAsymmetry()
     fPairIsGood = kTRUE;
     fNextPair++;
 
-    fPairYield.Sum(fEvents.at(firstevt), fEvents.at(secondevt));
-    fPairYield.Scale(0.5);
+    if (fPackedPattern) {
+      fPackedPattern->CalculateSum(firstevt, secondevt, fEvents, fPairYield, 0.5);
+    } else {
+      fPairYield.Sum(fEvents.at(firstevt), fEvents.at(secondevt));
+      fPairYield.Scale(0.5);
+    }
   
     if (fIgnoreHelicity){
-      fPairDifference.Difference(fEvents.at(firstevt), fEvents.at(secondevt));
-      fPairDifference.Scale(0.5);
+      CalculatePairDifference(firstevt, secondevt);
     } else {
       if (fHelicity[firstevt] == plushel && fHelicity[firstevt]!=fHelicity[secondevt]) {
-	fPairDifference.Difference(fEvents.at(firstevt), fEvents.at(secondevt));
-	fPairDifference.Scale(0.5);
+	CalculatePairDifference(firstevt, secondevt);
       } else if (fHelicity[firstevt] == minushel && fHelicity[firstevt]!=fHelicity[secondevt]) {
-	fPairDifference.Difference(fEvents.at(secondevt),fEvents.at(firstevt));
-	fPairDifference.Scale(0.5);
+	CalculatePairDifference(secondevt, firstevt);
       } else if (fHelicity[firstevt] == -9999 || fHelicity[secondevt]==-9999) {
 	checkhel= -9999;
 	// Helicity polarity is undefined.
@@ -410,8 +481,24 @@ void  QwHelicityPattern::CalculatePairAsymmetry()
 }
 
 
+/**
+ * Calculate the pair difference (plus - minus)/2, from the packed events
+ * if the pattern is packed.
+ */
+void QwHelicityPattern::CalculatePairDifference(size_t plusevt, size_t minusevt)
+{
+  if (fPackedPattern) {
+    fPackedPattern->CalculateDifference(plusevt, minusevt, fEvents, fPairDifference, 0.5);
+  } else {
+    fPairDifference.Difference(fEvents.at(plusevt), fEvents.at(minusevt));
+    fPairDifference.Scale(0.5);
+  }
+}
+
+
 Bool_t QwHelicityPattern::IsGoodAsymmetry()
 {
+  QwProfiler::Scope profile(QwProfiler::kPattern);
   Bool_t complete_and_good = kFALSE;
   if (IsCompletePattern()){
     CalculateAsymmetry();
@@ -463,8 +550,10 @@ void  QwHelicityPattern::CalculateAsymmetry()
   Bool_t firstplushel=kTRUE;
   Bool_t firstminushel=kTRUE;
 
-  fPositiveHelicitySum.ClearEventData();
-  fNegativeHelicitySum.ClearEventData();
+  if (! fPackedPattern) {
+    fPositiveHelicitySum.ClearEventData();
+    fNegativeHelicitySum.ClearEventData();
+  }
 
   if (fIgnoreHelicity){
     //  Don't check to see if we have equal numbers of even and odd helicity states in this pattern.
@@ -475,14 +564,20 @@ void  QwHelicityPattern::CalculateAsymmetry()
 	localhel ^= ((i >> j)&0x1);
       }
       if (localhel == plushel) {
-	if (firstplushel) {
+	fPhaseSign[i] = +1;
+	if (fPackedPattern) {
+	  //  Summed from the packed events below
+	} else if (firstplushel) {
 	  fPositiveHelicitySum = fEvents.at(i);
 	  firstplushel = kFALSE;
 	} else {
 	  fPositiveHelicitySum += fEvents.at(i);
 	}
       } else if (localhel == minushel) {
-	if (firstminushel) {
+	fPhaseSign[i] = -1;
+	if (fPackedPattern) {
+	  //  Summed from the packed events below
+	} else if (firstminushel) {
 	  fNegativeHelicitySum = fEvents.at(i);
 	  firstminushel = kFALSE;
 	} else {
@@ -495,7 +590,10 @@ void  QwHelicityPattern::CalculateAsymmetry()
     for (size_t i = 0; i < (size_t) fPatternSize; i++) {
       if (fHelicity[i] == plushel) {
 	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  here filling fPositiveHelicitySum \n";
-	if (firstplushel) {
+	fPhaseSign[i] = +1;
+	if (fPackedPattern) {
+	  //  Summed from the packed events below
+	} else if (firstplushel) {
 	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with = \n";
 	  fPositiveHelicitySum = fEvents.at(i);
 	  firstplushel = kFALSE;
@@ -506,7 +604,10 @@ void  QwHelicityPattern::CalculateAsymmetry()
 	checkhel += 1;
       } else if (fHelicity[i] == minushel) {
 	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  here filling fNegativeHelicitySum \n";
-	if (firstminushel) {
+	fPhaseSign[i] = -1;
+	if (fPackedPattern) {
+	  //  Summed from the packed events below
+	} else if (firstminushel) {
 	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with = \n";
 	  fNegativeHelicitySum = fEvents.at(i);
 	  firstminushel = kFALSE;
@@ -545,10 +646,16 @@ void  QwHelicityPattern::CalculateAsymmetry()
     fQuartetNumber++;//Then increment the quartet number
     //std::cout<<" quartet count ="<<fQuartetNumber<<"\n";
 
-    fYield.Sum(fPositiveHelicitySum,fNegativeHelicitySum);
-    fYield.Scale(1.0/fPatternSize);
-    fDifference.Difference(fPositiveHelicitySum,fNegativeHelicitySum);
-    fDifference.Scale(1.0/fPatternSize);
+    if (fPackedPattern) {
+      fPackedPattern->CalculateYieldAndDifference(fPhaseSign, fEvents,
+          fPositiveHelicitySum, fNegativeHelicitySum, fYield, fDifference,
+          1.0/fPatternSize);
+    } else {
+      fYield.Sum(fPositiveHelicitySum,fNegativeHelicitySum);
+      fYield.Scale(1.0/fPatternSize);
+      fDifference.Difference(fPositiveHelicitySum,fNegativeHelicitySum);
+      fDifference.Scale(1.0/fPatternSize);
+    }
 
     
     
@@ -633,7 +740,8 @@ void QwHelicityPattern::ClearEventData()
   fIgnoreHelicity = kFALSE;
   for(size_t i=0; i<fEvents.size(); i++)
     {
-      fEvents[i].ClearEventData();
+      //  Packed events are overwritten when the phase is loaded again
+      if (! fPackedPattern) fEvents[i].ClearEventData();
       fEventLoaded[i]=kFALSE;
       fHelicity[i]=-999;
     }
@@ -758,6 +866,54 @@ void  QwHelicityPattern::AccumulatePairRunningSum(QwHelicityPattern &entry)
 
 
 
+//*****************************************************************
+/**
+ * Append the running sums of yield, difference and asymmetry, and
+ * those of the pairs, to a buffer, so that they can be merged with
+ * the running sums of other parts of the run.
+ */
+void  QwHelicityPattern::PackRunningSum(std::vector<Double_t> &buffer) const
+{
+  fYield.PackEventData(buffer);
+  fAsymmetry.PackEventData(buffer);
+  if (fEnableDifference){
+    fDifference.PackEventData(buffer);
+  }
+  if (fEnableAlternateAsym) {
+    fAsymmetry1.PackEventData(buffer);
+    fAsymmetry2.PackEventData(buffer);
+  }
+  fPairYield.PackEventData(buffer);
+  fPairAsymmetry.PackEventData(buffer);
+  if (fEnableDifference){
+    fPairDifference.PackEventData(buffer);
+  }
+}
+
+//*****************************************************************
+/**
+ * Merge the running sums written by PackRunningSum for another part
+ * of the run into these running sums.
+ */
+void  QwHelicityPattern::MergeRunningSum(const Double_t* &data)
+{
+  fYield.MergeRunningSum(data);
+  fAsymmetry.MergeRunningSum(data);
+  if (fEnableDifference){
+    fDifference.MergeRunningSum(data);
+  }
+  if (fEnableAlternateAsym) {
+    fAsymmetry1.MergeRunningSum(data);
+    fAsymmetry2.MergeRunningSum(data);
+  }
+  fPairYield.MergeRunningSum(data);
+  fPairAsymmetry.MergeRunningSum(data);
+  if (fEnableDifference){
+    fPairDifference.MergeRunningSum(data);
+  }
+}
+
+
 //*****************************************************************
 /**
  * Accumulate the running burst sum by adding the current burst sum
@@ -1043,6 +1199,7 @@ void QwHelicityPattern::Print() const
 }
 
 void QwHelicityPattern::ProcessDataHandlerEntry() {
+  QwProfiler::Scope profile(QwProfiler::kDataHandlers);
 
 	regression.LinearRegression(QwCombiner::kRegTypeAsym);
 	running_regression.AccumulateRunningSum(regression);
@@ -1059,6 +1216,27 @@ void QwHelicityPattern::FinishDataHandler() {
 
 }
 
+/**
+ * Append the accumulators of the correlator to a buffer, so that they
+ * can be merged with those of other parts of the run.  The running
+ * regression is not included.
+ */
+void QwHelicityPattern::PackDataHandlers(std::vector<Double_t> &buffer) const {
+
+  correlator.PackAccumulators(buffer);
+
+}
+
+/**
+ * Merge the accumulators written by PackDataHandlers for another part
+ * of the run, before FinishDataHandler.
+ */
+void QwHelicityPattern::MergeDataHandlers(const Double_t* &data) {
+
+  correlator.MergeAccumulators(data);
+
+}
+
 
 
 
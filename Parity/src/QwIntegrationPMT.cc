@@ -267,6 +267,23 @@ void QwIntegrationPMT::UpdateErrorFlag(const QwIntegrationPMT* ev_error){
   }  
 };
 
+void QwIntegrationPMT::MergeErrorCounters(const QwIntegrationPMT *source){
+  try {
+    if(typeid(*source)==typeid(*this)) {
+      if (this->GetElementName()!="") {
+	fTriumf_ADC.MergeErrorCounters(source->fTriumf_ADC);
+      }
+    } else {
+      TString loc="Standard exception from QwIntegrationPMT::MergeErrorCounters :"+
+        source->GetElementName()+" "+this->GetElementName()+" are not of the "
+        +"same type";
+      throw std::invalid_argument(loc.Data());
+    }
+  } catch (std::exception& e) {
+    std::cerr<< e.what()<<std::endl;
+  }
+};
+
 /********************************************************/
 
 
@@ -295,6 +312,26 @@ QwIntegrationPMT& QwIntegrationPMT::operator= (const QwIntegrationPMT &value)
   return *this;
 }
 
+void QwIntegrationPMT::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (GetElementName()!="")
+    {
+      fTriumf_ADC.PackEventData(buffer);
+      buffer.push_back(fPedestal);
+      buffer.push_back(fCalibration);
+    }
+}
+
+void QwIntegrationPMT::UnpackEventData(const Double_t*& data)
+{
+  if (GetElementName()!="")
+    {
+      fTriumf_ADC.UnpackEventData(data);
+      fPedestal = *data++;
+      fCalibration = *data++;
+    }
+}
+
 QwIntegrationPMT& QwIntegrationPMT::operator+= (const QwIntegrationPMT &value)
 {
   if (GetElementName()!="")
@@ -45,6 +45,11 @@ void  QwLinearDiodeArray::InitializeChannel(TString name)
   fRelPos[0].InitializeChannel(name+"RelMean","derived");
   fRelPos[1].InitializeChannel(name+"RelVariance","derived");
 
+  fMean.InitializeChannel("mean","raw");
+  fMeanSqr.InitializeChannel("meansqr","raw");
+  fTmp.InitializeChannel("tmp","raw");
+  fTmp2.InitializeChannel("tmp2","raw");
+
   bFullSave=kTRUE;
 
   return;
@@ -71,6 +76,11 @@ void  QwLinearDiodeArray::InitializeChannel(TString subsystem, TString name)
   fRelPos[0].InitializeChannel(subsystem, "QwLinearDiodeArray", name+"RelMean","derived");
   fRelPos[1].InitializeChannel(subsystem, "QwLinearDiodeArray", name+"RelVariance","derived");
 
+  fMean.InitializeChannel("mean","raw");
+  fMeanSqr.InitializeChannel("meansqr","raw");
+  fTmp.InitializeChannel("tmp","raw");
+  fTmp2.InitializeChannel("tmp2","raw");
+
   bFullSave=kTRUE;
 
   return;
@@ -276,16 +286,34 @@ void QwLinearDiodeArray::UpdateErrorFlag(const VQwBPM *ev_error){
   }  
 };
 
+void QwLinearDiodeArray::MergeErrorCounters(const VQwBPM *source){
+  Short_t i=0;
+  try {
+    if(typeid(*source)==typeid(*this)) {
+      if (this->GetElementName()!="") {
+        const QwLinearDiodeArray* input = dynamic_cast<const QwLinearDiodeArray* >(source);
+	for(i=0;i<8;i++){
+	  fPhotodiode[i].MergeErrorCounters(input->fPhotodiode[i]);
+	}
+	for(i=kXAxis;i<kNumAxes;i++) {
+	  fRelPos[i].MergeErrorCounters(input->fRelPos[i]);
+	}
+	fEffectiveCharge.MergeErrorCounters(input->fEffectiveCharge);
+      }
+    } else {
+      TString loc="Standard exception from QwLinearDiodeArray::MergeErrorCounters :"+
+        source->GetElementName()+" "+this->GetElementName()+" are not of the "
+        +"same type";
+      throw std::invalid_argument(loc.Data());
+    }
+  } catch (std::exception& e) {
+    std::cerr<< e.what()<<std::endl;
+  }
+};
+
 void  QwLinearDiodeArray::ProcessEvent()
 {
   Bool_t localdebug = kFALSE;
-  static QwVQWK_Channel mean, meansqr;
-  static QwVQWK_Channel tmp("tmp");
-  static QwVQWK_Channel tmp2("tmp2");
-
-  mean.InitializeChannel("mean","raw");
-  meansqr.InitializeChannel("meansqr","raw");
-
 
   size_t i = 0;
 
@@ -304,23 +332,23 @@ void  QwLinearDiodeArray::ProcessEvent()
   
   //  First calculate the mean pad position and mean of squared pad position
   //  with respect to the center of the array, in units of pad spacing.
-  mean.ClearEventData();
-  meansqr.ClearEventData();
+  fMean.ClearEventData();
+  fMeanSqr.ClearEventData();
   for (i=0;i<8;i++){
     Double_t pos = kQwLinearDiodeArrayPadSize*i*0.5;
-    tmp = fPhotodiode[i];
-    tmp.Scale(pos);  // Scale for S(i)*pos
-    mean+=tmp;
-    tmp.Scale(pos);  // Scale again for S(i)*(pos**2)
-    meansqr+=tmp;
+    fTmp = fPhotodiode[i];
+    fTmp.Scale(pos);  // Scale for S(i)*pos
+    fMean+=fTmp;
+    fTmp.Scale(pos);  // Scale again for S(i)*(pos**2)
+    fMeanSqr+=fTmp;
   }
-  fRelPos[0].Ratio(mean,fEffectiveCharge);
-  tmp = meansqr;
-  meansqr.Ratio(tmp,fEffectiveCharge);
-  tmp2.Product(fRelPos[0], fRelPos[0]);
+  fRelPos[0].Ratio(fMean,fEffectiveCharge);
+  fTmp = fMeanSqr;
+  fMeanSqr.Ratio(fTmp,fEffectiveCharge);
+  fTmp2.Product(fRelPos[0], fRelPos[0]);
 
   //  Now calculate the variance
-  fRelPos[1].Difference(meansqr,tmp2);
+  fRelPos[1].Difference(fMeanSqr,fTmp2);
 
   if(localdebug){
     std::cout<<"\n#################"<<std::endl;
@@ -442,6 +470,34 @@ QwLinearDiodeArray& QwLinearDiodeArray::operator= (const QwLinearDiodeArray &val
   return *this;
 }
 
+void QwLinearDiodeArray::PackEventData(std::vector<Double_t>& buffer) const
+{
+  VQwBPM::PackEventData(buffer);
+
+  if (GetElementName()!=""){
+    size_t i = 0;
+    fEffectiveCharge.PackEventData(buffer);
+    for(i=0;i<8;i++) fPhotodiode[i].PackEventData(buffer);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].PackEventData(buffer);
+    }
+  }
+}
+
+void QwLinearDiodeArray::UnpackEventData(const Double_t*& data)
+{
+  VQwBPM::UnpackEventData(data);
+
+  if (GetElementName()!=""){
+    size_t i = 0;
+    fEffectiveCharge.UnpackEventData(data);
+    for(i=0;i<8;i++) fPhotodiode[i].UnpackEventData(data);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].UnpackEventData(data);
+    }
+  }
+}
+
 VQwBPM& QwLinearDiodeArray::operator+= (const VQwBPM &value)
 {
   *(dynamic_cast<QwLinearDiodeArray*>(this)) +=
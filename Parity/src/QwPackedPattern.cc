@@ -0,0 +1,379 @@
+/**********************************************************\
+* File: QwPackedPattern.cc                                 *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#include "QwPackedPattern.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwSubsystemArrayParity.h"
+#include "VQwSubsystemParity.h"
+
+/// Set all packed values of an array to the same test value
+static void FillPackedData(QwSubsystemArrayParity& array, size_t size, Double_t value)
+{
+  std::vector<Double_t> buffer(size, value);
+  const Double_t* data = &buffer[0];
+  array.UnpackEventData(data);
+}
+
+
+QwPackedPattern::QwPackedPattern(const QwSubsystemArrayParity& event, Int_t pattern_size)
+: fValid(kFALSE),
+  fSize(0),
+  fScale(0.0)
+{
+  fValid = BuildOperations(event);
+  if (! fValid) return;
+
+  fEvents.resize(pattern_size);
+  for (size_t i = 0; i < fEvents.size(); i++)
+    fEvents[i].reserve(fSize);
+  fPositive.resize(fSize);
+  fNegative.resize(fSize);
+  fYield.resize(fSize);
+  fDifference.resize(fSize);
+  fPair.resize(fSize);
+
+  QwMessage << "QwPackedPattern: " << fSize << " values per event";
+  if (fUnpacked.size() > 0) {
+    QwMessage << ", not packed:";
+    for (size_t j = 0; j < fUnpacked.size(); j++)
+      QwMessage << " " << event.at(fUnpacked[j])->GetSubsystemName();
+  }
+  QwMessage << QwLog::endl;
+}
+
+
+/**
+ * Find the effect of an operator on one value of the buffer, from the
+ * value x before the operator, the value y of the other operand (or
+ * the scale factor) and the result.
+ */
+QwPackedPattern::EQwPackedOperation QwPackedPattern::Classify(
+    Double_t x, Double_t y, Double_t result, Double_t scale)
+{
+  if (result == 0.0)       return kZero;
+  if (result == x)         return kKeep;
+  if (result == y)         return kCopy;
+  if (result == x + y)     return kAdd;
+  if (result == x - y)     return kSubtract;
+  if (result == Double_t(UInt_t(x) | UInt_t(y))) return kOr;
+  if (result == x * scale) return kScale;
+  if (result == x * scale * scale) return kScaleSquared;
+  return kUnknown;
+}
+
+
+/**
+ * Apply the operators of the arrays to two sets of test values, and
+ * record for each value of the buffer what the operators do with it.
+ * The test values are chosen such that all effects give different
+ * results.  Returns kFALSE if a value does not behave the same way for
+ * both sets, or not like any of the known effects.
+ */
+Bool_t QwPackedPattern::BuildOperations(const QwSubsystemArrayParity& event)
+{
+  std::vector<Double_t> buffer;
+  event.PackEventData(buffer);
+  fSize = buffer.size();
+
+  for (size_t i = 0; i < event.size(); i++) {
+    const VQwSubsystemParity* subsys =
+      dynamic_cast<const VQwSubsystemParity*>(event.at(i).get());
+    buffer.clear();
+    if (subsys != 0 && ! subsys->PackEventData(buffer))
+      fUnpacked.push_back(i);
+  }
+
+  QwSubsystemArrayParity x_array(event), y_array(event), result(event);
+  const Double_t x[2] = { 3.0, 6.0 };
+  const Double_t y[2] = { 5.0, 10.0 };
+  const Double_t scale = 2.0;
+
+  std::vector<EQwPackedOperation> add(fSize, kUnknown), sub(fSize, kUnknown), mul(fSize, kUnknown);
+  for (Int_t test = 0; test < 2; test++) {
+    FillPackedData(x_array, fSize, x[test]);
+    FillPackedData(y_array, fSize, y[test]);
+
+    //  The assignment has to copy all values
+    FillPackedData(result, fSize, 11.0);
+    result = x_array;
+    buffer.clear();
+    result.PackEventData(buffer);
+    for (size_t k = 0; k < fSize; k++) {
+      if (buffer[k] != x[test]) {
+        QwWarning << "QwPackedPattern: value " << k << " is not copied by operator=" << QwLog::endl;
+        return kFALSE;
+      }
+    }
+
+    result = x_array;
+    result += y_array;
+    buffer.clear();
+    result.PackEventData(buffer);
+    for (size_t k = 0; k < fSize; k++) {
+      EQwPackedOperation op = Classify(x[test], y[test], buffer[k], 0.0);
+      if (op == kScale || op == kScaleSquared || (test > 0 && op != add[k])) op = kUnknown;
+      if (op == kUnknown) {
+        QwWarning << "QwPackedPattern: unknown effect of operator+= on value " << k << QwLog::endl;
+        return kFALSE;
+      }
+      add[k] = op;
+    }
+
+    result = x_array;
+    result -= y_array;
+    buffer.clear();
+    result.PackEventData(buffer);
+    for (size_t k = 0; k < fSize; k++) {
+      EQwPackedOperation op = Classify(x[test], y[test], buffer[k], 0.0);
+      if (op == kScale || op == kScaleSquared || (test > 0 && op != sub[k])) op = kUnknown;
+      if (op == kUnknown) {
+        QwWarning << "QwPackedPattern: unknown effect of operator-= on value " << k << QwLog::endl;
+        return kFALSE;
+      }
+      sub[k] = op;
+    }
+
+    result = x_array;
+    result.Scale(scale);
+    buffer.clear();
+    result.PackEventData(buffer);
+    for (size_t k = 0; k < fSize; k++) {
+      EQwPackedOperation op = Classify(x[test], scale, buffer[k], scale);
+      if (op == kCopy || op == kAdd || op == kSubtract || op == kOr
+       || (test > 0 && op != mul[k])) op = kUnknown;
+      if (op == kUnknown) {
+        QwWarning << "QwPackedPattern: unknown effect of Scale on value " << k << QwLog::endl;
+        return kFALSE;
+      }
+      mul[k] = op;
+    }
+  }
+
+  //  Turn the effects into the masks and coefficients of the loops
+  const ULong64_t all = ~ULong64_t(0);
+  fAddUseX.resize(fSize);
+  fAddUseY.resize(fSize);
+  fAddSignY.resize(fSize);
+  fSubUseX.resize(fSize);
+  fSubUseY.resize(fSize);
+  fSubSignY.resize(fSize);
+  fScalePower.resize(fSize);
+  fScaleKeep.resize(fSize);
+  for (size_t k = 0; k < fSize; k++) {
+    fAddUseX[k]  = (add[k] == kKeep || add[k] == kAdd || add[k] == kSubtract)? all: 0;
+    fAddSignY[k] = (add[k] == kSubtract)? -1.0: 1.0;
+    fAddUseY[k]  = (add[k] == kCopy || add[k] == kAdd || add[k] == kSubtract)? all: 0;
+    if (add[k] == kOr) fAddOr.push_back(k);
+    fSubUseX[k]  = (sub[k] == kKeep || sub[k] == kAdd || sub[k] == kSubtract)? all: 0;
+    fSubSignY[k] = (sub[k] == kSubtract)? -1.0: 1.0;
+    fSubUseY[k]  = (sub[k] == kCopy || sub[k] == kAdd || sub[k] == kSubtract)? all: 0;
+    if (sub[k] == kOr) fSubOr.push_back(k);
+    fScalePower[k] = (mul[k] == kZero)? -1: (mul[k] == kScale)? 1: (mul[k] == kScaleSquared)? 2: 0;
+    fScaleKeep[k]  = (mul[k] == kZero)? 0: all;
+  }
+  fScaleFactor.resize(fSize);
+  return kTRUE;
+}
+
+
+void QwPackedPattern::LoadEventData(Int_t phase, const QwSubsystemArrayParity& event)
+{
+  std::vector<Double_t>& buffer = fEvents.at(phase);
+  buffer.clear();
+  event.PackEventData(buffer);
+}
+
+
+/**
+ * Only the subsystems which are not packed are read from the events of
+ * the pattern, so the other subsystems need not be copied with them.
+ */
+void QwPackedPattern::CopyUnpackedData(const QwSubsystemArrayParity& event,
+    QwSubsystemArrayParity& copy) const
+{
+  for (size_t j = 0; j < fUnpacked.size(); j++) {
+    size_t index = fUnpacked[j];
+    *(copy.at(index)) = event.at(index).get();
+  }
+}
+
+
+/**
+ * out = x op y for all values; out may be the same buffer as x.  The
+ * operands are selected with bit masks instead of branches, so that the
+ * loop over all values is vectorized; the few error flags are ORed
+ * afterwards, from x before it is overwritten.
+ */
+void QwPackedPattern::Combine(Double_t* out, const Double_t* x, const Double_t* y,
+    const std::vector<ULong64_t>& use_x, const std::vector<ULong64_t>& use_y,
+    const std::vector<Double_t>& sign_y, const std::vector<size_t>& or_slots)
+{
+  fFlags.resize(or_slots.size());
+  for (size_t i = 0; i < or_slots.size(); i++)
+    fFlags[i] = UInt_t(x[or_slots[i]]) | UInt_t(y[or_slots[i]]);
+
+  const ULong64_t* ux = &use_x[0];
+  const ULong64_t* uy = &use_y[0];
+  const Double_t* sy = &sign_y[0];
+  for (size_t k = 0; k < fSize; k++)
+    out[k] = Mask(x[k], ux[k]) + Mask(sy[k] * y[k], uy[k]);
+
+  for (size_t i = 0; i < or_slots.size(); i++)
+    out[or_slots[i]] = Double_t(fFlags[i]);
+}
+
+
+void QwPackedPattern::Scale(Double_t* out, Double_t scale)
+{
+  if (scale != fScale) {
+    for (size_t k = 0; k < fSize; k++)
+      fScaleFactor[k] = (fScalePower[k] == 1)? scale: (fScalePower[k] == 2)? scale * scale: 1.0;
+    fScale = scale;
+  }
+  const ULong64_t* keep = &fScaleKeep[0];
+  const Double_t* factor = &fScaleFactor[0];
+  for (size_t k = 0; k < fSize; k++)
+    out[k] = Mask(out[k] * factor[k], keep[k]);
+}
+
+
+/**
+ * Calculate the sums of the positive and negative helicity events, and
+ * from them the yield and difference of the pattern, both scaled, as
+ * QwHelicityPattern::CalculateAsymmetry does with the arrays.  The
+ * packed values of the yield and difference are written to their arrays;
+ * the subsystems which are not packed are calculated with their own
+ * operators, using the positive and negative arrays.
+ * @param sign Helicity of each phase of the pattern, +1 or -1
+ * @param events Events of the pattern
+ * @param positive Sum of the positive helicity events (only unpacked subsystems)
+ * @param negative Sum of the negative helicity events (only unpacked subsystems)
+ * @param yield Yield of the pattern
+ * @param difference Difference of the pattern
+ * @param scale Scale factor of the yield and difference
+ */
+void QwPackedPattern::CalculateYieldAndDifference(
+    const std::vector<Int_t>& sign,
+    const std::vector<QwSubsystemArrayParity>& events,
+    QwSubsystemArrayParity& positive,
+    QwSubsystemArrayParity& negative,
+    QwSubsystemArrayParity& yield,
+    QwSubsystemArrayParity& difference,
+    Double_t scale)
+{
+  Bool_t first_positive = kTRUE;
+  Bool_t first_negative = kTRUE;
+  for (size_t i = 0; i < fEvents.size(); i++) {
+    const Double_t* event = &fEvents[i][0];
+    if (sign[i] > 0) {
+      if (first_positive) fPositive.assign(fEvents[i].begin(), fEvents[i].end());
+      else Combine(&fPositive[0], &fPositive[0], event, fAddUseX, fAddUseY, fAddSignY, fAddOr);
+      first_positive = kFALSE;
+    } else if (sign[i] < 0) {
+      if (first_negative) fNegative.assign(fEvents[i].begin(), fEvents[i].end());
+      else Combine(&fNegative[0], &fNegative[0], event, fAddUseX, fAddUseY, fAddSignY, fAddOr);
+      first_negative = kFALSE;
+    }
+  }
+
+  Combine(&fYield[0], &fPositive[0], &fNegative[0], fAddUseX, fAddUseY, fAddSignY, fAddOr);
+  Scale(&fYield[0], scale);
+  Combine(&fDifference[0], &fPositive[0], &fNegative[0], fSubUseX, fSubUseY, fSubSignY, fSubOr);
+  Scale(&fDifference[0], scale);
+
+  const Double_t* data = &fYield[0];
+  yield.UnpackEventData(data);
+  data = &fDifference[0];
+  difference.UnpackEventData(data);
+
+  //  Subsystems which are not packed
+  for (size_t j = 0; j < fUnpacked.size(); j++) {
+    size_t index = fUnpacked[j];
+    VQwSubsystemParity* pos = dynamic_cast<VQwSubsystemParity*>(positive.at(index).get());
+    VQwSubsystemParity* neg = dynamic_cast<VQwSubsystemParity*>(negative.at(index).get());
+    first_positive = kTRUE;
+    first_negative = kTRUE;
+    for (size_t i = 0; i < events.size(); i++) {
+      VQwSubsystem* event = events[i].at(index).get();
+      if (sign[i] > 0) {
+        if (first_positive) *pos = event;
+        else *pos += event;
+        first_positive = kFALSE;
+      } else if (sign[i] < 0) {
+        if (first_negative) *neg = event;
+        else *neg += event;
+        first_negative = kFALSE;
+      }
+    }
+    VQwSubsystemParity* y = dynamic_cast<VQwSubsystemParity*>(yield.at(index).get());
+    VQwSubsystemParity* d = dynamic_cast<VQwSubsystemParity*>(difference.at(index).get());
+    y->Sum(pos, neg);
+    y->Scale(scale);
+    d->Difference(pos, neg);
+    d->Scale(scale);
+  }
+}
+
+
+/**
+ * Calculate (phase1 + phase2) * scale, as QwSubsystemArrayParity::Sum
+ * and Scale do with the events of the two phases.
+ * @param phase1 First phase of the pattern
+ * @param phase2 Second phase of the pattern
+ * @param events Events of the pattern (only unpacked subsystems)
+ * @param sum Scaled sum
+ * @param scale Scale factor
+ */
+void QwPackedPattern::CalculateSum(Int_t phase1, Int_t phase2,
+    const std::vector<QwSubsystemArrayParity>& events,
+    QwSubsystemArrayParity& sum, Double_t scale)
+{
+  Combine(&fPair[0], &fEvents.at(phase1)[0], &fEvents.at(phase2)[0],
+      fAddUseX, fAddUseY, fAddSignY, fAddOr);
+  Scale(&fPair[0], scale);
+  const Double_t* data = &fPair[0];
+  sum.UnpackEventData(data);
+
+  //  Subsystems which are not packed
+  for (size_t j = 0; j < fUnpacked.size(); j++) {
+    size_t index = fUnpacked[j];
+    VQwSubsystemParity* s = dynamic_cast<VQwSubsystemParity*>(sum.at(index).get());
+    s->Sum(events.at(phase1).at(index).get(), events.at(phase2).at(index).get());
+    s->Scale(scale);
+  }
+}
+
+
+/**
+ * Calculate (phase1 - phase2) * scale, as QwSubsystemArrayParity::Difference
+ * and Scale do with the events of the two phases.
+ * @param phase1 First phase of the pattern
+ * @param phase2 Second phase of the pattern
+ * @param events Events of the pattern (only unpacked subsystems)
+ * @param difference Scaled difference
+ * @param scale Scale factor
+ */
+void QwPackedPattern::CalculateDifference(Int_t phase1, Int_t phase2,
+    const std::vector<QwSubsystemArrayParity>& events,
+    QwSubsystemArrayParity& difference, Double_t scale)
+{
+  Combine(&fPair[0], &fEvents.at(phase1)[0], &fEvents.at(phase2)[0],
+      fSubUseX, fSubUseY, fSubSignY, fSubOr);
+  Scale(&fPair[0], scale);
+  const Double_t* data = &fPair[0];
+  difference.UnpackEventData(data);
+
+  //  Subsystems which are not packed
+  for (size_t j = 0; j < fUnpacked.size(); j++) {
+    size_t index = fUnpacked[j];
+    VQwSubsystemParity* d = dynamic_cast<VQwSubsystemParity*>(difference.at(index).get());
+    d->Difference(events.at(phase1).at(index).get(), events.at(phase2).at(index).get());
+    d->Scale(scale);
+  }
+}
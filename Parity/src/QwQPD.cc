@@ -37,6 +37,12 @@ void  QwQPD::InitializeChannel(TString name)
   
   for(i=kXAxis;i<kNumAxes;i++) {
     fRelPos[i].InitializeChannel(name+"Rel"+kAxisLabel[i],"derived");
+
+  fNumer[kXAxis].InitializeChannel("Xnumerator","raw");
+  fNumer[kYAxis].InitializeChannel("Ynumerator","raw");
+  fTmp.InitializeChannel("tmp","raw");
+  fTmp1.InitializeChannel("tmp1","raw");
+  fTmp2.InitializeChannel("tmp2","raw");
     fAbsPos[i].InitializeChannel(name+kAxisLabel[i],"derived");
   }
   
@@ -60,6 +66,12 @@ void  QwQPD::InitializeChannel(TString subsystem, TString name)
       std::cout<<" photodiode ["<<i<<"]="<<fPhotodiode[i].GetElementName()<<"\n";
   }
   for(i=kXAxis;i<kNumAxes;i++) fRelPos[i].InitializeChannel(subsystem, "QwQPD", name+"Rel"+kAxisLabel[i],"derived");
+
+  fNumer[kXAxis].InitializeChannel("Xnumerator","raw");
+  fNumer[kYAxis].InitializeChannel("Ynumerator","raw");
+  fTmp.InitializeChannel("tmp","raw");
+  fTmp1.InitializeChannel("tmp1","raw");
+  fTmp2.InitializeChannel("tmp2","raw");
   for(i=kXAxis;i<kNumAxes;i++) fAbsPos[i].InitializeChannel(subsystem, "QwQPD", name+kAxisLabel[i],"derived");
 
   bFullSave=kTRUE;
@@ -351,19 +363,37 @@ void QwQPD::UpdateErrorFlag(const VQwBPM *ev_error){
   
 };
 
+void QwQPD::MergeErrorCounters(const VQwBPM *source){
+  Short_t i=0;
+  try {
+    if(typeid(*source)==typeid(*this)) {
+      if (this->GetElementName()!="") {
+        const QwQPD* input = dynamic_cast<const QwQPD* >(source);
+	for(i=0;i<4;i++){
+	  fPhotodiode[i].MergeErrorCounters(input->fPhotodiode[i]);
+	}
+	for(i=kXAxis;i<kNumAxes;i++) {
+	  fRelPos[i].MergeErrorCounters(input->fRelPos[i]);
+	  fAbsPos[i].MergeErrorCounters(input->fAbsPos[i]);
+	}
+	fEffectiveCharge.MergeErrorCounters(input->fEffectiveCharge);
+      }
+    } else {
+      TString loc="Standard exception from QwQPD::MergeErrorCounters :"+
+        source->GetElementName()+" "+this->GetElementName()+" are not of the "
+        +"same type";
+      throw std::invalid_argument(loc.Data());
+    }
+  } catch (std::exception& e) {
+    std::cerr<< e.what()<<std::endl;
+  }
+};
+
 
 
 void  QwQPD::ProcessEvent()
 {
   Bool_t localdebug = kFALSE;
-  static QwVQWK_Channel numer[2];
-  static QwVQWK_Channel tmp("tmp");
-  static QwVQWK_Channel tmp1("tmp1");
-  static QwVQWK_Channel tmp2("tmp2");
-
-  numer[0].InitializeChannel("Xnumerator","raw");
-  numer[1].InitializeChannel("Ynumerator","raw");
-
   Short_t i = 0;
 
   ApplyHWChecks();
@@ -407,37 +437,37 @@ void  QwQPD::ProcessEvent()
   }
 
   // X numerator
-  tmp1.ClearEventData();
-  tmp1.Difference(fPhotodiode[3],fPhotodiode[1]);  // 4-2
-  tmp2.ClearEventData();
-  tmp2.Difference(fPhotodiode[2],fPhotodiode[0]);  // 3-1
-  tmp.ClearEventData();
-  numer[0].Sum(tmp1,tmp2);
+  fTmp1.ClearEventData();
+  fTmp1.Difference(fPhotodiode[3],fPhotodiode[1]);  // 4-2
+  fTmp2.ClearEventData();
+  fTmp2.Difference(fPhotodiode[2],fPhotodiode[0]);  // 3-1
+  fTmp.ClearEventData();
+  fNumer[0].Sum(fTmp1,fTmp2);
 
   // Y numerator
-  tmp1.ClearEventData();
-  tmp1.Difference(fPhotodiode[3],fPhotodiode[2]);  // 4-3
-  tmp2.ClearEventData();
-  tmp2.Difference(fPhotodiode[1],fPhotodiode[0]);  // 2-1
-  tmp.ClearEventData();
-  numer[1].Sum(tmp1,tmp2);
+  fTmp1.ClearEventData();
+  fTmp1.Difference(fPhotodiode[3],fPhotodiode[2]);  // 4-3
+  fTmp2.ClearEventData();
+  fTmp2.Difference(fPhotodiode[1],fPhotodiode[0]);  // 2-1
+  fTmp.ClearEventData();
+  fNumer[1].Sum(fTmp1,fTmp2);
 
   for(i=kXAxis;i<kNumAxes;i++){
-    tmp.ClearEventData();
-    tmp.Sum(fPhotodiode[0],fPhotodiode[1]);
-    tmp1.ClearEventData();
-    tmp1.Sum(fPhotodiode[2],fPhotodiode[3]);
-    fEffectiveCharge.Sum(tmp,tmp1);
+    fTmp.ClearEventData();
+    fTmp.Sum(fPhotodiode[0],fPhotodiode[1]);
+    fTmp1.ClearEventData();
+    fTmp1.Sum(fPhotodiode[2],fPhotodiode[3]);
+    fEffectiveCharge.Sum(fTmp,fTmp1);
 
     // X/Y reading in ADC counts
-    fRelPos[i].Ratio(numer[i],fEffectiveCharge);
+    fRelPos[i].Ratio(fNumer[i],fEffectiveCharge);
 
     // X/Y reading in mm.
     fAbsPos[i]=fRelPos[i];
     fAbsPos[i].Scale(fQwQPDCalibration[i]);
 
     if(localdebug){
-      std::cout<<" hw  numerator= "<<numer[i].GetValue()<<"  ";
+      std::cout<<" hw  numerator= "<<fNumer[i].GetValue()<<"  ";
       std::cout<<" hw  denominator (== Effective_Charge)= "<<fEffectiveCharge.GetValue()<<"\n";
       std::cout<<" hw  clibration factors= "<<fQwQPDCalibration[i]<<"\n";
       std::cout<<" hw  fRelPos["<<kAxisLabel[i]<<"]="<<fRelPos[i].GetValue()<<"\n \n";
@@ -509,6 +539,32 @@ QwQPD& QwQPD::operator= (const QwQPD &value)
   return *this;
 }
 
+void QwQPD::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.PackEventData(buffer);
+    for(i=0;i<4;i++) fPhotodiode[i].PackEventData(buffer);
+    for(i=kXAxis;i<kNumAxes;i++){
+      fRelPos[i].PackEventData(buffer);
+      fAbsPos[i].PackEventData(buffer);
+    }
+  }
+}
+
+void QwQPD::UnpackEventData(const Double_t*& data)
+{
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.UnpackEventData(data);
+    for(i=0;i<4;i++) fPhotodiode[i].UnpackEventData(data);
+    for(i=kXAxis;i<kNumAxes;i++){
+      fRelPos[i].UnpackEventData(data);
+      fAbsPos[i].UnpackEventData(data);
+    }
+  }
+}
+
 VQwBPM& QwQPD::operator+= (const VQwBPM &value)
 {
   *(dynamic_cast<QwQPD*>(this)) += *(dynamic_cast<const QwQPD*>(&value));
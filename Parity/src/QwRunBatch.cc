@@ -0,0 +1,338 @@
+/**********************************************************\
+* File: QwRunBatch.cc                                      *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#include "QwRunBatch.h"
+
+// System headers
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptions.h"
+#include "QwEventBuffer.h"
+
+//  Set by the signal handler of the event buffer
+extern Bool_t globalEXIT;
+
+namespace {
+  /// Wall time in seconds
+  Double_t GetWallTime() {
+    return std::chrono::duration<Double_t>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+QwRunBatch::QwRunBatch(QwOptions &options)
+: fNumberOfJobs(4),
+  fRetries(1),
+  fMaxIOWait(0.0),
+  fManifest("qwbatch.manifest"),
+  fLogDirectory("."),
+  fCommand("qwparity"),
+  fLastTotal(0),
+  fLastIOWait(0)
+{
+  ProcessOptions(options);
+  SetCommandLine(options);
+}
+
+void QwRunBatch::DefineOptions(QwOptions &options)
+{
+  // Define the execution options
+  options.AddOptions()("batch.jobs",
+      po::value<int>()->default_value(4),
+      "QwRunBatch: number of runs or runlets analyzed at the same time");
+  options.AddOptions()("batch.retries",
+      po::value<int>()->default_value(1),
+      "QwRunBatch: number of times a failed run or runlet is analyzed again");
+  options.AddOptions()("batch.max-iowait",
+      po::value<double>()->default_value(0.0),
+      "QwRunBatch: do not start jobs while more than this percentage of CPU time waits for I/O (0 disables)");
+  options.AddOptions()("batch.manifest",
+      po::value<std::string>()->default_value("qwbatch.manifest"),
+      "QwRunBatch: file listing the jobs of the batch and their status");
+  options.AddOptions()("batch.logdir",
+      po::value<std::string>()->default_value("."),
+      "QwRunBatch: directory of the log files of the jobs");
+  options.AddOptions()("batch.command",
+      po::value<std::string>()->default_value("qwparity"),
+      "QwRunBatch: analysis executable started for each job");
+}
+
+void QwRunBatch::ProcessOptions(QwOptions &options)
+{
+  fNumberOfJobs = options.GetValue<int>("batch.jobs");
+  fRetries      = options.GetValue<int>("batch.retries");
+  fMaxIOWait    = options.GetValue<double>("batch.max-iowait") / 100.0;
+  fManifest     = options.GetValue<std::string>("batch.manifest");
+  fLogDirectory = options.GetValue<std::string>("batch.logdir");
+  fCommand      = options.GetValue<std::string>("batch.command");
+  if (fNumberOfJobs < 1) fNumberOfJobs = 1;
+  if (fRetries < 0) fRetries = 0;
+}
+
+void QwRunBatch::SetCommandLine(QwOptions &options)
+{
+  //  The run, segment and event selection is set for each job, and the
+  //  batch options only apply to the driver
+  static const char* selection[] = { "run", "runlist", "segment", "event" };
+  fArguments.clear();
+  //  The option parser knows which options take a value, so the value is
+  //  passed on or dropped together with its option
+  std::vector<po::option> parsed = options.GetCommandLineOptions();
+  for (size_t i = 0; i < parsed.size(); i++) {
+    const std::string& name = parsed[i].string_key;
+    Bool_t selected = (name.compare(0, 6, "batch.") == 0);
+    for (size_t j = 0; j < sizeof(selection) / sizeof(selection[0]); j++)
+      if (name == selection[j]) selected = kTRUE;
+    if (! selected)
+      fArguments.insert(fArguments.end(), parsed[i].original_tokens.begin(),
+                        parsed[i].original_tokens.end());
+  }
+}
+
+Int_t QwRunBatch::AddJobs(QwEventBuffer &eventbuffer)
+{
+  //  Step through the runs and runlets as the analysis would
+  Int_t added = 0;
+  while (eventbuffer.OpenNextStream() == CODA_OK) {
+    Job_t job;
+    job.fRun        = eventbuffer.GetRunNumber();
+    job.fSegment    = eventbuffer.AreRunletsSplit()? eventbuffer.GetSegmentNumber(): -1;
+    //  Chained segments are analyzed together, in the requested range
+    if (job.fSegment >= 0)
+      job.fSegmentRange = std::make_pair(job.fSegment, job.fSegment);
+    else
+      job.fSegmentRange = eventbuffer.GetSegmentRange();
+    job.fEventRange = eventbuffer.GetEventRange();
+    //  A job is given a single event range; the analysis would move on to
+    //  the next range of the run list within the same run
+    if (eventbuffer.GetNextEventRange()) {
+      QwError << "QwRunBatch: run " << job.fRun << " has several event ranges "
+              << "in the run list, which cannot be analyzed as a batch; "
+              << "list each event range with its own run range" << QwLog::endl;
+      eventbuffer.CloseStream();
+      fJobs.clear();
+      return -1;
+    }
+    job.fStatus     = kJobPending;
+    job.fInterrupted = kFALSE;
+    job.fAttempts   = 0;
+    job.fExitCode   = 0;
+    job.fPid        = -1;
+    job.fStartTime  = 0.0;
+    job.fElapsed    = 0.0;
+    job.fLogFile    = Form("%s/qwbatch_%s.log", fLogDirectory.c_str(),
+                           eventbuffer.GetRunLabel().Data());
+    fJobs.push_back(job);
+    eventbuffer.CloseStream();
+    added++;
+  }
+  QwMessage << "QwRunBatch: " << added << " runs or runlets in the batch"
+            << QwLog::endl;
+  return added;
+}
+
+Int_t QwRunBatch::Run()
+{
+  WriteManifest();
+  GetIOWait();
+
+  size_t next = 0;
+  Int_t running = 0;
+  Bool_t interrupted = kFALSE;
+  while (true) {
+    //  The jobs have their own process groups, so an interrupt only
+    //  reaches the batch; stop the running jobs, which are not done
+    if (globalEXIT && ! interrupted) {
+      interrupted = kTRUE;
+      for (size_t i = 0; i < fJobs.size(); i++) {
+        if (fJobs[i].fStatus == kJobRunning) {
+          fJobs[i].fInterrupted = kTRUE;
+          kill(fJobs[i].fPid, SIGTERM);
+        }
+      }
+    }
+
+    //  Start pending jobs while there are free workers, unless the disks
+    //  are already busy (but never leave all workers idle)
+    while (! globalEXIT && running < fNumberOfJobs) {
+      while (next < fJobs.size() && fJobs[next].fStatus != kJobPending) next++;
+      if (next == fJobs.size()) break;
+      if (running > 0 && fMaxIOWait > 0.0 && GetIOWait() > fMaxIOWait) break;
+      if (Start(fJobs[next])) running++;
+    }
+    if (running == 0) break;
+
+    //  Wait for a job to finish, checking the I/O load now and then
+    Int_t status = 0;
+    pid_t pid = waitpid(-1, &status, WNOHANG);
+    if (pid == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      continue;
+    }
+    if (pid < 0) break;
+    for (size_t i = 0; i < fJobs.size(); i++) {
+      if (fJobs[i].fStatus == kJobRunning && fJobs[i].fPid == pid) {
+        Finished(fJobs[i], status);
+        running--;
+        //  Retries go back in the queue
+        if (fJobs[i].fStatus == kJobPending && i < next) next = i;
+        break;
+      }
+    }
+    WriteManifest();
+  }
+
+  Int_t failed = 0, pending = 0;
+  for (size_t i = 0; i < fJobs.size(); i++) {
+    if (fJobs[i].fStatus == kJobFailed) failed++;
+    if (fJobs[i].fStatus == kJobPending) pending++;
+  }
+  if (pending > 0)
+    QwWarning << "QwRunBatch: batch interrupted, " << pending
+              << " jobs were not analyzed" << QwLog::endl;
+  QwMessage << "QwRunBatch: " << fJobs.size() - failed - pending << " of "
+            << fJobs.size() << " jobs done, " << failed << " failed; see "
+            << fManifest << QwLog::endl;
+  WriteManifest();
+  return failed + pending;
+}
+
+Bool_t QwRunBatch::Start(Job_t& job)
+{
+  //  Command line of the job
+  std::vector<std::string> args;
+  args.push_back(fCommand);
+  args.insert(args.end(), fArguments.begin(), fArguments.end());
+  args.push_back("--run");
+  args.push_back(Form("%d", job.fRun));
+  args.push_back("--segment");
+  args.push_back(Form("%d:%d", job.fSegmentRange.first, job.fSegmentRange.second));
+  args.push_back("--event");
+  args.push_back(Form("%u:%u", job.fEventRange.first, job.fEventRange.second));
+
+  std::vector<char*> argv;
+  for (size_t i = 0; i < args.size(); i++)
+    argv.push_back(const_cast<char*>(args[i].c_str()));
+  argv.push_back(0);
+
+  job.fAttempts++;
+  job.fStartTime = GetWallTime();
+  QwMessage << "QwRunBatch: starting run " << job.fRun;
+  if (job.fSegment >= 0) QwMessage << " segment " << job.fSegment;
+  QwMessage << " (attempt " << job.fAttempts << "), log in "
+            << job.fLogFile << QwLog::endl;
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    //  Child: leave the process group of the batch, so that an interrupt
+    //  of the batch is handled by the batch, then send the output to the
+    //  log file and start the analysis
+    setpgid(0, 0);
+    Int_t fd = open(job.fLogFile.Data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    execvp(argv[0], &argv[0]);
+    _exit(127);
+  }
+  if (pid < 0) {
+    QwError << "QwRunBatch: could not start a job for run " << job.fRun
+            << QwLog::endl;
+    job.fStatus = kJobFailed;
+    job.fExitCode = -1;
+    return kFALSE;
+  }
+  job.fPid = pid;
+  job.fStatus = kJobRunning;
+  return kTRUE;
+}
+
+void QwRunBatch::Finished(Job_t& job, Int_t status)
+{
+  job.fPid = -1;
+  job.fElapsed = GetWallTime() - job.fStartTime;
+  if (WIFEXITED(status)) job.fExitCode = WEXITSTATUS(status);
+  else if (WIFSIGNALED(status)) job.fExitCode = 128 + WTERMSIG(status);
+  else job.fExitCode = -1;
+
+  //  A job stopped by an interrupt may still exit normally, with its
+  //  output incomplete
+  if (job.fInterrupted) {
+    QwWarning << "QwRunBatch: run " << job.fRun;
+    if (job.fSegment >= 0) QwWarning << " segment " << job.fSegment;
+    QwWarning << " was interrupted" << QwLog::endl;
+    job.fInterrupted = kFALSE;
+    job.fStatus = kJobPending;
+    return;
+  }
+  if (job.fExitCode == 0) {
+    job.fStatus = kJobDone;
+    return;
+  }
+  if (job.fAttempts <= fRetries && ! globalEXIT) {
+    QwWarning << "QwRunBatch: run " << job.fRun;
+    if (job.fSegment >= 0) QwWarning << " segment " << job.fSegment;
+    QwWarning << " failed with exit code " << job.fExitCode
+              << ", retrying" << QwLog::endl;
+    job.fStatus = kJobPending;
+    return;
+  }
+  QwError << "QwRunBatch: run " << job.fRun;
+  if (job.fSegment >= 0) QwError << " segment " << job.fSegment;
+  QwError << " failed with exit code " << job.fExitCode << " after "
+          << job.fAttempts << " attempts, see " << job.fLogFile << QwLog::endl;
+  job.fStatus = kJobFailed;
+}
+
+Double_t QwRunBatch::GetIOWait()
+{
+  //  First line of /proc/stat: cpu user nice system idle iowait irq softirq steal
+  std::ifstream stat("/proc/stat");
+  std::string cpu;
+  ULong64_t user = 0, nice = 0, system = 0, idle = 0, iowait = 0;
+  ULong64_t irq = 0, softirq = 0, steal = 0;
+  if (! (stat >> cpu >> user >> nice >> system >> idle >> iowait
+              >> irq >> softirq >> steal))
+    return 0.0;
+
+  ULong64_t total = user + nice + system + idle + iowait + irq + softirq + steal;
+  ULong64_t dtotal = total - fLastTotal;
+  ULong64_t diowait = iowait - fLastIOWait;
+  fLastTotal = total;
+  fLastIOWait = iowait;
+  return (dtotal > 0)? Double_t(diowait) / dtotal: 0.0;
+}
+
+void QwRunBatch::WriteManifest() const
+{
+  static const char* status[] = { "pending", "running", "done", "failed" };
+  std::ofstream manifest(fManifest.c_str());
+  if (! manifest.is_open()) {
+    QwWarning << "QwRunBatch: could not write the manifest " << fManifest
+              << QwLog::endl;
+    return;
+  }
+  manifest << "# run\tsegment\tevents\tstatus\tattempts\texit\telapsed[s]\tlog" << std::endl;
+  for (size_t i = 0; i < fJobs.size(); i++) {
+    const Job_t& job = fJobs[i];
+    manifest << job.fRun << "\t" << job.fSegment << "\t"
+             << job.fEventRange.first << ":" << job.fEventRange.second << "\t"
+             << status[job.fStatus] << "\t" << job.fAttempts << "\t"
+             << job.fExitCode << "\t" << Form("%.1f", job.fElapsed) << "\t"
+             << job.fLogFile << std::endl;
+  }
+}
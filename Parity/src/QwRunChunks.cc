@@ -0,0 +1,210 @@
+/**********************************************************\
+* File: QwRunChunks.cc                                     *
+*                                                          *
+* Author:                                                  *
+* Time-stamp:                                              *
+\**********************************************************/
+
+#include "QwRunChunks.h"
+
+// System headers
+#include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwOptions.h"
+#include "QwEventBuffer.h"
+
+QwRunChunks::QwRunChunks(QwOptions &options)
+: fEventsPerChunk(0),
+  fJobs(1),
+  fWarmup(10000),
+  fChunk(kSerial),
+  fFirstEvent(0),
+  fLastEvent(0),
+  fLastRead(0),
+  fPipe(-1)
+{
+  ProcessOptions(options);
+}
+
+void QwRunChunks::DefineOptions(QwOptions &options)
+{
+  // Define the execution options
+  options.AddOptions()("chunk.events",
+      po::value<int>()->default_value(0),
+      "QwRunChunks: split each run in chunks of this many events, analyzed by child processes (0 disables)");
+  options.AddOptions()("chunk.jobs",
+      po::value<int>()->default_value(2),
+      "QwRunChunks: number of chunks analyzed at the same time");
+  options.AddOptions()("chunk.warmup",
+      po::value<int>()->default_value(10000),
+      "QwRunChunks: number of events read before a chunk to fill the event ring and synchronize the helicity");
+}
+
+void QwRunChunks::ProcessOptions(QwOptions &options)
+{
+  fEventsPerChunk = options.GetValue<int>("chunk.events");
+  fJobs = options.GetValue<int>("chunk.jobs");
+  fWarmup = options.GetValue<int>("chunk.warmup");
+  if (fEventsPerChunk < 0) fEventsPerChunk = 0;
+  if (fJobs < 1) fJobs = 1;
+  if (fWarmup < 0) fWarmup = 0;
+}
+
+TString QwRunChunks::GetLabel() const
+{
+  if (! IsChild()) return "";
+  return Form(".chunk%03d", fChunk);
+}
+
+void QwRunChunks::Fork(QwEventBuffer &eventbuffer, const Merge_t& merge)
+{
+  if (! IsEnabled()) return;
+  if (eventbuffer.IsOnline()) {
+    QwWarning << "QwRunChunks: online data cannot be split in chunks, "
+              << "analyzing the run in a single process." << QwLog::endl;
+    fEventsPerChunk = 0;
+    return;
+  }
+
+  //  The chunks start at the first physics event of the requested range
+  std::pair<UInt_t, UInt_t> range = eventbuffer.GetEventRange();
+  UInt_t first = range.first;
+  while (eventbuffer.GetNextEvent() == CODA_OK) {
+    if (eventbuffer.IsPhysicsEvent()) {
+      first = eventbuffer.GetEventNumber();
+      break;
+    }
+  }
+  //  Each child opens the stream itself, since an open file would
+  //  share its offset (and the read-ahead thread would not survive)
+  eventbuffer.CloseDataFile();
+
+  fChunk = kParent;
+  std::vector<Child_t> running;
+  Int_t next = 0;
+  Int_t merged = 0;
+  Bool_t done = kFALSE;
+  while (! done || ! running.empty()) {
+
+    //  Launch chunks while there are free jobs
+    while (! done && running.size() < (size_t) fJobs) {
+      UInt_t start = first + UInt_t(next) * fEventsPerChunk;
+      if (start > range.second || start < first) {
+        done = kTRUE;
+        break;
+      }
+      Int_t fd[2];
+      if (pipe(fd) != 0) {
+        QwError << "QwRunChunks: could not create a pipe for chunk "
+                << next << QwLog::endl;
+        done = kTRUE;
+        break;
+      }
+      //  The message also flushes the output, which the child would repeat
+      QwMessage << "QwRunChunks: analyzing events " << start << " to "
+                << std::min(start + fEventsPerChunk - 1, range.second)
+                << " in chunk " << next << QwLog::endl;
+      pid_t pid = fork();
+      if (pid == 0) {
+        //  Child: analyze this chunk, with the warm-up before it
+        close(fd[0]);
+        for (size_t i = 0; i < running.size(); i++)
+          close(running[i].fPipe);
+        fChunk = next;
+        fPipe = fd[1];
+        fFirstEvent = start;
+        fLastEvent = std::min(start + fEventsPerChunk - 1, range.second);
+        UInt_t warmup = (start - first > (UInt_t) fWarmup)? start - fWarmup: first;
+        fLastRead = std::min(fLastEvent + fWarmup, range.second);
+        if (fLastRead < fLastEvent) fLastRead = range.second;
+        eventbuffer.SetEventRange(warmup, fLastRead);
+        eventbuffer.ReOpenStream();
+        return;
+      }
+      close(fd[1]);
+      if (pid < 0) {
+        QwError << "QwRunChunks: could not fork chunk " << next << QwLog::endl;
+        close(fd[0]);
+        done = kTRUE;
+        break;
+      }
+      Child_t child;
+      child.fChunk = next;
+      child.fPid = pid;
+      child.fPipe = fd[0];
+      running.push_back(child);
+      next++;
+    }
+    if (running.empty()) break;
+
+    //  Merge the oldest chunk, so that the chunks are merged in order
+    Child_t child = running.front();
+    running.erase(running.begin());
+    std::vector<Double_t> result;
+    if (! Collect(child, result)) {
+      QwError << "QwRunChunks: chunk " << child.fChunk << " failed, "
+              << "the results of the run are incomplete!" << QwLog::endl;
+      done = kTRUE;
+      continue;
+    }
+    const Double_t* data = &result[0];
+    Bool_t end_of_data = (*data++ != 0);
+    merge(data);
+    merged++;
+    if (end_of_data) done = kTRUE;
+  }
+  QwMessage << "QwRunChunks: merged " << merged << " chunks of "
+            << fEventsPerChunk << " events" << QwLog::endl;
+  QwWarning << "QwRunChunks: the burst sums, EPICS values, running regression "
+            << "and error counters are only in the output of each chunk"
+            << QwLog::endl;
+}
+
+void QwRunChunks::Finish(QwEventBuffer &eventbuffer, const Pack_t& pack)
+{
+  if (! IsChild()) return;
+
+  //  The data ended inside the events read by this chunk
+  std::vector<Double_t> result;
+  result.push_back(UInt_t(eventbuffer.GetEventNumber()) <= fLastRead);
+  pack(result);
+
+  const char* buffer = reinterpret_cast<const char*>(&result[0]);
+  size_t size = result.size() * sizeof(Double_t);
+  while (size > 0) {
+    ssize_t n = write(fPipe, buffer, size);
+    if (n <= 0) {
+      QwError << "QwRunChunks: could not send the result of chunk "
+              << fChunk << QwLog::endl;
+      _exit(EXIT_FAILURE);
+    }
+    buffer += n;
+    size -= n;
+  }
+  close(fPipe);
+  QwMessage << "QwRunChunks: chunk " << fChunk << " done" << QwLog::endl;
+  _exit(EXIT_SUCCESS);
+}
+
+Bool_t QwRunChunks::Collect(const Child_t& child, std::vector<Double_t>& result) const
+{
+  std::vector<char> buffer;
+  char block[65536];
+  ssize_t n;
+  while ((n = read(child.fPipe, block, sizeof(block))) > 0)
+    buffer.insert(buffer.end(), block, block + n);
+  close(child.fPipe);
+
+  Int_t status = 0;
+  waitpid(child.fPid, &status, 0);
+  if (! WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) return kFALSE;
+  if (buffer.size() < sizeof(Double_t) || buffer.size() % sizeof(Double_t) != 0) return kFALSE;
+
+  result.resize(buffer.size() / sizeof(Double_t));
+  std::copy(buffer.begin(), buffer.end(), reinterpret_cast<char*>(&result[0]));
+  return kTRUE;
+}
@@ -12,6 +12,8 @@
 
 // Qweak headers
 #include "VQwSubsystemParity.h"
+#include "VQwHardwareChannel.h"
+#include "QwProfiler.h"
 
 //*****************************************************************//
 
@@ -476,6 +478,7 @@ void QwSubsystemArrayParity::Ratio(
 }
 
 Bool_t QwSubsystemArrayParity::ApplySingleEventCuts(){
+  QwProfiler::Scope profile(QwProfiler::kEventCuts);
   Int_t CountFalse;
   Bool_t status;
   UInt_t ErrorFlag;
@@ -525,6 +528,81 @@ void QwSubsystemArrayParity::IncrementErrorCounters()
 }
 
 
+void QwSubsystemArrayParity::MergeErrorCounters(const QwSubsystemArrayParity& source)
+{
+  if (!source.empty() && this->size() == source.size()){
+    for(size_t i=0;i<source.size();i++){
+      if (source.at(i)==NULL || this->at(i)==NULL){
+	//  Either the source or the destination subsystem
+	//  are null
+      } else {
+	VQwSubsystemParity *ptr1 =
+	  dynamic_cast<VQwSubsystemParity*>(this->at(i).get());
+	if (typeid(*ptr1)==typeid(*(source.at(i).get()))){
+	  ptr1->MergeErrorCounters(source.at(i).get());
+	} else {
+	  //  Subsystems don't match
+	  QwError << " QwSubsystemArrayParity::MergeErrorCounters types do not match" << QwLog::endl;
+	}
+      }
+    }
+  }
+}
+
+//*****************************************************************//
+
+/**
+ * Append the event data to a compact buffer, in the same way as the
+ * assignment operator copies it.  Subsystems which do not support
+ * packing are skipped and have to be copied separately.
+ * @param buffer Buffer to append to
+ */
+void QwSubsystemArrayParity::PackEventData(std::vector<Double_t>& buffer) const
+{
+  buffer.push_back(fErrorFlag);
+  buffer.push_back(fCodaEventNumber);
+  for (const_iterator subsys = begin(); subsys != end(); ++subsys) {
+    VQwSubsystemParity* subsys_parity = dynamic_cast<VQwSubsystemParity*>(subsys->get());
+    if (subsys_parity != 0) subsys_parity->PackEventData(buffer);
+  }
+}
+
+/**
+ * Restore the event data written by PackEventData
+ * @param data Pointer to the packed data, advanced past the data read
+ */
+void QwSubsystemArrayParity::UnpackEventData(const Double_t*& data)
+{
+  fErrorFlag = UInt_t(*data++);
+  fCodaEventNumber = UInt_t(*data++);
+  for (iterator subsys = begin(); subsys != end(); ++subsys) {
+    VQwSubsystemParity* subsys_parity = dynamic_cast<VQwSubsystemParity*>(subsys->get());
+    if (subsys_parity != 0) subsys_parity->UnpackEventData(data);
+  }
+}
+
+/**
+ * Merge the running sum of another part of the run, written by
+ * PackEventData, into this running sum.  Only the subsystems which
+ * support packing are merged.
+ * @param data Pointer to the packed running sum, advanced past the data read
+ */
+void QwSubsystemArrayParity::MergeRunningSum(const Double_t*& data)
+{
+  QwSubsystemArrayParity part(*this);
+  part.UnpackEventData(data);
+  //  The channels add the part as a set of its good events
+  VQwHardwareChannel::MergeScope merging;
+  std::vector<Double_t> probe;
+  for (size_t i = 0; i < size(); i++) {
+    VQwSubsystemParity* subsys_parity = dynamic_cast<VQwSubsystemParity*>(at(i).get());
+    probe.clear();
+    if (subsys_parity != 0 && subsys_parity->PackEventData(probe))
+      subsys_parity->AccumulateRunningSum(part.at(i).get());
+  }
+}
+
+
 void QwSubsystemArrayParity::PrintErrorCounters() const{// report number of events failed due to HW and event cut faliure
   const VQwSubsystemParity *subsys_parity;
   if (!empty()){
@@ -70,6 +70,17 @@ QwkRegBlueCorrelator::addEvent(double *Pvec, double *Yvec){
 }
 
 
+//========================
+//========================
+void
+QwkRegBlueCorrelator::mergeAccumulators(const double* &data){
+  // accumulators of another part of the data, written by packAccumulators()
+  LinRegBevPeb part;
+  part.unpack(data);
+  linReg.merge(part);
+}
+
+
 //========================
 //========================
 void QwkRegBlueCorrelator::init(std::vector < TString > ivName, std::vector < TString > dvName) {
@@ -133,6 +133,40 @@ VQwBPM& VQwBPM::operator= (const VQwBPM &value)
   return *this;
 }
 
+void VQwBPM::PackEventData(std::vector<Double_t>& buffer) const
+{
+  if (GetElementName()!=""){
+    buffer.push_back(fQwStriplineCalibration);
+    buffer.push_back(bRotated);
+    buffer.push_back(fRotationAngle);
+    buffer.push_back(fCosRotation);
+    buffer.push_back(fSinRotation);
+    buffer.push_back(fGoodEvent);
+    for(size_t axis=kXAxis;axis<kNumAxes;axis++){
+      buffer.push_back(fRelativeGains[axis]);
+      buffer.push_back(fPositionCenter[axis]);
+    }
+    buffer.push_back(fPositionCenter[2]);
+  }
+}
+
+void VQwBPM::UnpackEventData(const Double_t*& data)
+{
+  if (GetElementName()!=""){
+    fQwStriplineCalibration = *data++;
+    bRotated = (*data++ != 0);
+    fRotationAngle = *data++;
+    fCosRotation = *data++;
+    fSinRotation = *data++;
+    fGoodEvent = (*data++ != 0);
+    for(size_t axis=kXAxis;axis<kNumAxes;axis++){
+      fRelativeGains[axis] = *data++;
+      fPositionCenter[axis] = *data++;
+    }
+    fPositionCenter[2] = *data++;
+  }
+}
+
 // VQwBPM& VQwBPM::operator+= (const VQwBPM &value)
 // {
 //   if (GetElementName()!=""){
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Test 005:
+#
+#   Run the mock data generator with its fixed seeds and analyze the run with
+#   qwparity, recording the events per second, the peak resident memory and
+#   the size of the ROOT output.  The test fails when any of these is worse
+#   than the baseline by more than the threshold (QW_THROUGHPUT_THRESHOLD, in
+#   percent, default 20).
+#
+#   The baseline depends on the machine, so it is not part of the repository:
+#   it is kept in build/005_throughput.ref (or QW_THROUGHPUT_BASELINE), and
+#   only written when QW_UPDATE_BASELINE=1.  Without a baseline nothing is
+#   enforced, so the measurement is reported and the test exits with 77,
+#   which run_tests.sh reports as skipped rather than successful.
+#
+
+setupscript=SetupFiles/SET_ME_UP.bash
+baseline=${QW_THROUGHPUT_BASELINE:-build/005_throughput.ref}
+threshold=${QW_THROUGHPUT_THRESHOLD:-20}
+run=11
+events=50000
+stem=qwthroughput_
+
+if [ ! -e ${setupscript} ] ; then
+  echo "Setup script ${setupscript} could not be found."
+  exit -1
+fi
+
+source ${setupscript} || exit -1
+
+if [ ! -x /usr/bin/time ] ; then
+  echo "/usr/bin/time is needed to measure the time and memory of the analysis."
+  exit -1
+fi
+
+build/qwmockdatagenerator -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map > /dev/null || exit -1
+
+rm -f ${QW_ROOTFILES}/${stem}${run}*.root
+LOG=`mktemp -t qwthroughput.XXXXXX.log`
+TIME=`mktemp -t qwthroughput.XXXXXX.time`
+/usr/bin/time -f "%e %M" -o ${TIME} \
+  build/qwparity -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map \
+  --rootfile-stem ${stem} > ${LOG} 2>&1 || { tail -n 20 ${LOG} ; exit -1 ; }
+
+# Events per second over the wall time of the analysis
+processed=`grep "Number of events processed at end of run" ${LOG} | tail -n 1 | awk '{print $NF}'`
+read elapsed rss < ${TIME}
+rate=`awk -v n=${processed:-0} -v t=${elapsed} 'BEGIN { printf "%.1f", (t > 0)? n / t: 0 }'`
+# Size of the ROOT output in bytes, and peak resident memory in kB
+size=`cat ${QW_ROOTFILES}/${stem}${run}*.root | wc -c`
+
+echo "events/s: ${rate}  peak RSS: ${rss} kB  output: ${size} bytes"
+
+if [ "${QW_UPDATE_BASELINE}" == "1" ] ; then
+  echo "${rate} ${rss} ${size}" > ${baseline} || exit -1
+  echo "Baseline written to ${baseline}."
+  exit 0
+fi
+
+if [ ! -e ${baseline} ] ; then
+  echo "SKIP: no baseline ${baseline}; nothing was compared."
+  echo "Record one on this machine with QW_UPDATE_BASELINE=1."
+  exit 77
+fi
+
+read base_rate base_rss base_size < ${baseline}
+echo "baseline events/s: ${base_rate}  peak RSS: ${base_rss} kB  output: ${base_size} bytes"
+
+# Fewer events per second, or more memory or output, beyond the threshold
+awk -v r=${rate} -v br=${base_rate} -v m=${rss} -v bm=${base_rss} \
+    -v s=${size} -v bs=${base_size} -v x=${threshold} 'BEGIN {
+  status = 0
+  if (r < br * (1 - x / 100)) { print "Throughput regressed beyond " x "%";  status = 1 }
+  if (m > bm * (1 + x / 100)) { print "Peak RSS regressed beyond " x "%";    status = 1 }
+  if (s > bs * (1 + x / 100)) { print "Output size regressed beyond " x "%"; status = 1 }
+  exit status
+}' || exit -1
+
+exit 0
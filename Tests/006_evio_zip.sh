@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# Test 006:
+#
+#   Run the mock data generator, compress the data file with each of gzip,
+#   zstd and lz4 found on the path, and make sure the analysis of every
+#   compressed file gives the same output as the analysis of the original.
+#   The data file has to be larger than the input buffer of the in-process
+#   decompression (EVZ_BUFSIZE), so that the decoders are refilled and
+#   drained at the end of the file.
+#
+
+setupscript=SetupFiles/SET_ME_UP.bash
+run=12
+events=20000
+bufsize=1048576
+
+if [ ! -e ${setupscript} ] ; then
+  echo "Setup script ${setupscript} could not be found."
+  exit -1
+fi
+
+source ${setupscript} || exit -1
+
+build/qwmockdatagenerator -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map > /dev/null || exit -1
+
+datafile=${QW_DATA}/QwMock_${run}.log
+if [ ! -e ${datafile} ] ; then
+  echo "Data file ${datafile} could not be found."
+  exit -1
+fi
+if [ `cat ${datafile} | wc -c` -le ${bufsize} ] ; then
+  echo "Data file ${datafile} is not larger than the decompression buffer."
+  exit -1
+fi
+
+# Analysis output without the lines that depend on the data file or the time
+analyze() {
+  build/qwparity_simple -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map \
+    | grep -i -v time | grep -v `hostname` | grep -v "Processing event" | grep -v "Opening data file"
+}
+
+REF=`mktemp -t qwevio_zip.XXXXXX.out`
+analyze > ${REF} || exit -1
+
+original=`mktemp -t qwevio_zip.XXXXXX.log`
+mv ${datafile} ${original} || exit -1
+status=0
+for format in "gzip .gz" "zstd .zst" "lz4 .lz4" ; do
+  set -- ${format}
+  if ! which $1 > /dev/null 2>&1 ; then
+    echo "$1 not found; skipping $2 files."
+    continue
+  fi
+  $1 -c < ${original} > ${datafile}$2 || { status=-1 ; break ; }
+  OUT=`mktemp -t qwevio_zip.XXXXXX.out`
+  analyze > ${OUT}
+  rm -f ${datafile}$2
+  if ! diff ${REF} ${OUT} ; then
+    echo "Analysis of the $2 data file differs from the original."
+    status=-1
+  fi
+done
+mv ${original} ${datafile}
+
+exit ${status}
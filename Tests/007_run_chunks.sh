@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Test 007:
+#
+#   Run the mock data generator and analyze the run with qwparity, once in a
+#   single process and once split in chunks (--chunk.events), and make sure
+#   the running averages of the events merged from the chunks are the same as
+#   those of the single process.  The numbers may only differ by the rounding
+#   of the merge (QW_CHUNKS_TOLERANCE, relative, default 1e-6).
+#
+
+setupscript=SetupFiles/SET_ME_UP.bash
+tolerance=${QW_CHUNKS_TOLERANCE:-1e-6}
+run=13
+events=20000
+chunk=5000
+
+if [ ! -e ${setupscript} ] ; then
+  echo "Setup script ${setupscript} could not be found."
+  exit -1
+fi
+
+source ${setupscript} || exit -1
+
+build/qwmockdatagenerator -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map > /dev/null || exit -1
+
+# Running averages of the events, printed at the end of the run
+runningsum() {
+  build/qwparity -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map \
+    --rootfile-stem qwchunks_ --print-runningsum "$@" \
+    | sed -n '/Running average of events/,$p' | grep -e "+/-"
+}
+
+SERIAL=`mktemp -t qwchunks.XXXXXX.out`
+CHUNKS=`mktemp -t qwchunks.XXXXXX.out`
+runningsum > ${SERIAL} || exit -1
+runningsum --chunk.events ${chunk} --chunk.jobs 2 > ${CHUNKS} || exit -1
+rm -f ${QW_ROOTFILES}/qwchunks_${run}*.root
+
+if [ ! -s ${SERIAL} ] ; then
+  echo "No running averages in the output of qwparity."
+  exit -1
+fi
+
+# Same words, and numbers within the tolerance
+awk -v x=${tolerance} '
+  NR == FNR { serial[FNR] = $0; nserial = FNR; next }
+  {
+    if (! (FNR in serial)) { print "Extra line: " $0; status = 1; next }
+    n = split(serial[FNR], a); m = split($0, b)
+    if (n != m) { print "< " serial[FNR]; print "> " $0; status = 1; next }
+    for (i = 1; i <= n; i++) {
+      if (a[i] == b[i]) continue
+      if (a[i] ~ /^[-+0-9.eE]+$/ && b[i] ~ /^[-+0-9.eE]+$/) {
+        d = a[i] - b[i]; d = (d < 0)? -d: d
+        s = (a[i] < 0)? -a[i]: a[i]
+        if (d <= x * s || d <= x) continue
+      }
+      print "< " serial[FNR]; print "> " $0; status = 1; break
+    }
+  }
+  END {
+    if (FNR < nserial) { print "Missing lines after " FNR; status = 1 }
+    exit status
+  }' ${SERIAL} ${CHUNKS} || exit -1
+
+exit 0
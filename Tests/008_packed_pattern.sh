@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Test 008:
+#
+#   Run the mock data generator and analyze the run with qwparity, once with
+#   copies of the events of each helicity pattern and once with packed events
+#   (--enable-packed-pattern), and make sure the running averages of the
+#   pattern and pair yields, differences and asymmetries are the same.  The
+#   numbers may only differ by rounding (QW_PACKED_TOLERANCE, relative,
+#   default 1e-9).
+#
+
+setupscript=SetupFiles/SET_ME_UP.bash
+tolerance=${QW_PACKED_TOLERANCE:-1e-9}
+run=13
+events=20000
+
+if [ ! -e ${setupscript} ] ; then
+  echo "Setup script ${setupscript} could not be found."
+  exit -1
+fi
+
+source ${setupscript} || exit -1
+
+build/qwmockdatagenerator -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map > /dev/null || exit -1
+
+# Running averages of the patterns and pairs, printed at the end of the run
+runningsum() {
+  build/qwparity -r ${run} -e :${events} --config qwparity_simple.conf --detectors mock_detectors.map \
+    --rootfile-stem qwpacked_ --print-runningsum --enable-differences "$@" \
+    | sed -n '/Running average of pattern yields/,/Running average of events/p' | grep -e "+/-"
+}
+
+ARRAYS=`mktemp -t qwpacked.XXXXXX.out`
+PACKED=`mktemp -t qwpacked.XXXXXX.out`
+runningsum > ${ARRAYS} || exit -1
+runningsum --enable-packed-pattern > ${PACKED} || exit -1
+rm -f ${QW_ROOTFILES}/qwpacked_${run}*.root
+
+if [ ! -s ${ARRAYS} ] ; then
+  echo "No running averages in the output of qwparity."
+  exit -1
+fi
+
+# Same words, and numbers within the tolerance
+awk -v x=${tolerance} '
+  NR == FNR { arrays[FNR] = $0; narrays = FNR; next }
+  {
+    if (! (FNR in arrays)) { print "Extra line: " $0; status = 1; next }
+    n = split(arrays[FNR], a); m = split($0, b)
+    if (n != m) { print "< " arrays[FNR]; print "> " $0; status = 1; next }
+    for (i = 1; i <= n; i++) {
+      if (a[i] == b[i]) continue
+      if (a[i] ~ /^[-+0-9.eE]+$/ && b[i] ~ /^[-+0-9.eE]+$/) {
+        d = a[i] - b[i]; d = (d < 0)? -d: d
+        s = (a[i] < 0)? -a[i]: a[i]
+        if (d <= x * s || d <= x) continue
+      }
+      print "< " arrays[FNR]; print "> " $0; status = 1; break
+    }
+  }
+  END {
+    if (FNR < narrays) { print "Missing lines after " FNR; status = 1 }
+    exit status
+  }' ${ARRAYS} ${PACKED} || exit -1
+
+exit 0
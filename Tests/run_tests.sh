@@ -5,11 +5,13 @@
 #    Executable scripts in the test directory with format [0-9][0-9][0-9]_*.sh
 #    are executed.  Success is indicated by a zero return value, failure by a
 #    non-zero return value.  Regression tests should explicitly return a value
-#    with 'exit [n]'.
+#    with 'exit [n]'.  A return value of 77 indicates that the test could not
+#    check anything on this machine; it is reported as skipped.
 #
 
 testdir="Tests"
 tests=`ls ${testdir}/[0-9][0-9][0-9]_*.sh`
+skipped=0
 
 # Loop over all tests
 for test in ${tests} ; do
@@ -22,8 +24,13 @@ for test in ${tests} ; do
   fi
 
   echo "Running $test..."
-  if $test ; then
+  $test
+  status=$?
+  if [ $status -eq 0 ] ; then
     echo "$test succeeded."
+  elif [ $status -eq 77 ] ; then
+    echo "$test skipped."
+    skipped=$((skipped + 1))
   else
     echo "$test failed."
     exit -1
@@ -31,4 +38,8 @@ for test in ${tests} ; do
 
 done
 
-echo "All regression tests were successful."
+if [ $skipped -gt 0 ] ; then
+  echo "All regression tests were successful ($skipped skipped)."
+else
+  echo "All regression tests were successful."
+fi
@@ -41,6 +41,9 @@ public:
   int codaRead();
   int codaWrite(int* evbuffer);
   int *getEvBuffer();
+  void setMemoryMapped(int flag) { fMapped = flag; };  // use mmap on next open
+  int  isMemoryMapped() const { return fMapped; };
+  int  isEvBufferMapped() const { return fEvPtr != evbuffer; };  // getEvBuffer() valid until codaClose
   int filterToFile(TString output_file);     // filter to an output file
   void addEvTypeFilt(int evtype_to_filt);    // add an event type to list
   void addEvListFilt(int event_to_filt);     // add an event num to list
@@ -56,6 +59,8 @@ private:
   int ffirst;
   int max_to_filt;
   EVFILE *handle;
+  int fMapped;         // read through a memory mapping of the file
+  int *fEvPtr;         // current event, either evbuffer or inside the mapping
   int maxflist,maxftype;
   TArrayI evlist, evtypes;
 
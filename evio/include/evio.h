@@ -47,6 +47,10 @@ typedef struct evfilestruct {
   int magic;
   int evnum;         /* last events with evnum so far */
   int byte_swapped;
+  char *map;         /* memory mapped file, or NULL when reading via FILE */
+  size_t mapsize;    /* size of the mapping in bytes */
+  size_t mappos;     /* byte offset of the next block in the mapping */
+  struct evzfilestruct *zfile; /* in-process decompressor, or NULL */
 } EVFILE;
 
 typedef struct evBinarySearch{
@@ -59,6 +63,7 @@ typedef struct evBinarySearch{
 
 extern int evOpen(char *filename, char *flags, EVFILE **handle);
 extern int evRead(EVFILE *handle, int *buffer, int buflen);
+extern int evReadPtr(EVFILE *handle, int *buffer, int buflen, int **event);
 extern int evGetNewBuffer(EVFILE *a);
 extern int evWrite(EVFILE *handle,int *buffer);
 extern int evFlush(EVFILE *a);
@@ -0,0 +1,38 @@
+#ifndef EVIO_ZIP_H
+#define EVIO_ZIP_H
+
+/////////////////////////////////////////////////////////////////////
+//
+//  evio_zip
+//  In-process decompression of compressed CODA files
+//
+//  Streaming readers for gzip (zlib), and optionally zstd and LZ4
+//  frame files, used by evOpen in place of a "gunzip<" pipe.  The
+//  zstd and LZ4 readers are only compiled in when the libraries are
+//  found (__EVIO_ZSTD and __EVIO_LZ4).
+//
+/////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+
+#define EVZ_NONE     0      /* not compressed */
+#define EVZ_GZIP     1      /* gzip (1f 8b) */
+#define EVZ_COMPRESS 2      /* unix compress (1f 9d), pipe only */
+#define EVZ_ZSTD     3      /* zstd frame (28 b5 2f fd) */
+#define EVZ_LZ4      4      /* LZ4 frame (04 22 4d 18) */
+
+#define EVZ_MAGICSIZE 4     /* bytes needed by evzFormat */
+#define EVZ_BUFSIZE (1<<20) /* size of compressed input reads */
+
+typedef struct evzfilestruct EVZFILE;
+
+extern int      evzFormat(const unsigned char *magic, int nbytes);
+extern int      evzSupported(int format);
+extern const char *evzPipeCommand(int format);
+extern EVZFILE *evzOpen(FILE *file, int format);
+extern size_t   evzRead(EVZFILE *z, void *buffer, size_t size, size_t num);
+extern int      evzEof(EVZFILE *z);
+extern int      evzError(EVZFILE *z);
+extern int      evzClose(EVZFILE *z);
+
+#endif